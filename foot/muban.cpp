@@ -30,32 +30,6 @@
 #include "my_utils/communication.h"
 #include "my_utils/tactics.h"
 
-// 比赛状态常量定义（如果在其他文件中已定义，可以注释掉）
-#ifndef PM_NORMAL
-#define PM_NORMAL 99
-#endif
-#ifndef PM_STOP
-#define PM_STOP 0
-#endif
-#ifndef PM_OurKickOff
-#define PM_OurKickOff 1
-#endif
-#ifndef PM_OppKickOff
-#define PM_OppKickOff 2
-#endif
-#ifndef PM_OurFreeKick
-#define PM_OurFreeKick 9
-#endif
-#ifndef PM_OppFreeKick
-#define PM_OppFreeKick 10
-#endif
-#ifndef PM_OurPenaltyKick
-#define PM_OurPenaltyKick 11
-#endif
-#ifndef PM_OppPenaltyKick
-#define PM_OppPenaltyKick 12
-#endif
-
 // 全局变量
 static BallTools* ball_tools = nullptr;
 static Players* our_players = nullptr;
@@ -70,26 +44,6 @@ inline void debug(const std::string& message) {
     OutputDebugStringA((message + "\n").c_str());
 }
 
-// 获取游戏状态的辅助函数
-int getPlayMode(const WorldModel* model) {
-    const GameState* game_state = model->game_states();
-    if (!game_state) return PM_NORMAL; // 默认为正常比赛状态
-    
-    // 检查各种状态并返回对应的PlayMode
-    if (game_state->gameOff()) return PM_STOP;
-    
-    if (game_state->ourKickoff()) return PM_OurKickOff;
-    if (game_state->theirKickoff()) return PM_OppKickOff;
-    
-    if (game_state->ourDirectKick() || game_state->ourIndirectKick()) return PM_OurFreeKick;
-    if (game_state->theirDirectKick() || game_state->theirIndirectKick()) return PM_OppFreeKick;
-    
-    if (game_state->ourPenaltyKick()) return PM_OurPenaltyKick;
-    if (game_state->theirPenaltyKick()) return PM_OppPenaltyKick;
-    
-    return PM_NORMAL; // 默认为正常比赛状态
-}
-
 // 初始化函数
 void initialize(const WorldModel* model, int robot_id) {
     // 初始化工具类
@@ -152,11 +106,11 @@ extern "C" __declspec(dllexport) PlayerTask player_plan(const WorldModel* model,
     }
     
     try {
-        // 获取当前比赛状态
-        int play_mode = getPlayMode(model);
+        // 获取本帧解码好的比赛模式
+        PlayMode play_mode = model->get_play_mode();
         
-        // 特殊情况处理：如果处于停止状态，停在原地
-        if (play_mode == PM_STOP) {
+        // 特殊情况处理：如果处于停止或暂停状态，停在原地
+        if (play_mode == PlayMode::Stop || play_mode == PlayMode::Halt) {
             task.target_pos = our_players->getPosition(robot_id);
             task.orientate = our_players->getOrientation(robot_id);
             debug_output("Game stopped, robot " + std::to_string(robot_id) + " holding position");
@@ -3,13 +3,15 @@
 
 #include "tactics.h"
 #include "communication.h"
+#include "pass_evaluator.h"
+#include "pass_network.h"
 
 /**
  * @brief 直接进攻战术
  */
 class DirectAttackTactic : public Tactic {
 public:
-    DirectAttackTactic(const WorldModel* model) : Tactic(model) {}
+    DirectAttackTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env) {}
     
     std::string getName() const override {
         return "DirectAttack";
@@ -19,6 +21,10 @@ public:
         return TacticType::ATTACK;
     }
     
+    unsigned int getDependencies() const override {
+        return EVENT_POSSESSION_CHANGE | EVENT_BALL_ZONE_CHANGE | EVENT_REFEREE_COMMAND | EVENT_ROBOT_SET_CHANGE;
+    }
+    
     TacticEvaluation evaluate() const override {
         double score = 0.0;
         std::string desc = "Direct attack evaluation: ";
@@ -119,7 +125,7 @@ public:
  */
 class PassAndShootTactic : public Tactic {
 public:
-    PassAndShootTactic(const WorldModel* model) : Tactic(model) {}
+    PassAndShootTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env), pass_evaluator(model) {}
     
     std::string getName() const override {
         return "PassAndShoot";
@@ -129,6 +135,10 @@ public:
         return TacticType::ATTACK;
     }
     
+    unsigned int getDependencies() const override {
+        return EVENT_POSSESSION_CHANGE | EVENT_BALL_ZONE_CHANGE | EVENT_REFEREE_COMMAND | EVENT_ROBOT_SET_CHANGE;
+    }
+    
     TacticEvaluation evaluate() const override {
         double score = 0.0;
         std::string desc = "Pass and shoot evaluation: ";
@@ -141,7 +151,7 @@ public:
         
         // 评估条件2: 有两个球员在对方半场
         int players_in_opponent_half = 0;
-        std::vector<int> player_ids = our_players->getPlayerIds();
+        RobotSet player_ids = our_players->getPlayerIds();
         for (int id : player_ids) {
             if (our_players->isInOpponentHalf(id)) {
                 players_in_opponent_half++;
@@ -167,7 +177,7 @@ public:
                     // 检查传球路线上是否有对方球员
                     // 简化实现，实际中需要更复杂的碰撞检测
                     bool clear_path = true;
-                    std::vector<int> opp_ids = opp_players->getPlayerIds();
+                    RobotSet opp_ids = opp_players->getPlayerIds();
                     for (int opp_id : opp_ids) {
                         point2f opp_pos = opp_players->getPosition(opp_id);
                         
@@ -201,7 +211,7 @@ public:
     }
     
     PlayerTask execute(int robot_id) override {
-        std::vector<int> player_ids = our_players->getPlayerIds();
+        RobotSet player_ids = our_players->getPlayerIds();
         
         // 获取最接近球的我方球员
         int closest_to_ball = our_players->getClosestPlayerToBall();
@@ -214,58 +224,27 @@ public:
         if (robot_id == closest_to_ball) {
             // 如果是接近球的球员，判断是否持球
             if (our_players->canHoldBall(robot_id)) {
-                // 寻找传球目标
-                int pass_target = -1;
-                double best_score = -1;
+                // 批量评估所有队友及其周围提前量点的传球成功概率
+                pass_evaluator.evaluate(robot_id, ball_pos);
+                PassCandidate best_pass;
                 
-                for (int id : player_ids) {
-                    if (id != robot_id) {
-                        point2f target_pos = our_players->getPosition(id);
-                        
-                        // 计算传球评分
-                        double score = 0;
-                        
-                        // 加分: 目标球员接近对方球门
-                        double dist_to_goal = (target_pos - goal_pos).length();
-                        score += (800 - std::min(dist_to_goal, 800.0)) / 100;
-                        
-                        // 加分: 有清晰的传球路线
-                        bool clear_path = true;
-                        point2f player_pos = our_players->getPosition(robot_id);
-                        std::vector<int> opp_ids = opp_players->getPlayerIds();
-                        for (int opp_id : opp_ids) {
-                            point2f opp_pos = opp_players->getPosition(opp_id);
-                            double dist = distanceToLine(opp_pos, player_pos, target_pos);
-                            if (dist < 20) {
-                                clear_path = false;
-                                break;
-                            }
-                        }
-                        
-                        if (clear_path) {
-                            score += 3;
-                        }
-                        
-                        // 加分: 球员在对方半场
-                        if (our_players->isInOpponentHalf(id)) {
-                            score += 2;
-                        }
-                        
-                        // 更新最佳传球目标
-                        if (score > best_score) {
-                            best_score = score;
-                            pass_target = id;
-                        }
-                    }
+                // 多次传球后射门的成功率明显高于自己射门时，先传给传球链上的第一个接球者
+                PassChain chain;
+                if (pass_network->search(robot_id, ball_pos, 2, chain) && chain.probability > 0.3 &&
+                    chain.probability > pass_network->shotProbability(robot_id) + 0.15 &&
+                    pass_evaluator.bestFor(chain.ids[1], best_pass) && best_pass.probability > 0.7) {
+                    // 提前量传球的落点不在接球者当前位置，需要通知接球者跑到落点
+                    communication->sendPassIntention(best_pass.receiver_id, best_pass.target);
+                    return PassEvaluator::makePassTask(ball_pos, best_pass);
                 }
                 
-                // 如果找到了好的传球目标
-                if (pass_target >= 0 && best_score > 3) {
-                    // 发送传球意图通信
-                    // Communication::getInstance().sendPassIntention(pass_target, our_players->getPosition(pass_target));
+                // 如果找到了成功概率足够高的传球目标
+                if (pass_evaluator.best(best_pass) && best_pass.probability > 0.7) {
+                    // 发送传球意图通信，接球者跑到提前量落点
+                    communication->sendPassIntention(best_pass.receiver_id, best_pass.target);
                     
                     // 执行传球
-                    return our_players->createPassTask(robot_id, pass_target);
+                    return PassEvaluator::makePassTask(ball_pos, best_pass);
                 } else {
                     // 没有好的传球目标，尝试自己带球或射门
                     double shoot_difficulty = opp_goalie->evaluateShootingDifficulty(our_players->getPosition(robot_id));
@@ -348,6 +327,8 @@ private:
         point2f projection = a + (b - a) * t;
         return (p - projection).length();
     }
+    
+    PassEvaluator pass_evaluator;   // 传球候选批量评估
 };
 
 /**
@@ -355,7 +336,7 @@ private:
  */
 class WingAttackTactic : public Tactic {
 public:
-    WingAttackTactic(const WorldModel* model) : Tactic(model) {}
+    WingAttackTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env) {}
     
     std::string getName() const override {
         return "WingAttack";
@@ -365,6 +346,10 @@ public:
         return TacticType::ATTACK;
     }
     
+    unsigned int getDependencies() const override {
+        return EVENT_POSSESSION_CHANGE | EVENT_BALL_ZONE_CHANGE | EVENT_REFEREE_COMMAND | EVENT_ROBOT_SET_CHANGE;
+    }
+    
     TacticEvaluation evaluate() const override {
         double score = 0.0;
         std::string desc = "Wing attack evaluation: ";
@@ -377,7 +362,7 @@ public:
         }
         
         // 评估条件2: 前场有球员
-        std::vector<int> player_ids = our_players->getPlayerIds();
+        RobotSet player_ids = our_players->getPlayerIds();
         bool forward_player = false;
         for (int id : player_ids) {
             point2f pos = our_players->getPosition(id);
@@ -394,7 +379,7 @@ public:
         
         // 评估条件3: 中路对方防守密集
         int center_defenders = 0;
-        std::vector<int> opp_ids = opp_players->getPlayerIds();
+        RobotSet opp_ids = opp_players->getPlayerIds();
         for (int id : opp_ids) {
             point2f pos = opp_players->getPosition(id);
             if (pos.x > 0 && fabs(pos.y) < 100) {
@@ -413,7 +398,7 @@ public:
     }
     
     PlayerTask execute(int robot_id) override {
-        std::vector<int> player_ids = our_players->getPlayerIds();
+        RobotSet player_ids = our_players->getPlayerIds();
         point2f ball_pos = ball_tools->getPosition();
         point2f player_pos = our_players->getPosition(robot_id);
         
@@ -479,7 +464,7 @@ public:
                     
                     if (best_target >= 0) {
                         // 发送传球意图
-                        // Communication::getInstance().sendPassIntention(best_target, our_players->getPosition(best_target));
+                        communication->sendPassIntention(best_target, our_players->getPosition(best_target));
                         
                         // 执行传中
                         return our_players->createPassTask(robot_id, best_target, 4.0);  // 传球力量稍大
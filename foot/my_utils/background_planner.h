@@ -0,0 +1,235 @@
+#ifndef BACKGROUND_PLANNER_H
+#define BACKGROUND_PLANNER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "../utils/world_snapshot.h"
+
+/**
+ * @brief 单写单读的最新值槽（三缓冲）
+ * 写端在自己的缓冲区里写完后publish，读端fetch取走最近一次发布的值；双方都不加锁、不等待，
+ * 写端发布得比读端取得快时中间的值被直接覆盖。写端和读端各只能有一个线程。
+ */
+template <typename T>
+class LatestSlot {
+public:
+    LatestSlot() : write_index(0), read_index(1), middle(2) {}
+
+    LatestSlot(const LatestSlot&) = delete;
+    LatestSlot& operator=(const LatestSlot&) = delete;
+
+    /**
+     * @brief 写端的缓冲区，publish之前读端看不到
+     */
+    T& writeBuffer() { return buffers[write_index]; }
+
+    /**
+     * @brief 发布写端缓冲区，换一个空闲缓冲区继续写
+     */
+    void publish() {
+        unsigned prev = middle.exchange(write_index | FRESH, std::memory_order_acq_rel);
+        write_index = prev & INDEX_MASK;
+    }
+
+    /**
+     * @brief 取走最近一次发布的值
+     * @return 上次fetch之后没有新的发布时返回false，readBuffer保持不变
+     */
+    bool fetch() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        unsigned prev = middle.exchange(read_index, std::memory_order_acq_rel);
+        read_index = prev & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief 读端最近一次fetch到的值
+     */
+    const T& readBuffer() const { return buffers[read_index]; }
+
+private:
+    static const unsigned INDEX_MASK = 3;
+    static const unsigned FRESH = 4;
+
+    T buffers[3];
+    unsigned write_index;               // 只由写端访问
+    unsigned read_index;                // 只由读端访问
+    alignas(64) std::atomic<unsigned> middle;   // 交换中的缓冲区下标，FRESH表示有未取走的发布
+};
+
+/**
+ * @brief 后台任务接口
+ * 任务按"遍"细化结果：每一遍开始时换上最新快照，一遍可以跨越多帧，每次refine只推进一小步。
+ * 与上一遍的快照相比变化不大时任务在上一遍的基础上继续细化，否则从头开始。
+ */
+template <typename Result>
+class BackgroundTask {
+public:
+    virtual ~BackgroundTask() {}
+
+    /**
+     * @brief 开始新的一遍
+     * @param snapshot 最新快照，可能与上一遍相同
+     */
+    virtual void begin(const WorldSnapshot& snapshot) = 0;
+
+    /**
+     * @brief 推进一步
+     * @param out 本遍完成时写入结果
+     * @return 本遍完成时返回true
+     */
+    virtual bool refine(Result& out) = 0;
+
+    /**
+     * @brief 在当前快照上已经细化到头，没有新快照时后台线程休眠
+     */
+    virtual bool done() const = 0;
+};
+
+/**
+ * @brief 后台长时域规划器
+ * 规划线程每帧在帧边界用submit交出最新快照，后台线程每一遍开始时取最新快照，
+ * 每完成一遍就带版本号和快照周期发布结果；规划线程用latest取最新结果，超过时效的结果不使用。
+ * 两个方向都经过LatestSlot传递，实时路径上不加锁、不等待后台线程。
+ * submit和latest各自同一时刻只能由一个线程调用（可以是不同的线程）。
+ */
+template <typename Result>
+class BackgroundPlanner {
+public:
+    /**
+     * @brief 带版本号的结果
+     */
+    struct Published {
+        Result value;
+        unsigned int version = 0;       // 发布序号，从1开始递增
+        int source_cycle = -1;          // 计算所用快照的周期
+    };
+
+    explicit BackgroundPlanner(std::unique_ptr<BackgroundTask<Result>> background_task) :
+        task(std::move(background_task)),
+        running(false),
+        stopping(false),
+        has_snapshot(false),
+        published(0) {}
+
+    ~BackgroundPlanner() {
+        stop();
+    }
+
+    BackgroundPlanner(const BackgroundPlanner&) = delete;
+    BackgroundPlanner& operator=(const BackgroundPlanner&) = delete;
+
+    /**
+     * @brief 启动后台线程，已启动时直接返回
+     */
+    void start() {
+        if (running) {
+            return;
+        }
+        stopping = false;
+        running = true;
+        worker = std::thread(&BackgroundPlanner::workerLoop, this);
+    }
+
+    /**
+     * @brief 停止并等待后台线程退出
+     */
+    void stop() {
+        if (!running) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake_cv.notify_one();
+        worker.join();
+        running = false;
+    }
+
+    bool isRunning() const { return running; }
+
+    /**
+     * @brief 交出本帧快照（帧边界调用），不等待后台线程
+     */
+    void submit(const WorldSnapshot& snapshot) {
+        input.writeBuffer() = snapshot;
+        input.publish();
+        wake_cv.notify_one();
+    }
+
+    /**
+     * @brief 取最新的已完成结果
+     * @param cycle 当前周期
+     * @param max_age 允许的最大滞后帧数
+     * @param out 结果
+     * @return 没有结果或结果滞后超过max_age帧时返回false
+     */
+    bool latest(int cycle, int max_age, Published& out) {
+        output.fetch();
+        const Published& p = output.readBuffer();
+        if (p.version == 0 || cycle - p.source_cycle > max_age) {
+            return false;
+        }
+        out = p;
+        return true;
+    }
+
+    /**
+     * @brief 已发布的结果数
+     */
+    unsigned int publishedCount() const { return published.load(std::memory_order_relaxed); }
+
+private:
+    // 任务做完后最多休眠这么久再检查新快照，submit的唤醒丢失时也不会停太久
+    static const int IDLE_WAIT_MS = 2;
+
+    void workerLoop() {
+        int cycle = -1;
+        bool in_pass = false;
+        for (;;) {
+            if (stopping.load(std::memory_order_relaxed)) {
+                return;
+            }
+            // 两遍之间换上最新快照；没有新快照且已细化到头时休眠
+            if (!in_pass) {
+                if (input.fetch()) {
+                    has_snapshot = true;
+                } else if (!has_snapshot || task->done()) {
+                    std::unique_lock<std::mutex> lock(wake_mutex);
+                    wake_cv.wait_for(lock, std::chrono::milliseconds(IDLE_WAIT_MS));
+                    continue;
+                }
+                cycle = input.readBuffer().cycle;
+                task->begin(input.readBuffer());
+                in_pass = true;
+            }
+            Published& p = output.writeBuffer();
+            if (task->refine(p.value)) {
+                p.version = published.fetch_add(1, std::memory_order_relaxed) + 1;
+                p.source_cycle = cycle;
+                output.publish();
+                in_pass = false;
+            }
+        }
+    }
+
+    std::unique_ptr<BackgroundTask<Result>> task;
+    LatestSlot<WorldSnapshot> input;
+    LatestSlot<Published> output;
+    std::thread worker;
+    bool running;
+    std::atomic<bool> stopping;
+    bool has_snapshot;                  // 只由后台线程访问
+    std::atomic<unsigned int> published;
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+};
+
+#endif // BACKGROUND_PLANNER_H
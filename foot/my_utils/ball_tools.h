@@ -464,32 +464,25 @@ public:
             return -1;
         }
         
-        const bool* our_exists = world_model->get_our_exist_id();
-        const bool* opp_exists = world_model->get_opp_exist_id();
-        
         // 检查我方球员
-        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-            if (our_exists[i]) {
-                point2f player_pos = world_model->get_our_player_pos(i);
-                double player_dir = world_model->get_our_player_dir(i);
-                
-                if (isPlayerControllingBall(player_pos, player_dir)) {
-                    is_our_team = true;
-                    return i;
-                }
+        for (int i : world_model->get_our_set()) {
+            point2f player_pos = world_model->get_our_player_pos(i);
+            double player_dir = world_model->get_our_player_dir(i);
+            
+            if (isPlayerControllingBall(player_pos, player_dir)) {
+                is_our_team = true;
+                return i;
             }
         }
         
         // 检查对方球员
-        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-            if (opp_exists[i]) {
-                point2f player_pos = world_model->get_opp_player_pos(i);
-                double player_dir = world_model->get_opp_player_dir(i);
-                
-                if (isPlayerControllingBall(player_pos, player_dir)) {
-                    is_our_team = false;
-                    return i;
-                }
+        for (int i : world_model->get_opp_set()) {
+            point2f player_pos = world_model->get_opp_player_pos(i);
+            double player_dir = world_model->get_opp_player_dir(i);
+            
+            if (isPlayerControllingBall(player_pos, player_dir)) {
+                is_our_team = false;
+                return i;
             }
         }
         
@@ -659,30 +652,23 @@ private:
      * @return 是否被控制
      */
     bool checkIfControlled() const {
-        const bool* our_exists = world_model->get_our_exist_id();
-        const bool* opp_exists = world_model->get_opp_exist_id();
-        
         // 检查球是否被我方球员控制
-        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-            if (our_exists[i]) {
-                point2f player_pos = world_model->get_our_player_pos(i);
-                double player_dir = world_model->get_our_player_dir(i);
-                
-                if (isPlayerControllingBall(player_pos, player_dir)) {
-                    return true;
-                }
+        for (int i : world_model->get_our_set()) {
+            point2f player_pos = world_model->get_our_player_pos(i);
+            double player_dir = world_model->get_our_player_dir(i);
+            
+            if (isPlayerControllingBall(player_pos, player_dir)) {
+                return true;
             }
         }
         
         // 检查球是否被对方球员控制
-        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-            if (opp_exists[i]) {
-                point2f player_pos = world_model->get_opp_player_pos(i);
-                double player_dir = world_model->get_opp_player_dir(i);
-                
-                if (isPlayerControllingBall(player_pos, player_dir)) {
-                    return true;
-                }
+        for (int i : world_model->get_opp_set()) {
+            point2f player_pos = world_model->get_opp_player_pos(i);
+            double player_dir = world_model->get_opp_player_dir(i);
+            
+            if (isPlayerControllingBall(player_pos, player_dir)) {
+                return true;
             }
         }
         
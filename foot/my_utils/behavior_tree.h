@@ -0,0 +1,325 @@
+#ifndef BEHAVIOR_TREE_H
+#define BEHAVIOR_TREE_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+
+/**
+ * @brief 行为树节点执行结果
+ */
+enum class BTStatus : unsigned char {
+    SUCCESS,    // 成功
+    FAILURE,    // 失败
+    RUNNING     // 运行中（与成功一样终止选择节点，与失败一样终止顺序节点）
+};
+
+/**
+ * @brief 行为树节点类型
+ */
+enum class BTNodeType : unsigned char {
+    SELECTOR,   // 选择节点：依次执行子节点，直到有一个不失败
+    SEQUENCE,   // 顺序节点：依次执行子节点，直到有一个不成功
+    CONDITION,  // 条件节点
+    ACTION      // 动作节点
+};
+
+/**
+ * @brief 单个节点的计时统计
+ */
+struct BTNodeStats {
+    unsigned long long ticks;       // 被执行次数
+    unsigned long long successes;   // 返回成功(或运行中)的次数
+    unsigned long long total_ns;    // 累计耗时(纳秒)
+    unsigned long long max_ns;      // 单次最大耗时(纳秒)
+
+    BTNodeStats() : ticks(0), successes(0), total_ns(0), max_ns(0) {}
+};
+
+/**
+ * @brief 扁平化行为树
+ * 初始化时由BehaviorTreeBuilder构建成按先序排列的连续节点数组，
+ * 每个节点记录父节点和子树结束位置。执行时用循环代替递归，不做任何内存分配。
+ * @tparam Blackboard 执行时在节点之间共享的上下文类型
+ */
+template <class Blackboard>
+class BehaviorTree {
+public:
+    typedef bool (*ConditionFn)(Blackboard& bb);
+    typedef BTStatus (*ActionFn)(Blackboard& bb);
+
+    /**
+     * @brief 扁平节点
+     */
+    struct Node {
+        BTNodeType type;
+        int parent;             // 父节点下标，根节点为-1
+        int subtree_end;        // 子树结束位置（最后一个后代的下一个下标）
+        ConditionFn condition;
+        ActionFn action;
+        const char* name;
+    };
+
+    BehaviorTree() : profiling(true) {}
+
+    /**
+     * @brief 执行一次行为树
+     * @param bb 共享上下文
+     * @return 根节点执行结果
+     */
+    BTStatus tick(Blackboard& bb) {
+        if (nodes.empty()) {
+            return BTStatus::FAILURE;
+        }
+
+        const int count = static_cast<int>(nodes.size());
+        int index = 0;
+        BTStatus status = BTStatus::FAILURE;
+
+        while (true) {
+            // 向下：进入组合节点时记录开始时间，直到遇到叶子节点
+            while (isComposite(index)) {
+                enter(index);
+                if (index + 1 >= nodes[index].subtree_end) {
+                    // 空组合节点：选择节点失败，顺序节点成功
+                    break;
+                }
+                index++;
+            }
+
+            if (isComposite(index)) {
+                status = (nodes[index].type == BTNodeType::SEQUENCE) ? BTStatus::SUCCESS : BTStatus::FAILURE;
+                leave(index, status);
+            } else {
+                status = runLeaf(index, bb);
+            }
+
+            // 向上：把结果传给父节点，决定继续执行兄弟节点还是结束父节点
+            int child = index;
+            int parent = nodes[child].parent;
+            bool descend = false;
+            while (parent >= 0) {
+                bool stop_here = (nodes[parent].type == BTNodeType::SELECTOR) ?
+                                 (status != BTStatus::FAILURE) :
+                                 (status != BTStatus::SUCCESS);
+                int next_sibling = nodes[child].subtree_end;
+                if (!stop_here && next_sibling < nodes[parent].subtree_end) {
+                    index = next_sibling;
+                    descend = true;
+                    break;
+                }
+                leave(parent, status);
+                child = parent;
+                parent = nodes[child].parent;
+            }
+
+            if (!descend || index >= count) {
+                return status;
+            }
+        }
+    }
+
+    /**
+     * @brief 启用或禁用节点计时
+     * @param enable 是否启用
+     */
+    void setProfiling(bool enable) {
+        profiling = enable;
+    }
+
+    /**
+     * @brief 清零所有节点的计时统计
+     */
+    void resetStats() {
+        for (size_t i = 0; i < stats.size(); i++) {
+            stats[i] = BTNodeStats();
+        }
+    }
+
+    /**
+     * @brief 节点数量
+     * @return 节点数量
+     */
+    int size() const {
+        return static_cast<int>(nodes.size());
+    }
+
+    /**
+     * @brief 获取节点
+     * @param index 节点下标
+     * @return 节点
+     */
+    const Node& getNode(int index) const {
+        return nodes[index];
+    }
+
+    /**
+     * @brief 获取节点计时统计
+     * @param index 节点下标
+     * @return 计时统计
+     */
+    const BTNodeStats& getStats(int index) const {
+        return stats[index];
+    }
+
+    /**
+     * @brief 生成计时报告，便于输出到日志
+     * @return 每个节点一行的报告
+     */
+    std::string report() const {
+        std::string out;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            int depth = 0;
+            for (int p = nodes[i].parent; p >= 0; p = nodes[p].parent) depth++;
+            const BTNodeStats& s = stats[i];
+            double avg_us = s.ticks ? s.total_ns / 1000.0 / s.ticks : 0.0;
+            out += std::string(depth * 2, ' ') + nodes[i].name +
+                   " ticks=" + std::to_string(s.ticks) +
+                   " ok=" + std::to_string(s.successes) +
+                   " avg=" + std::to_string(avg_us) + "us" +
+                   " max=" + std::to_string(s.max_ns / 1000.0) + "us\n";
+        }
+        return out;
+    }
+
+private:
+    template <class> friend class BehaviorTreeBuilder;
+    typedef std::chrono::steady_clock Clock;
+
+    bool isComposite(int index) const {
+        return nodes[index].type == BTNodeType::SELECTOR || nodes[index].type == BTNodeType::SEQUENCE;
+    }
+
+    void enter(int index) {
+        if (profiling) {
+            entry_times[index] = Clock::now();
+        }
+    }
+
+    void leave(int index, BTStatus status) {
+        BTNodeStats& s = stats[index];
+        s.ticks++;
+        if (status != BTStatus::FAILURE) s.successes++;
+        if (profiling) {
+            record(s, Clock::now() - entry_times[index]);
+        }
+    }
+
+    BTStatus runLeaf(int index, Blackboard& bb) {
+        const Node& node = nodes[index];
+        Clock::time_point start;
+        if (profiling) start = Clock::now();
+
+        BTStatus status;
+        if (node.type == BTNodeType::CONDITION) {
+            status = node.condition(bb) ? BTStatus::SUCCESS : BTStatus::FAILURE;
+        } else {
+            status = node.action(bb);
+        }
+
+        BTNodeStats& s = stats[index];
+        s.ticks++;
+        if (status != BTStatus::FAILURE) s.successes++;
+        if (profiling) {
+            record(s, Clock::now() - start);
+        }
+        return status;
+    }
+
+    static void record(BTNodeStats& s, Clock::duration elapsed) {
+        unsigned long long ns = static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        s.total_ns += ns;
+        if (ns > s.max_ns) s.max_ns = ns;
+    }
+
+    std::vector<Node> nodes;                    // 先序排列的节点数组
+    std::vector<BTNodeStats> stats;             // 与节点一一对应的计时统计
+    std::vector<Clock::time_point> entry_times; // 组合节点的进入时间
+    bool profiling;
+};
+
+/**
+ * @brief 行为树构建器，仅在初始化阶段使用
+ * 用法：
+ *   BehaviorTreeBuilder<Ctx> b;
+ *   b.selector("root")
+ *       .sequence("stop").condition("is_stop", isStop).action("hold", hold).end()
+ *       .action("default", fallback)
+ *    .end();
+ *   BehaviorTree<Ctx> tree = b.build();
+ */
+template <class Blackboard>
+class BehaviorTreeBuilder {
+public:
+    typedef BehaviorTree<Blackboard> Tree;
+
+    BehaviorTreeBuilder& selector(const char* name) {
+        return open(BTNodeType::SELECTOR, name);
+    }
+
+    BehaviorTreeBuilder& sequence(const char* name) {
+        return open(BTNodeType::SEQUENCE, name);
+    }
+
+    BehaviorTreeBuilder& condition(const char* name, typename Tree::ConditionFn fn) {
+        typename Tree::Node& node = push(BTNodeType::CONDITION, name);
+        node.condition = fn;
+        node.subtree_end = static_cast<int>(tree.nodes.size());
+        return *this;
+    }
+
+    BehaviorTreeBuilder& action(const char* name, typename Tree::ActionFn fn) {
+        typename Tree::Node& node = push(BTNodeType::ACTION, name);
+        node.action = fn;
+        node.subtree_end = static_cast<int>(tree.nodes.size());
+        return *this;
+    }
+
+    /**
+     * @brief 结束当前组合节点
+     */
+    BehaviorTreeBuilder& end() {
+        assert(!open_nodes.empty());
+        int index = open_nodes.back();
+        open_nodes.pop_back();
+        tree.nodes[index].subtree_end = static_cast<int>(tree.nodes.size());
+        return *this;
+    }
+
+    /**
+     * @brief 完成构建，为计时统计预先分配空间
+     * @return 扁平化的行为树
+     */
+    Tree build() {
+        assert(open_nodes.empty());
+        tree.stats.assign(tree.nodes.size(), BTNodeStats());
+        tree.entry_times.resize(tree.nodes.size());
+        return tree;
+    }
+
+private:
+    BehaviorTreeBuilder& open(BTNodeType type, const char* name) {
+        push(type, name);
+        open_nodes.push_back(static_cast<int>(tree.nodes.size()) - 1);
+        return *this;
+    }
+
+    typename Tree::Node& push(BTNodeType type, const char* name) {
+        typename Tree::Node node;
+        node.type = type;
+        node.parent = open_nodes.empty() ? -1 : open_nodes.back();
+        node.subtree_end = 0;
+        node.condition = nullptr;
+        node.action = nullptr;
+        node.name = name;
+        tree.nodes.push_back(node);
+        return tree.nodes.back();
+    }
+
+    Tree tree;
+    std::vector<int> open_nodes;
+};
+
+#endif // BEHAVIOR_TREE_H
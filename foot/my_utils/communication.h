@@ -47,17 +47,39 @@ struct Message {
 
 /**
  * @brief 球员间通信工具类，使用共享内存方式实现
+ * getInstance()为默认实例；PlannerContext各自持有的实例用不同的通道名，互不串话，日志写入所属上下文的Logger
  */
 class Communication {
 public:
+    static constexpr const char* DEFAULT_CHANNEL = "Soccer_Robot_Communication";
+
     /**
-     * @brief 获取单例实例
-     * @return Communication单例
+     * @brief 获取默认实例
+     * @return 默认Communication
      */
     static Communication& getInstance() {
-        static Communication instance;
+        static Communication instance(Logger::getInstance());
         return instance;
     }
+    
+    /**
+     * @brief 构造函数
+     * @param log 写入日志的Logger
+     */
+    explicit Communication(Logger& log) : logger(&log), robot_id(-1), current_cycle(0), is_initialized(false),
+                     channel(DEFAULT_CHANNEL), shared_memory(NULL), h_mapping(NULL), h_mutex(NULL) {}
+    
+    ~Communication() {
+        cleanup();
+    }
+    
+    /**
+     * @brief 设置共享内存通道名，需在initialize之前调用；同一通道上的机器人互相通信
+     * @param name 通道名
+     */
+    void setChannel(const std::string& name) {
+        channel = name;
+    }
 
     /**
      * @brief 初始化通信系统
@@ -71,7 +93,7 @@ public:
         try {
             // 使用文件映射实现共享内存
             // 实际项目中可能需要考虑更安全的方式，这里使用简化版本
-            std::string mapping_name = "Soccer_Robot_Communication";
+            std::string mapping_name = channel;
             
             // 创建或打开文件映射
             h_mapping = CreateFileMapping(
@@ -83,7 +105,7 @@ public:
                 mapping_name.c_str());  // 映射名称
             
             if (h_mapping == NULL) {
-                LOG_ERROR("Failed to create file mapping", robot_id);
+                logger->error_log("Failed to create file mapping", robot_id);
                 return false;
             }
             
@@ -96,16 +118,16 @@ public:
                 sizeof(SharedMemory));  // 映射大小
             
             if (shared_memory == NULL) {
-                LOG_ERROR("Failed to map view of file", robot_id);
+                logger->error_log("Failed to map view of file", robot_id);
                 CloseHandle(h_mapping);
                 h_mapping = NULL;
                 return false;
             }
             
             // 创建互斥锁
-            h_mutex = CreateMutex(NULL, FALSE, "Soccer_Robot_Communication_Mutex");
+            h_mutex = CreateMutex(NULL, FALSE, (channel + "_Mutex").c_str());
             if (h_mutex == NULL) {
-                LOG_ERROR("Failed to create mutex", robot_id);
+                logger->error_log("Failed to create mutex", robot_id);
                 UnmapViewOfFile(shared_memory);
                 CloseHandle(h_mapping);
                 h_mapping = NULL;
@@ -120,11 +142,11 @@ public:
             }
             
             is_initialized = true;
-            LOG_INFO("Communication system initialized", robot_id);
+            logger->info("Communication system initialized", robot_id);
             return true;
             
         } catch (const std::exception& e) {
-            LOG_ERROR(std::string("Communication initialization error: ") + e.what(), robot_id);
+            logger->error_log(std::string("Communication initialization error: ") + e.what(), robot_id);
             return false;
         }
     }
@@ -141,7 +163,7 @@ public:
     bool sendMessage(int receiver_id, MessageType type, const point2f& position = point2f(0, 0), 
                    double orientation = 0, const std::string& data = "") {
         if (!is_initialized || shared_memory == NULL) {
-            LOG_ERROR("Cannot send message: Communication not initialized", robot_id);
+            logger->error_log("Cannot send message: Communication not initialized", robot_id);
             return false;
         }
         
@@ -166,16 +188,16 @@ public:
                     
                     ReleaseMutex(h_mutex);
                     
-                    LOG_DEBUG("Message sent to robot " + std::to_string(receiver_id) + 
+                    logger->debug("Message sent to robot " + std::to_string(receiver_id) + 
                              ", type: " + std::to_string(static_cast<int>(type)), robot_id);
                     return true;
                 }
             }
             
             ReleaseMutex(h_mutex);
-            LOG_WARNING("Message buffer full", robot_id);
+            logger->warning("Message buffer full", robot_id);
         } else {
-            LOG_ERROR("Failed to acquire mutex for sending", robot_id);
+            logger->error_log("Failed to acquire mutex for sending", robot_id);
         }
         
         return false;
@@ -189,7 +211,7 @@ public:
     Message receiveMessage(MessageType type = MessageType::NONE) {
         Message result;
         if (!is_initialized || shared_memory == NULL) {
-            LOG_ERROR("Cannot receive message: Communication not initialized", robot_id);
+            logger->error_log("Cannot receive message: Communication not initialized", robot_id);
             return result;
         }
         
@@ -219,11 +241,11 @@ public:
             ReleaseMutex(h_mutex);
             
             if (latest_timestamp > 0) {
-                LOG_DEBUG("Message received from robot " + std::to_string(result.sender_id) + 
+                logger->debug("Message received from robot " + std::to_string(result.sender_id) + 
                          ", type: " + std::to_string(static_cast<int>(result.type)), robot_id);
             }
         } else {
-            LOG_ERROR("Failed to acquire mutex for receiving", robot_id);
+            logger->error_log("Failed to acquire mutex for receiving", robot_id);
         }
         
         return result;
@@ -258,7 +280,7 @@ public:
             }
             
             is_initialized = false;
-            LOG_INFO("Communication system cleaned up", robot_id);
+            logger->info("Communication system cleaned up", robot_id);
         }
     }
     
@@ -369,23 +391,16 @@ private:
         SharedMemoryMessage messages[MAX_MESSAGES];
     };
     
-    // 构造函数私有化
-    Communication() : robot_id(-1), current_cycle(0), is_initialized(false), 
-                     shared_memory(NULL), h_mapping(NULL), h_mutex(NULL) {}
-    
-    // 析构函数
-    ~Communication() {
-        cleanup();
-    }
-    
     // 禁用拷贝和赋值
     Communication(const Communication&) = delete;
     Communication& operator=(const Communication&) = delete;
     
     // 成员变量
+    Logger* logger;
     int robot_id;
     int current_cycle;
     bool is_initialized;
+    std::string channel;
     SharedMemory* shared_memory;
     HANDLE h_mapping;
     HANDLE h_mutex;
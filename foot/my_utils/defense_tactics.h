@@ -3,13 +3,14 @@
 
 #include "tactics.h"
 #include "communication.h"
+#include "defense_wall.h"
 
 /**
  * @brief 人盯人防守战术
  */
 class ManMarkingTactic : public Tactic {
 public:
-    ManMarkingTactic(const WorldModel* model) : Tactic(model), target_id(-1) {}
+    ManMarkingTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env), target_id(-1) {}
     
     std::string getName() const override {
         return "ManMarking";
@@ -19,6 +20,10 @@ public:
         return TacticType::DEFENSE;
     }
     
+    unsigned int getDependencies() const override {
+        return EVENT_POSSESSION_CHANGE | EVENT_BALL_ZONE_CHANGE | EVENT_OPP_BOX_CHANGE | EVENT_REFEREE_COMMAND | EVENT_ROBOT_SET_CHANGE;
+    }
+    
     TacticEvaluation evaluate() const override {
         double score = 0.0;
         std::string desc = "Man marking evaluation: ";
@@ -136,7 +141,7 @@ private:
  */
 class ZoneDefenseTactic : public Tactic {
 public:
-    ZoneDefenseTactic(const WorldModel* model) : Tactic(model) {}
+    ZoneDefenseTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env) {}
     
     std::string getName() const override {
         return "ZoneDefense";
@@ -146,6 +151,10 @@ public:
         return TacticType::DEFENSE;
     }
     
+    unsigned int getDependencies() const override {
+        return EVENT_POSSESSION_CHANGE | EVENT_BALL_ZONE_CHANGE | EVENT_OPP_BOX_CHANGE | EVENT_REFEREE_COMMAND | EVENT_ROBOT_SET_CHANGE;
+    }
+    
     TacticEvaluation evaluate() const override {
         double score = 0.0;
         std::string desc = "Zone defense evaluation: ";
@@ -187,17 +196,10 @@ public:
         point2f defense_pos;
         
         // 获取所有球员ID，决定当前球员防守哪个区域
-        std::vector<int> player_ids = our_players->getPlayerIds();
-        int num_players = player_ids.size();
-        
-        // 找到当前球员在队伍中的索引
-        int player_index = -1;
-        for (int i = 0; i < num_players; i++) {
-            if (player_ids[i] == robot_id) {
-                player_index = i;
-                break;
-            }
-        }
+        RobotSet player_ids = our_players->getPlayerIds();
+        
+        // 当前球员在队伍中的索引（按ID从小到大），不在场时为-1
+        int player_index = player_ids.rank(robot_id);
         
         // 根据球员索引分配不同的防守区域
         if (player_index == 0 || player_index == -1) {
@@ -267,7 +269,7 @@ public:
  */
 class RetreatDefenseTactic : public Tactic {
 public:
-    RetreatDefenseTactic(const WorldModel* model) : Tactic(model) {}
+    RetreatDefenseTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env), wall_cycle(-1) {}
     
     std::string getName() const override {
         return "RetreatDefense";
@@ -277,18 +279,17 @@ public:
         return TacticType::DEFENSE;
     }
     
+    unsigned int getDependencies() const override {
+        return EVENT_POSSESSION_CHANGE | EVENT_BALL_ZONE_CHANGE | EVENT_OPP_BOX_CHANGE | EVENT_REFEREE_COMMAND | EVENT_ROBOT_SET_CHANGE;
+    }
+    
     TacticEvaluation evaluate() const override {
         double score = 0.0;
         std::string desc = "Retreat defense evaluation: ";
         
         // 评估条件1: 如果我方少人或有球员被罚下
-        int our_count = 0;
-        int opp_count = 0;
-        
-        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-            if (world_model->get_our_exist_id()[i]) our_count++;
-            if (world_model->get_opp_exist_id()[i]) opp_count++;
-        }
+        int our_count = world_model->get_our_set().size();
+        int opp_count = world_model->get_opp_set().size();
         
         if (our_count < opp_count) {
             score += 3.0;
@@ -300,7 +301,7 @@ public:
         if (ball_pos.x > 0) {
             // 球在对方半场
             int opp_attacking_players = 0;
-            std::vector<int> opp_ids = opp_players->getPlayerIds();
+            RobotSet opp_ids = opp_players->getPlayerIds();
             
             for (int id : opp_ids) {
                 point2f pos = opp_players->getPosition(id);
@@ -331,17 +332,10 @@ public:
         point2f our_goal(-FIELD_LENGTH_H, 0);
         
         // 获取所有球员ID，确定防守顺序
-        std::vector<int> player_ids = our_players->getPlayerIds();
-        int num_players = player_ids.size();
-        
-        // 找到当前球员在队伍中的索引
-        int player_index = 0;
-        for (int i = 0; i < num_players; i++) {
-            if (player_ids[i] == robot_id) {
-                player_index = i;
-                break;
-            }
-        }
+        RobotSet player_ids = our_players->getPlayerIds();
+        
+        // 当前球员在队伍中的索引（按ID从小到大）
+        int player_index = std::max(player_ids.rank(robot_id), 0);
         
         // 根据球员位置计算防守位置
         point2f defense_pos;
@@ -377,17 +371,75 @@ public:
         defense_pos.y = std::min(std::max(defense_pos.y, -FIELD_WIDTH_H + 30), FIELD_WIDTH_H - 30);
         
         // 如果是最接近球的球员且球在我方半场，考虑去抢球
-        if (robot_id == our_players->getClosestPlayerToBall() && 
-            ball_pos.x < 0 && 
-            (ball_pos - our_players->getPosition(robot_id)).length() < 120) {
+        if (robot_id == chaserId(ball_pos)) {
             return our_players->createMoveTask(robot_id, ball_pos);
         }
         
+        // 人墙中的球员与守门员配合封堵射门角度，其余球员保持阵型
+        updateWall(ball_pos);
+        int slot = wall.slotOf(robot_id);
+        if (slot >= 0) {
+            defense_pos = wall.pos[slot];
+        }
+        
         // 面向球的方向
         double orientation = (ball_pos - defense_pos).angle();
         
         return our_players->createMoveTask(robot_id, defense_pos, orientation);
     }
+    
+private:
+    static const int WALL_SIZE = 3;     // 人墙最多使用的球员数
+    
+    /**
+     * @brief 去抢球的球员：离球最近、球在我方半场且离球足够近
+     * @return 没有球员去抢球时返回-1
+     */
+    int chaserId(const point2f& ball_pos) const {
+        int id = our_players->getClosestPlayerToBall();
+        if (id >= 0 && ball_pos.x < 0 && (ball_pos - our_players->getPosition(id)).length() < 120) {
+            return id;
+        }
+        return -1;
+    }
+    
+    /**
+     * @brief 每帧求解一次人墙站位并分配给移动时间最短的球员，去抢球的球员不参与人墙
+     * @param ball_pos 球的位置
+     */
+    void updateWall(const point2f& ball_pos) {
+        int cycle = world_model->get_cycle();
+        if (cycle == wall_cycle) {
+            return;
+        }
+        wall_cycle = cycle;
+        
+        int goalie_id = world_model->get_our_goalie();
+        bool has_goalie = world_model->get_our_set().contains(goalie_id);
+        point2f goalie_pos = has_goalie ? world_model->get_our_player_pos(goalie_id) : point2f(-FIELD_LENGTH_H, 0);
+        
+        int chaser = chaserId(ball_pos);
+        int ids[MAX_TEAM_ROBOTS];
+        int n = 0;
+        for (int id : world_model->get_our_field_set()) {
+            if (id != chaser) {
+                ids[n++] = id;
+            }
+        }
+        
+        // 上一帧的分配，用于分配迟滞
+        int previous[WallSolution::MAX_DEFENDERS];
+        for (int s = 0; s < WallSolution::MAX_DEFENDERS; s++) {
+            previous[s] = s < wall.count ? wall.robot_id[s] : -1;
+        }
+        
+        if (DefenseWall::solve(ball_pos, goalie_pos, has_goalie, WALL_SIZE, wall)) {
+            DefenseWall::assign(world_model, ids, n, wall, previous);
+        }
+    }
+    
+    WallSolution wall;      // 本帧的人墙站位
+    int wall_cycle;         // 人墙求解的周期
 };
 
 #endif // DEFENSE_TACTICS_H 
\ No newline at end of file
@@ -0,0 +1,340 @@
+#ifndef DEFENSE_WALL_H
+#define DEFENSE_WALL_H
+
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include "../utils/worldmodel.h"
+#include "../utils/constants.h"
+#include "../utils/field_geometry.h"
+#include "../utils/vector.h"
+#include "../utils/maths.h"
+
+/**
+ * @brief 人墙求解结果
+ */
+struct WallSolution {
+    static const int MAX_DEFENDERS = 4;
+
+    int count;                              // 需要的防守球员数量（全部封住后多余的球员不计入）
+    point2f pos[MAX_DEFENDERS];             // 站位，沿射门方向从一侧到另一侧排列
+    double angle[MAX_DEFENDERS];            // 站位对应的射门方向（相对射手到球门中心的方向）
+    int robot_id[MAX_DEFENDERS];            // 分配的球员，-1表示未分配
+    double uncovered;                       // 未被守门员和人墙挡住的球门角度比例(0~1)
+    double solve_us;                        // 求解耗时(微秒)
+
+    WallSolution() : count(0), uncovered(1.0), solve_us(0.0) {
+        for (int i = 0; i < MAX_DEFENDERS; i++) {
+            angle[i] = 0.0;
+            robot_id[i] = -1;
+        }
+    }
+
+    /**
+     * @brief 查找分配给某个球员的站位
+     * @return 该球员不在人墙中时返回-1
+     */
+    int slotOf(int id) const {
+        for (int i = 0; i < count; i++) {
+            if (robot_id[i] == id) return i;
+        }
+        return -1;
+    }
+};
+
+/**
+ * @brief 多人封堵射门的人墙求解器
+ * 从射手看球门是一段角度区间，扣除守门员挡住的部分后剩下至多两段空隙。
+ * 每个防守球员站在禁区边界外侧（D形区域向外扩一个车身）的射门线上，能挡住一小段角度；
+ * 在每段空隙上从靠近守门员的一端开始贪心地做区间覆盖，得到使未覆盖角度最小的k个站位。
+ * 然后枚举球员与站位的对应关系，选总移动时间最短的分配。
+ */
+class DefenseWall {
+public:
+    static constexpr double STAND_OFF = MAX_ROBOT_SIZE + 5.0;                   // 站位离禁区边界的距离(cm)
+    static constexpr double ROBOT_SPEED = 250.0;                                // 机器人平均移动速度(cm/s)
+    static constexpr double SWITCH_MARGIN = 0.3;                                // 新分配的总移动时间至少短这么多才换人(s)
+
+    /**
+     * @brief 计算人墙站位
+     * @param shooter 射手（或球）的位置
+     * @param goalie_pos 守门员位置
+     * @param has_goalie 守门员是否在场
+     * @param k 最多使用的防守球员数量
+     * @param out 求解结果，不做球员分配
+     * @return 射手在禁区扩展区域内（无法在其前方站位）时返回false
+     */
+    static bool solve(const point2f& shooter, const point2f& goalie_pos, bool has_goalie, int k, WallSolution& out) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        out = WallSolution();
+        k = std::max(0, std::min(k, static_cast<int>(WallSolution::MAX_DEFENDERS)));
+
+        bool ok = solveAngles(shooter, goalie_pos, has_goalie, k, out);
+
+        out.solve_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        return ok;
+    }
+
+    /**
+     * @brief 把站位分配给球员，使总移动时间最短
+     * 给出上一帧的分配时，只有新分配的总移动时间比沿用上一帧分配短SWITCH_MARGIN以上才换人，
+     * 避免两个球员到站位的时间接近时每帧来回交换。
+     * @param model 世界模型指针
+     * @param ids 候选球员ID
+     * @param n 候选球员数量
+     * @param wall 人墙，写入robot_id；候选球员少于站位时，多出的站位保持未分配
+     * @param previous 上一帧各站位分配的球员（按站位顺序，-1表示未分配），为空时不做迟滞
+     */
+    static void assign(const WorldModel* model, const int* ids, int n, WallSolution& wall,
+                       const int* previous = nullptr) {
+        n = std::min(n, static_cast<int>(MAX_TEAM_ROBOTS));
+        double cost[WallSolution::MAX_DEFENDERS][MAX_TEAM_ROBOTS];
+        for (int s = 0; s < wall.count; s++) {
+            for (int r = 0; r < n; r++) {
+                cost[s][r] = (model->get_our_player_pos(ids[r]) - wall.pos[s]).length() / ROBOT_SPEED;
+            }
+        }
+
+        int current[WallSolution::MAX_DEFENDERS];
+        int best[WallSolution::MAX_DEFENDERS];
+        double best_cost = 1e9;
+        for (int s = 0; s < WallSolution::MAX_DEFENDERS; s++) {
+            best[s] = -1;
+        }
+        int slots = std::min(wall.count, n);
+        search(cost, n, slots, 0, 0u, 0.0, current, best, best_cost);
+
+        // 上一帧的分配仍然可用（站位都由仍在候选中的不同球员占据）且不比最优差太多时沿用
+        if (previous && slots > 0) {
+            int kept[WallSolution::MAX_DEFENDERS];
+            double kept_cost = 0.0;
+            unsigned int used = 0u;
+            bool valid = true;
+            for (int s = 0; s < slots && valid; s++) {
+                kept[s] = -1;
+                for (int r = 0; r < n; r++) {
+                    if (ids[r] == previous[s]) kept[s] = r;
+                }
+                valid = kept[s] >= 0 && !(used & (1u << kept[s]));
+                if (valid) {
+                    used |= 1u << kept[s];
+                    kept_cost += cost[s][kept[s]];
+                }
+            }
+            if (valid && kept_cost <= best_cost + SWITCH_MARGIN) {
+                for (int s = 0; s < slots; s++) best[s] = kept[s];
+            }
+        }
+
+        for (int s = 0; s < wall.count; s++) {
+            wall.robot_id[s] = (s < slots && best[s] >= 0) ? ids[best[s]] : -1;
+        }
+    }
+
+private:
+    /**
+     * @brief 球心离车心小于该距离就会被挡住(cm)
+     */
+    static double blockRadius() {
+        return MAX_ROBOT_SIZE + BALL_SIZE * 0.5;
+    }
+
+    /**
+     * @brief 相对于射手到球门中心方向的角度
+     */
+    static double relAngle(const point2f& shooter, const point2f& p, double base) {
+        return Maths::normalize(atan2(p.y - shooter.y, p.x - shooter.x) - base);
+    }
+
+    /**
+     * @brief 射线与禁区扩展区域边界的第一个交点距离；扩展区域是到禁区矩形距离小于R的点集（老场地矩形深度为0，即D形）
+     * @return 射线不与边界相交或起点已在区域内时返回负值
+     */
+    static double rayToBoundary(const point2f& s, double dx, double dy) {
+        const double R = Field::DEFENSE_RADIUS + STAND_OFF;
+        const double gx = -Field::LENGTH_H;
+        const double depth = Field::DEFENSE_DEPTH;
+        const double half = Field::DEFENSE_WIDTH_H;
+
+        double best = -1.0;
+        // 正面直线部分 x = gx + depth + R, |y| <= half
+        if (fabs(dx) > 1e-9) {
+            double t = (gx + depth + R - s.x) / dx;
+            double y = s.y + t * dy;
+            if (t > 0 && fabs(y) <= half) best = t;
+        }
+        // 两侧直线部分 y = ±(half + R), gx <= x <= gx + depth，矩形深度为0时不存在
+        if (depth > 0 && fabs(dy) > 1e-9) {
+            for (int side = -1; side <= 1; side += 2) {
+                double t = (side * (half + R) - s.y) / dy;
+                double x = s.x + t * dx;
+                if (t > 0 && x >= gx && x <= gx + depth && (best < 0 || t < best)) best = t;
+            }
+        }
+        // 两角的圆弧，圆心为禁区矩形靠场内的两个角
+        for (int side = -1; side <= 1; side += 2) {
+            double cx = gx + depth, cy = side * half;
+            double fx = s.x - cx, fy = s.y - cy;
+            double b = fx * dx + fy * dy;
+            double c = fx * fx + fy * fy - R * R;
+            double disc = b * b - c;
+            if (c <= 0 || disc < 0) continue;
+            double t = -b - sqrt(disc);
+            double y = s.y + t * dy;
+            if (t > 0 && side * y >= half && (best < 0 || t < best)) best = t;
+        }
+        return best;
+    }
+
+    /**
+     * @brief 射线方向上的站位及其挡住的半角
+     */
+    static bool standPoint(const point2f& shooter, double base, double theta, point2f& pos, double& half_width) {
+        double dx = cos(base + theta), dy = sin(base + theta);
+        double t = rayToBoundary(shooter, dx, dy);
+        if (t <= blockRadius()) return false;
+        pos = point2f(shooter.x + t * dx, shooter.y + t * dy);
+        half_width = asin(blockRadius() / t);
+        return true;
+    }
+
+    /**
+     * @brief 在空隙[lo, hi]上贪心覆盖；dir为1时从lo向hi推进，为-1时从hi向lo推进
+     * @return 实际覆盖的角度
+     */
+    static double coverGap(const point2f& shooter, double base, double lo, double hi, int dir,
+                           int budget, WallSolution& out) {
+        double covered = 0.0;
+        double cur = (dir > 0) ? lo : hi;
+        while (budget > 0 && (dir > 0 ? cur < hi : cur > lo)) {
+            // 站位的挡住宽度随距离变化，迭代几次求出恰好贴着cur的方向
+            point2f pos;
+            double h = 0.0, theta = cur;
+            for (int it = 0; it < 3; it++) {
+                if (!standPoint(shooter, base, theta, pos, h)) return covered;
+                theta = cur + dir * h;
+            }
+            // 整段空隙比一个人窄时放在正中；否则限制在空隙内，最后一人贴着空隙末端，与已覆盖部分重叠
+            if (2 * h >= hi - lo) theta = 0.5 * (lo + hi);
+            else theta = std::min(std::max(theta, lo + h), hi - h);
+            if (!standPoint(shooter, base, theta, pos, h)) return covered;
+
+            double next = theta + dir * h;
+            covered += (dir > 0) ? std::min(next, hi) - cur : cur - std::max(next, lo);
+            cur = next;
+
+            out.pos[out.count] = pos;
+            out.angle[out.count] = theta;
+            out.count++;
+            budget--;
+        }
+        return covered;
+    }
+
+    /**
+     * @brief 统计覆盖空隙所需人数
+     */
+    static int countNeeded(const point2f& shooter, double base, double lo, double hi, int dir) {
+        WallSolution probe;
+        coverGap(shooter, base, lo, hi, dir, WallSolution::MAX_DEFENDERS, probe);
+        return probe.count;
+    }
+
+    static bool solveAngles(const point2f& shooter, const point2f& goalie_pos, bool has_goalie, int k, WallSolution& out) {
+        const point2f goal_center(-FIELD_LENGTH_H, 0);
+        double base = atan2(goal_center.y - shooter.y, goal_center.x - shooter.x);
+        if (rayToBoundary(shooter, cos(base), sin(base)) < 0) {
+            return false;
+        }
+
+        double a = relAngle(shooter, point2f(-FIELD_LENGTH_H, -GOAL_WIDTH_H), base);
+        double b = relAngle(shooter, point2f(-FIELD_LENGTH_H, GOAL_WIDTH_H), base);
+        double lo = std::min(a, b), hi = std::max(a, b);
+        double total = hi - lo;
+        if (total <= 1e-6) {
+            out.uncovered = 0.0;
+            return true;
+        }
+
+        // 1. 扣除守门员挡住的角度，得到至多两段空隙；靠近守门员的一端为覆盖起点
+        double gap_lo[2], gap_hi[2];
+        int gap_dir[2];
+        int gaps = 0;
+        double shadow_lo = hi, shadow_hi = hi;
+        if (has_goalie) {
+            double d = (goalie_pos - shooter).length();
+            if (d > blockRadius()) {
+                double g = relAngle(shooter, goalie_pos, base);
+                double h = asin(blockRadius() / d);
+                shadow_lo = std::max(g - h, lo);
+                shadow_hi = std::min(g + h, hi);
+                if (shadow_lo >= shadow_hi) shadow_lo = shadow_hi = hi;
+            }
+        }
+        if (shadow_lo > lo) {
+            gap_lo[gaps] = lo; gap_hi[gaps] = shadow_lo; gap_dir[gaps] = (shadow_lo < hi) ? -1 : 1; gaps++;
+        }
+        if (shadow_hi < hi && shadow_lo < hi) {
+            gap_lo[gaps] = shadow_hi; gap_hi[gaps] = hi; gap_dir[gaps] = 1; gaps++;
+        }
+
+        // 2. 人数不够时先覆盖较宽的空隙
+        if (gaps == 2 && gap_hi[1] - gap_lo[1] > gap_hi[0] - gap_lo[0]) {
+            std::swap(gap_lo[0], gap_lo[1]);
+            std::swap(gap_hi[0], gap_hi[1]);
+            std::swap(gap_dir[0], gap_dir[1]);
+        }
+        int need[2] = {0, 0};
+        for (int i = 0; i < gaps; i++) {
+            need[i] = countNeeded(shooter, base, gap_lo[i], gap_hi[i], gap_dir[i]);
+        }
+        int give0 = std::min(need[0], k);
+        int give1 = std::min(need[1], k - give0);
+        if (gaps == 2 && give1 == 0 && give0 > 1 && need[1] > 0) {
+            // 宽空隙已无法完全封住时，仍留一人给另一段以减少未覆盖角度
+            double w0 = gap_hi[0] - gap_lo[0], w1 = gap_hi[1] - gap_lo[1];
+            if (w1 > w0 / need[0]) {
+                give0--;
+                give1 = 1;
+            }
+        }
+
+        double covered = 0.0;
+        int budget[2] = {give0, give1};
+        for (int i = 0; i < gaps; i++) {
+            covered += coverGap(shooter, base, gap_lo[i], gap_hi[i], gap_dir[i], budget[i], out);
+        }
+
+        double shadow = std::max(0.0, shadow_hi - shadow_lo);
+        out.uncovered = std::max(0.0, (total - shadow - covered) / total);
+
+        // 3. 按角度排序，便于站位从一侧排到另一侧
+        for (int i = 1; i < out.count; i++) {
+            for (int j = i; j > 0 && out.angle[j] < out.angle[j - 1]; j--) {
+                std::swap(out.angle[j], out.angle[j - 1]);
+                std::swap(out.pos[j], out.pos[j - 1]);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 枚举站位与球员的对应关系
+     */
+    static void search(const double cost[][MAX_TEAM_ROBOTS], int n, int slots, int slot, unsigned int used,
+                       double sum, int* current, int* best, double& best_cost) {
+        if (sum >= best_cost) return;
+        if (slot == slots) {
+            best_cost = sum;
+            for (int s = 0; s < slots; s++) best[s] = current[s];
+            return;
+        }
+        for (int r = 0; r < n; r++) {
+            if (used & (1u << r)) continue;
+            current[slot] = r;
+            search(cost, n, slots, slot + 1, used | (1u << r), sum + cost[slot][r], current, best, best_cost);
+        }
+    }
+};
+
+#endif // DEFENSE_WALL_H
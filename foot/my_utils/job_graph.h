@@ -0,0 +1,323 @@
+#ifndef JOB_GRAPH_H
+#define JOB_GRAPH_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class JobGraph;
+
+/**
+ * @brief 单个作业的计时统计
+ */
+struct JobStats {
+    unsigned long long runs;        // 执行次数
+    unsigned long long total_ns;    // 累计耗时(纳秒)
+    unsigned long long max_ns;      // 单次最大耗时(纳秒)
+    unsigned long long last_ns;     // 最近一次耗时(纳秒)
+    int last_worker;                // 最近一次执行所在的线程，0为调用run的线程
+
+    JobStats() : runs(0), total_ns(0), max_ns(0), last_ns(0), last_worker(0) {}
+};
+
+/**
+ * @brief 工作窃取线程池
+ * 每个线程一个双端队列：线程从自己队列的尾部取作业，空闲时从其他线程队列的头部窃取。
+ * 下标0的队列属于调用JobGraph::run的线程，它在等待期间同样执行作业；
+ * 同一时刻只能有一个作业图在池上运行。没有作业图运行时工作线程休眠，不占用CPU。
+ */
+class JobPool {
+public:
+    /**
+     * @brief 创建线程池
+     * @param workers 额外的工作线程数，0表示不启动线程（作业图退化为串行执行）
+     */
+    explicit JobPool(int workers) : queues(workers + 1) {
+        for (int i = 0; i < workers; i++) {
+            threads.emplace_back(&JobPool::workerLoop, this, i + 1);
+        }
+    }
+
+    ~JobPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        sleep_cv.notify_all();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    /**
+     * @brief 工作线程数（不含调用线程）
+     */
+    int workerCount() const { return static_cast<int>(threads.size()); }
+
+private:
+    friend class JobGraph;
+
+    struct Task {
+        JobGraph* graph;
+        int job;
+    };
+
+    // 每个线程的作业队列，放在不同的缓存行避免伪共享
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void push(int worker, const Task& task) {
+        WorkQueue& q = queues[worker];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(task);
+    }
+
+    // 从自己的队列尾部取，后进先出，刚解锁的后继作业数据还在缓存中
+    bool pop(int worker, Task& task) {
+        WorkQueue& q = queues[worker];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) {
+            return false;
+        }
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        return true;
+    }
+
+    // 从其他线程的队列头部窃取，从下一个线程开始轮询，避免所有线程挤在同一个队列上
+    bool steal(int worker, Task& task) {
+        int n = static_cast<int>(queues.size());
+        for (int k = 1; k < n; k++) {
+            WorkQueue& q = queues[(worker + k) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.tasks.empty()) {
+                task = q.tasks.front();
+                q.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool next(int worker, Task& task) {
+        return pop(worker, task) || steal(worker, task);
+    }
+
+    // 作业图开始运行时唤醒工作线程，运行期间工作线程让出CPU轮询，结束后重新休眠
+    void begin() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            active = true;
+        }
+        sleep_cv.notify_all();
+    }
+
+    void end() {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        active = false;
+    }
+
+    void workerLoop(int worker);
+
+    std::vector<WorkQueue> queues;
+    std::vector<std::thread> threads;
+    std::mutex graph_mutex;             // 保证同一时刻只有一个作业图在运行
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+    bool active = false;
+    bool stopping = false;
+};
+
+/**
+ * @brief 帧内作业图
+ * 每个作业声明它依赖的作业，依赖只能指向先添加的作业，因此添加顺序就是一个合法的拓扑序。
+ * 不带线程池（或线程池没有工作线程）运行时按添加顺序串行执行，结果确定、便于调试和回放；
+ * 带线程池运行时没有依赖关系的作业并行执行，一个作业完成后其后继作业进入当前线程的队列。
+ * 作业抛出的第一个异常在整个图执行完后由run重新抛出。
+ */
+class JobGraph {
+public:
+    typedef int JobId;
+    typedef std::function<void()> JobFn;
+
+    JobGraph() : remaining(0) {}
+
+    JobGraph(const JobGraph&) = delete;
+    JobGraph& operator=(const JobGraph&) = delete;
+
+    /**
+     * @brief 添加作业
+     * @param name 作业名称，用于计时报告
+     * @param fn 作业函数
+     * @param deps 依赖的作业，须已添加
+     * @return 作业ID，添加失败（依赖不存在）时返回-1
+     */
+    JobId addJob(const std::string& name, JobFn fn, std::initializer_list<JobId> deps = {}) {
+        JobId id = static_cast<JobId>(jobs.size());
+        for (JobId dep : deps) {
+            if (dep < 0 || dep >= id) {
+                return -1;
+            }
+        }
+        std::unique_ptr<Job> job(new Job());
+        job->name = name;
+        job->fn = std::move(fn);
+        job->dep_count = static_cast<int>(deps.size());
+        for (JobId dep : deps) {
+            jobs[dep]->successors.push_back(id);
+        }
+        jobs.push_back(std::move(job));
+        return id;
+    }
+
+    /**
+     * @brief 执行整个作业图，返回时所有作业都已完成
+     * @param pool 线程池，为空时串行执行
+     */
+    void run(JobPool* pool = nullptr) {
+        error = nullptr;
+        if (!pool || pool->workerCount() == 0) {
+            // 串行模式：按添加顺序执行
+            for (size_t i = 0; i < jobs.size(); i++) {
+                execute(static_cast<JobId>(i), 0);
+            }
+        } else {
+            runParallel(*pool);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief 作业数量
+     */
+    int size() const { return static_cast<int>(jobs.size()); }
+
+    const std::string& getName(JobId id) const { return jobs[id]->name; }
+    const JobStats& getStats(JobId id) const { return jobs[id]->stats; }
+
+    /**
+     * @brief 生成计时报告，便于输出到日志
+     * @return 每个作业一行的报告
+     */
+    std::string report() const {
+        std::string out;
+        for (const std::unique_ptr<Job>& job : jobs) {
+            const JobStats& s = job->stats;
+            double avg_us = s.runs ? s.total_ns / 1000.0 / s.runs : 0.0;
+            out += job->name +
+                   " runs=" + std::to_string(s.runs) +
+                   " avg=" + std::to_string(avg_us) + "us" +
+                   " max=" + std::to_string(s.max_ns / 1000.0) + "us" +
+                   " worker=" + std::to_string(s.last_worker) + "\n";
+        }
+        return out;
+    }
+
+private:
+    friend class JobPool;
+    typedef std::chrono::steady_clock Clock;
+
+    struct Job {
+        std::string name;
+        JobFn fn;
+        int dep_count = 0;
+        std::vector<JobId> successors;
+        std::atomic<int> pending{0};    // 本次运行中尚未完成的依赖数
+        JobStats stats;                 // 每次运行只由执行该作业的线程写入
+    };
+
+    void execute(JobId id, int worker) {
+        Job& job = *jobs[id];
+        Clock::time_point start = Clock::now();
+        try {
+            job.fn();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        unsigned long long ns = static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        job.stats.runs++;
+        job.stats.total_ns += ns;
+        job.stats.last_ns = ns;
+        if (ns > job.stats.max_ns) job.stats.max_ns = ns;
+        job.stats.last_worker = worker;
+    }
+
+    // 执行一个作业并把就绪的后继作业放入当前线程的队列
+    void runTask(JobPool& pool, JobId id, int worker) {
+        execute(id, worker);
+        for (JobId next : jobs[id]->successors) {
+            if (jobs[next]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                pool.push(worker, JobPool::Task{this, next});
+            }
+        }
+        remaining.fetch_sub(1, std::memory_order_release);
+    }
+
+    void runParallel(JobPool& pool) {
+        std::lock_guard<std::mutex> lock(pool.graph_mutex);
+        remaining.store(static_cast<int>(jobs.size()), std::memory_order_relaxed);
+        for (const std::unique_ptr<Job>& job : jobs) {
+            job->pending.store(job->dep_count, std::memory_order_relaxed);
+        }
+        // 没有依赖的作业倒序放入，调用线程从尾部取时按添加顺序开始
+        for (size_t i = jobs.size(); i-- > 0;) {
+            if (jobs[i]->dep_count == 0) {
+                pool.push(0, JobPool::Task{this, static_cast<JobId>(i)});
+            }
+        }
+        pool.begin();
+        JobPool::Task task;
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (pool.next(0, task)) {
+                runTask(pool, task.job, 0);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        pool.end();
+    }
+
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::atomic<int> remaining;         // 本次运行中尚未完成的作业数
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+inline void JobPool::workerLoop(int worker) {
+    Task task;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleep_cv.wait(lock, [this] { return active || stopping; });
+            if (stopping) {
+                return;
+            }
+        }
+        while (next(worker, task)) {
+            task.graph->runTask(*this, task.job, worker);
+        }
+        std::this_thread::yield();
+    }
+}
+
+#endif // JOB_GRAPH_H
@@ -31,19 +31,28 @@ enum class LogLevel {
 };
 
 /**
- * @brief 日志记录工具类，单例模式
+ * @brief 日志记录工具类
+ * getInstance()为进程内的默认实例（LOG_*宏使用，只用于旧的单机器人入口），PlannerContext各自持有独立的实例，
+ * 上下文中的战术和通信通过持有的Logger指针写日志
  */
 class Logger {
 public:
     /**
-     * @brief 获取单例实例
-     * @return Logger单例
+     * @brief 获取默认实例
+     * @return 默认Logger
      */
     static Logger& getInstance() {
         static Logger instance;
         return instance;
     }
     
+    Logger() : current_level(LogLevel::INFO), file_logging(false), debug_output_enabled(true) {}
+    ~Logger() {
+        if (log_file.is_open()) {
+            log_file.close();
+        }
+    }
+    
     /**
      * @brief 设置日志级别
      * @param level 日志级别
@@ -231,13 +240,6 @@ public:
     }
 
 private:
-    Logger() : current_level(LogLevel::INFO), file_logging(false), debug_output_enabled(true) {}
-    ~Logger() {
-        if (log_file.is_open()) {
-            log_file.close();
-        }
-    }
-    
     // 禁止拷贝和赋值
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
@@ -4,16 +4,14 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
-#include <chrono>
-#include <deque>
 #include "../utils/WorldModel.h"
 #include "../utils/constants.h"
 #include "../utils/vector.h"
 #include "../utils/maths.h"
 #include "ball_tools.h"
+#include "team_state.h"
 
 // 常量定义
-#define OPP_HISTORY_SIZE 10          // 对手历史数据记录大小
 #define OPP_BALL_CONTROL_THRESHOLD 50.0  // 对手球控制阈值(mm)
 #define MAX_THREAT_LEVEL 10.0        // 最大威胁等级
 
@@ -31,10 +29,7 @@ public:
     bool isActive;                  // 是否激活/存在
     bool hasBall;                   // 是否持球
     double threatLevel;             // 威胁等级 (0-10)
-    
-    // 历史数据
-    std::deque<point2f> positionHistory;  // 位置历史
-    point2f lastPosition;                 // 上一帧位置
+    point2f lastPosition;           // 上一帧位置
     
     /**
      * @brief 构造函数
@@ -49,21 +44,7 @@ public:
         isActive(false),
         hasBall(false),
         threatLevel(0),
-        lastPosition(0, 0) {
-        
-        // 初始化历史数据队列
-        for (int i = 0; i < OPP_HISTORY_SIZE; i++) {
-            positionHistory.push_back(point2f(0, 0));
-        }
-    }
-    
-    /**
-     * @brief 更新历史数据
-     */
-    void updateHistory() {
-        positionHistory.pop_back();
-        positionHistory.push_front(position);
-    }
+        lastPosition(0, 0) {}
     
     /**
      * @brief 获取前进方向的单位向量
@@ -139,75 +120,48 @@ public:
      * @brief 构造函数
      * @param model 世界模型指针
      * @param ballTools 球工具类引用
+     * @param teamState 对方队伍状态，由所属的PlannerContext提供
      */
-    OppPlayers(const WorldModel* model, BallTools& ballTools) : 
+    OppPlayers(const WorldModel* model, BallTools& ballTools, OppTeamState& teamState) : 
         model(model),
         ball(ballTools),
+        state(teamState),
         opponentCount(0) {
         
+        players.reserve(MAX_TEAM_ROBOTS);
         updateState();
-        last_update_time = std::chrono::high_resolution_clock::now();
     }
     
     /**
      * @brief 更新所有对手状态
-     * 每周期调用此函数更新信息
+     * 每周期调用此函数更新信息，位置、速度和历史由OppTeamState每帧统一更新一次
      */
     void updateState() {
-        auto current_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - last_update_time).count();
-        double dt = duration / 1000.0; // 转换为秒
+        state.update(model);
         
-        // 获取所有对手存在信息
-        const bool* exists = model->get_opp_exist_id();
-        int goalieId = model->get_opp_goalie();
+        // 场上对手集合（包括守门员），players按车号从小到大排列，下标即rank
+        ids = state.robots();
+        holders = state.ballHolders(ids, OPP_BALL_CONTROL_THRESHOLD);
         
-        // 清空并重新填充对手信息
         players.clear();
         opponentCount = 0;
         
-        // 遍历所有可能的对手
-        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-            // 排除不存在的球员和守门员(如果需要排除)
-            if (exists[i] /*&& i != goalieId*/) {
-                OppPlayer opponent(i);
-                opponent.isActive = true;
-                
-                // 更新基本信息
-                opponent.position = model->get_opp_player_pos(i);
-                opponent.velocity = model->get_opp_player_v(i);
-                opponent.orientation = model->get_opp_player_dir(i);
-                opponent.speed = opponent.velocity.length();
-                
-                // 保存上一帧数据（如果有）
-                if (opponentCount < oldOpponents.size() && oldOpponents[opponentCount].id == i) {
-                    opponent.lastPosition = oldOpponents[opponentCount].position;
-                } else {
-                    opponent.lastPosition = opponent.position;
-                }
-                
-                // 更新历史数据
-                opponent.updateHistory();
-                
-                // 检查是否持球
-                double dist = (ball.position - opponent.position).length();
-                double angle_diff = fabs(anglemod((ball.position - opponent.position).angle() - opponent.orientation));
-                opponent.hasBall = (dist < OPP_BALL_CONTROL_THRESHOLD && angle_diff < M_PI/4);
-                
-                // 计算威胁等级
-                updateThreatLevel(opponent);
-                
-                // 添加到对手列表
-                players.push_back(opponent);
-                opponentCount++;
-            }
+        for (int i : ids) {
+            OppPlayer opponent(i);
+            opponent.isActive = true;
+            opponent.position = state.position(i);
+            opponent.velocity = state.velocity(i);
+            opponent.orientation = state.orientation(i);
+            opponent.speed = state.speedOf(i);
+            opponent.lastPosition = state.lastPosition(i);
+            opponent.hasBall = holders.contains(i);
+            
+            // 计算威胁等级
+            updateThreatLevel(opponent);
+            
+            players.push_back(opponent);
+            opponentCount++;
         }
-        
-        // 保存当前对手信息用于下一次更新
-        oldOpponents = players;
-        
-        // 更新时间
-        last_update_time = current_time;
     }
     
     /**
@@ -216,12 +170,8 @@ public:
      * @return 对手对象的引用，如果找不到则返回默认对象
      */
     const OppPlayer& getOpponent(int id) const {
-        for (const auto& opponent : players) {
-            if (opponent.id == id) {
-                return opponent;
-            }
-        }
-        return defaultOpponent;
+        int index = ids.rank(id);
+        return index < 0 ? defaultOpponent : players[index];
     }
     
     /**
@@ -229,22 +179,7 @@ public:
      * @return 最接近球的对手，如果没有则返回默认对象
      */
     const OppPlayer& getClosestToBall() const {
-        if (players.empty()) {
-            return defaultOpponent;
-        }
-        
-        double minDist = 9999.0;
-        int closestIndex = 0;
-        
-        for (size_t i = 0; i < players.size(); i++) {
-            double dist = players[i].distanceTo(ball.position);
-            if (dist < minDist) {
-                minDist = dist;
-                closestIndex = i;
-            }
-        }
-        
-        return players[closestIndex];
+        return getOpponent(state.closestToBall(ids));
     }
     
     /**
@@ -253,22 +188,7 @@ public:
      * @return 最接近的对手，如果没有则返回默认对象
      */
     const OppPlayer& getClosestToPosition(const point2f& pos) const {
-        if (players.empty()) {
-            return defaultOpponent;
-        }
-        
-        double minDist = 9999.0;
-        int closestIndex = 0;
-        
-        for (size_t i = 0; i < players.size(); i++) {
-            double dist = players[i].distanceTo(pos);
-            if (dist < minDist) {
-                minDist = dist;
-                closestIndex = i;
-            }
-        }
-        
-        return players[closestIndex];
+        return getOpponent(state.closestTo(ids, pos));
     }
     
     /**
@@ -276,19 +196,10 @@ public:
      * @return 最小距离，如果没有对手则返回MAX_DISTANCE
      */
     double getClosestDistanceToBall() const {
-        if (players.empty()) {
+        float minDist = 9999.0f;
+        if (state.closestToBall(ids, &minDist) < 0) {
             return 9999.0; // 最大距离
         }
-        
-        double minDist = 9999.0;
-        
-        for (const auto& opponent : players) {
-            double dist = opponent.distanceTo(ball.position);
-            if (dist < minDist) {
-                minDist = dist;
-            }
-        }
-        
         return minDist;
     }
     
@@ -297,12 +208,7 @@ public:
      * @return 持球对手，如果没有则返回默认对象
      */
     const OppPlayer& getBallHolder() const {
-        for (const auto& opponent : players) {
-            if (opponent.hasBall) {
-                return opponent;
-            }
-        }
-        return defaultOpponent;
+        return getOpponent(holders.first());
     }
     
     /**
@@ -310,12 +216,7 @@ public:
      * @return 是否有对手持球
      */
     bool hasOpponentBall() const {
-        for (const auto& opponent : players) {
-            if (opponent.hasBall) {
-                return true;
-            }
-        }
-        return false;
+        return !holders.empty();
     }
     
     /**
@@ -325,22 +226,21 @@ public:
     bool hasOpponent() const {
         return !players.empty();
     }
-    
+
+    /**
+     * @brief 获取场上对手ID集合
+     * @return 对手ID集合，可直接用for遍历，不分配内存
+     */
+    RobotSet getPlayerIds() const {
+        return ids;
+    }
+
     /**
      * @brief 计算对手的平均位置
      * @return 平均位置
      */
     point2f getAveragePosition() const {
-        if (players.empty()) {
-            return point2f(0, 0);
-        }
-        
-        point2f sum(0, 0);
-        for (const auto& opponent : players) {
-            sum = sum + opponent.position;
-        }
-        
-        return sum / static_cast<float>(players.size());
+        return state.centroid(ids);
     }
     
     /**
@@ -387,15 +287,7 @@ public:
      * @return 在我方半场的对手数量
      */
     int getCountInOurHalf() const {
-        int count = 0;
-        
-        for (const auto& opponent : players) {
-            if (opponent.isInOurHalf()) {
-                count++;
-            }
-        }
-        
-        return count;
+        return state.inOurHalf(ids).size();
     }
     
     /**
@@ -403,15 +295,7 @@ public:
      * @return 在对方半场的对手数量
      */
     int getCountInOpponentHalf() const {
-        int count = 0;
-        
-        for (const auto& opponent : players) {
-            if (opponent.isInOpponentHalf()) {
-                count++;
-            }
-        }
-        
-        return count;
+        return state.inOppHalf(ids).size();
     }
     
     /**
@@ -419,12 +303,7 @@ public:
      * @return 是否有对手在我方禁区
      */
     bool isOpponentInOurPenaltyArea() const {
-        for (const auto& opponent : players) {
-            if (opponent.isInOurPenaltyArea()) {
-                return true;
-            }
-        }
-        return false;
+        return !state.inOurDefense(ids).empty();
     }
     
     /**
@@ -468,12 +347,11 @@ public:
 private:
     const WorldModel* model;
     BallTools& ball;
-    std::vector<OppPlayer> oldOpponents;  // 上一帧的对手信息
+    OppTeamState& state;                  // 对手的逐帧共享状态
+    RobotSet ids;                         // 本次更新时场上的对手
+    RobotSet holders;                     // 本次更新时持球的对手
     OppPlayer defaultOpponent;            // 默认对手对象，用于找不到时返回
     
-    // 上次更新时间
-    std::chrono::time_point<std::chrono::high_resolution_clock> last_update_time;
-    
     /**
      * @brief 更新对手的威胁等级
      * @param opponent 待更新的对手对象
@@ -0,0 +1,292 @@
+#ifndef PASS_EVALUATOR_H
+#define PASS_EVALUATOR_H
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include "../utils/worldmodel.h"
+#include "../utils/PlayerTask.h"
+#include "../utils/constants.h"
+#include "../utils/vector.h"
+#include "../utils/maths.h"
+
+/**
+ * @brief 单个传球候选
+ */
+struct PassCandidate {
+    int receiver_id;            // 接球球员
+    point2f target;             // 传球目标点（队友位置或其附近的提前量点）
+    double probability;         // 传球成功概率
+    double reception_time;      // 球到达目标点的时间(s)
+    double kick_speed;          // 出球速度(cm/s)
+    double score;               // 综合评分（成功概率 x 目标点价值）
+
+    PassCandidate() : receiver_id(-1), probability(0.0), reception_time(0.0), kick_speed(0.0), score(-1.0) {}
+};
+
+/**
+ * @brief 基于概率的传球评估器
+ * 对每个队友及其周围采样的提前量点批量计算：按球的减速模型求出球到达路线上各点的时间，
+ * 与每个对手到达该点的时间比较得到拦截余量，再转换为成功概率。
+ * 数据按结构数组(SoA)存放，内层循环无分支，便于编译器向量化，每帧可评估数百个候选。
+ */
+class PassEvaluator {
+public:
+    static const int LEAD_DIRECTIONS = 8;                                   // 提前量点的方向数
+    static const int LEAD_RINGS = 3;                                        // 提前量点的圈数
+    static const int POINTS_PER_RECEIVER = 1 + LEAD_DIRECTIONS * LEAD_RINGS;
+    static const int MAX_CANDIDATES = MAX_ROBOTS * POINTS_PER_RECEIVER;
+
+    static constexpr double BALL_DECEL = 50.0;          // 球滚动减速度(cm/s^2)
+    static constexpr double MAX_KICK_SPEED = 550.0;     // 最大出球速度(cm/s)
+    static constexpr double RECEIVE_SPEED = 150.0;      // 期望到达接球点时的球速(cm/s)
+    static constexpr double ROBOT_SPEED = 250.0;        // 机器人平均移动速度(cm/s)
+    static constexpr double REACTION_TIME = 0.15;       // 对手反应时间(s)
+    static constexpr double MARGIN_SCALE = 0.12;        // 时间余量转换为概率的尺度(s)
+    static constexpr double KICK_SPEED_PER_POWER = 80.0;// 每单位kickPower对应的出球速度(cm/s)
+    static constexpr double LEAD_STEP = 25.0;           // 提前量点每圈的半径(cm)
+
+    explicit PassEvaluator(const WorldModel* model) : world_model(model), count(0), best_index(-1) {}
+
+    /**
+     * @brief 生成并评估从from出发的全部传球候选
+     * @param passer_id 传球球员（不会作为接球者）
+     * @param from 出球位置，一般为球的位置
+     * @return 候选数量
+     */
+    int evaluate(int passer_id, const point2f& from) {
+        count = 0;
+        best_index = -1;
+
+        for (int id : world_model->get_our_field_set() - RobotSet::single(passer_id)) {
+            addReceiverPoints(id, world_model->get_our_player_pos(id));
+        }
+
+        evaluateLanes(from, count, tx, ty, probability, ball_time);
+        scoreCandidates(from);
+        return count;
+    }
+
+    /**
+     * @brief 获取最佳候选
+     * @param out 最佳候选
+     * @return 没有候选时返回false
+     */
+    bool best(PassCandidate& out) const {
+        if (best_index < 0) {
+            return false;
+        }
+        out = candidate(best_index);
+        return true;
+    }
+
+    /**
+     * @brief 获取某个接球者的最佳候选
+     * @param receiver_id 接球球员
+     * @param out 该接球者的最佳候选
+     * @return 没有该接球者的候选时返回false
+     */
+    bool bestFor(int receiver_id, PassCandidate& out) const {
+        int index = -1;
+        for (int i = 0; i < count; i++) {
+            if (receiver[i] == receiver_id && (index < 0 || score[i] > score[index])) {
+                index = i;
+            }
+        }
+        if (index < 0) {
+            return false;
+        }
+        out = candidate(index);
+        return true;
+    }
+
+    /**
+     * @brief 候选数量
+     * @return 候选数量
+     */
+    int size() const {
+        return count;
+    }
+
+    /**
+     * @brief 获取第i个候选
+     * @param i 候选下标
+     * @return 候选
+     */
+    PassCandidate candidate(int i) const {
+        PassCandidate c;
+        c.receiver_id = receiver[i];
+        c.target = point2f(tx[i], ty[i]);
+        c.probability = probability[i];
+        c.reception_time = ball_time[i];
+        c.kick_speed = kick_speed[i];
+        c.score = score[i];
+        return c;
+    }
+
+    /**
+     * @brief 批量计算若干条传球路线的成功概率和球到达终点的时间
+     * 只考虑对手拦截，不考虑接球者能否到位，可供传球网络等模块复用
+     * @param from 出球位置
+     * @param n 路线数量
+     * @param to_x 终点x坐标数组
+     * @param to_y 终点y坐标数组
+     * @param prob 输出：成功概率
+     * @param time 输出：球到达终点的时间(s)
+     * @param full_speed 是否以最大速度出球（射门），否则按期望接球速度出球
+     */
+    void evaluateLanes(const point2f& from, int n, const float* to_x, const float* to_y,
+                       float* prob, float* time, bool full_speed = false) const {
+        n = std::min(n, static_cast<int>(MAX_CANDIDATES));
+        // 1. 每条路线的几何量和出球速度：传球时保证球到达终点时速度不超过RECEIVE_SPEED
+        for (int i = 0; i < n; i++) {
+            float dx = to_x[i] - from.x;
+            float dy = to_y[i] - from.y;
+            float len = std::sqrt(dx * dx + dy * dy);
+            float inv = 1.0f / std::max(len, 1.0f);
+            lane_dx[i] = dx * inv;
+            lane_dy[i] = dy * inv;
+            lane_len[i] = len;
+            float v0 = full_speed ? float(MAX_KICK_SPEED) :
+                       std::sqrt(float(RECEIVE_SPEED * RECEIVE_SPEED) + 2.0f * float(BALL_DECEL) * len);
+            lane_v0[i] = std::min(v0, float(MAX_KICK_SPEED));
+            time[i] = ballTime(lane_v0[i], len);
+            prob[i] = 1.0f;
+        }
+
+        // 2. 逐个对手累乘拦截失败的概率；内层循环无分支
+        const float reach = float(MAX_ROBOT_SIZE + BALL_SIZE);
+        for (int k : world_model->get_opp_set()) {
+            const point2f& opp = world_model->get_opp_player_pos(k);
+            float ox = opp.x - from.x;
+            float oy = opp.y - from.y;
+
+            for (int i = 0; i < n; i++) {
+                // 对手在路线上的投影点（限制在路线范围内）
+                float along = ox * lane_dx[i] + oy * lane_dy[i];
+                along = std::min(std::max(along, 0.0f), lane_len[i]);
+                float px = lane_dx[i] * along - ox;
+                float py = lane_dy[i] * along - oy;
+                float dist = std::sqrt(px * px + py * py);
+
+                // 对手到达投影点的时间与球到达该点的时间之差
+                float opp_time = std::max(dist - reach, 0.0f) / float(ROBOT_SPEED) + float(REACTION_TIME);
+                float t_ball = ballTime(lane_v0[i], along);
+                float margin = opp_time - t_ball;
+
+                prob[i] *= 1.0f / (1.0f + std::exp(-margin / float(MARGIN_SCALE)));
+            }
+        }
+    }
+
+    /**
+     * @brief 按出球速度换算为kickPower
+     * @param speed 出球速度(cm/s)
+     * @return kickPower
+     */
+    static double kickPowerForSpeed(double speed) {
+        return speed / KICK_SPEED_PER_POWER;
+    }
+
+    /**
+     * @brief 按候选生成传球任务
+     * @param ball_pos 球的位置
+     * @param candidate 传球候选
+     * @return 传球任务
+     */
+    static PlayerTask makePassTask(const point2f& ball_pos, const PassCandidate& candidate) {
+        PlayerTask task;
+        task.target_pos = ball_pos;
+        task.orientate = atan2(candidate.target.y - ball_pos.y, candidate.target.x - ball_pos.x);
+        task.needKick = true;
+        task.isPass = true;
+        task.kickPower = kickPowerForSpeed(candidate.kick_speed);
+        return task;
+    }
+
+private:
+    /**
+     * @brief 匀减速模型下球滚过distance所需时间，到不了时返回很大的值
+     */
+    static float ballTime(float v0, float distance) {
+        float disc = v0 * v0 - 2.0f * float(BALL_DECEL) * distance;
+        float stop = (disc <= 0.0f) ? 1.0f : 0.0f;
+        float t = (v0 - std::sqrt(std::max(disc, 0.0f))) / float(BALL_DECEL);
+        return t + stop * 100.0f;
+    }
+
+    /**
+     * @brief 为一个接球者添加队友位置及周围的提前量点
+     */
+    void addReceiverPoints(int id, const point2f& pos) {
+        addPoint(id, pos, pos);
+        for (int ring = 1; ring <= LEAD_RINGS; ring++) {
+            for (int d = 0; d < LEAD_DIRECTIONS; d++) {
+                double angle = 2.0 * M_PI * d / LEAD_DIRECTIONS;
+                point2f p(pos.x + LEAD_STEP * ring * cos(angle), pos.y + LEAD_STEP * ring * sin(angle));
+                addPoint(id, pos, p);
+            }
+        }
+    }
+
+    void addPoint(int id, const point2f& receiver_pos, const point2f& p) {
+        if (count >= MAX_CANDIDATES) return;
+        // 场外和双方禁区内的点不能作为接球点
+        if (fabs(p.x) > FIELD_LENGTH_H - 10 || fabs(p.y) > FIELD_WIDTH_H - 10) return;
+        if (Maths::is_inside_penatly(p) || Maths::is_inside_penatly(point2f(-p.x, p.y))) return;
+        receiver[count] = id;
+        tx[count] = p.x;
+        ty[count] = p.y;
+        rx[count] = receiver_pos.x;
+        ry[count] = receiver_pos.y;
+        count++;
+    }
+
+    /**
+     * @brief 叠加接球者到位概率和目标点价值，得到综合评分
+     */
+    void scoreCandidates(const point2f& from) {
+        const float goal_x = float(FIELD_LENGTH_H);
+        best_index = -1;
+        for (int i = 0; i < count; i++) {
+            // 接球者需要在球到达前到位
+            float mx = tx[i] - rx[i];
+            float my = ty[i] - ry[i];
+            float move_time = std::sqrt(mx * mx + my * my) / float(ROBOT_SPEED);
+            float p_recv = 1.0f / (1.0f + std::exp(-(ball_time[i] - move_time) / float(MARGIN_SCALE)));
+            probability[i] *= p_recv;
+
+            // 目标点价值：越靠近对方球门越好，太短的传球价值低
+            float gx = goal_x - tx[i];
+            float gy = ty[i];
+            float to_goal = std::sqrt(gx * gx + gy * gy);
+            float value = 1.0f - std::min(to_goal / float(FIELD_LENGTH), 1.0f);
+            float short_pass = (lane_len[i] < 50.0f) ? 0.5f : 1.0f;
+
+            kick_speed[i] = lane_v0[i];
+            score[i] = probability[i] * (0.5f + 0.5f * value) * short_pass - 0.05f * ball_time[i];
+            if (best_index < 0 || score[i] > score[best_index]) {
+                best_index = i;
+            }
+        }
+    }
+
+    const WorldModel* world_model;
+    int count;
+    int best_index;
+
+    // 候选数据（结构数组）
+    int receiver[MAX_CANDIDATES];
+    float tx[MAX_CANDIDATES], ty[MAX_CANDIDATES];     // 目标点
+    float rx[MAX_CANDIDATES], ry[MAX_CANDIDATES];     // 接球者当前位置
+    float probability[MAX_CANDIDATES];
+    float ball_time[MAX_CANDIDATES];
+    float kick_speed[MAX_CANDIDATES];
+    float score[MAX_CANDIDATES];
+
+    // evaluateLanes的中间结果
+    mutable float lane_dx[MAX_CANDIDATES], lane_dy[MAX_CANDIDATES];
+    mutable float lane_len[MAX_CANDIDATES], lane_v0[MAX_CANDIDATES];
+};
+
+#endif // PASS_EVALUATOR_H
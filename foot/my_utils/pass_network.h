@@ -0,0 +1,364 @@
+#ifndef PASS_NETWORK_H
+#define PASS_NETWORK_H
+
+#include <cmath>
+#include <chrono>
+#include "../utils/worldmodel.h"
+#include "../utils/constants.h"
+#include "../utils/vector.h"
+#include "pass_evaluator.h"
+
+/**
+ * @brief 传球链：从持球者出发经过若干次传球，最后射门
+ */
+struct PassChain {
+    int hops;                           // 传球次数
+    int ids[4];                         // 经过的球员，ids[0]为持球者，ids[hops]为射门者
+    double probability;                 // 所有传球和最后射门都成功的概率
+    double time;                        // 所有传球耗时之和(s)
+    double value;                       // 综合评分
+
+    PassChain() : hops(0), probability(0.0), time(0.0), value(-1.0) {
+        for (int i = 0; i < 4; i++) ids[i] = -1;
+    }
+};
+
+/**
+ * @brief 传球网络
+ * 每帧维护我方场上球员之间的传球图：边权为传球成功概率和球的飞行时间，节点带射门成功概率。
+ * 边只在两端球员或路线附近的对手移动超过阈值时重新计算。
+ * 在图上做有界的最优优先搜索，找出以高概率射门结束的两跳、三跳传球链。
+ * 由PlannerContext持有，update()在帧级作业中每帧调用一次；search()里的update()在同一帧直接返回，
+ * 没有帧级作业的入口（robot1）由第一次搜索更新
+ */
+class PassNetwork {
+public:
+    static const int MAX_NODES = TEAM_SIZE;             // 节点按场上人数开，不按车号空间
+    static const int MAX_HOPS = 3;                      // 最多传球次数
+    static const int MAX_EXPANSIONS = 64;               // 每次搜索最多扩展的状态数
+    static const int AIM_POINTS = 5;                    // 球门上的射门瞄准点数量
+    static constexpr double MOVE_THRESHOLD = 8.0;       // 球员移动超过该距离才更新相关边(cm)
+    static constexpr double OPP_INFLUENCE = 80.0;       // 对手影响的路线范围(cm)
+    static constexpr double HOP_DISCOUNT = 0.9;         // 每多一次传球的折扣
+    static constexpr double TIME_WEIGHT = 0.05;         // 传球耗时的惩罚权重(1/s)
+
+    explicit PassNetwork(const WorldModel* model) :
+        world_model(model),
+        lanes(model),
+        last_cycle(-1),
+        node_count(0),
+        edges_updated(0),
+        last_search_us(0.0) {
+        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
+            node_of[i] = -1;
+        }
+    }
+
+    /**
+     * @brief 每帧调用一次，增量更新传球图；同一帧重复调用直接返回
+     */
+    void update() {
+        int cycle = world_model->get_cycle();
+        if (cycle == last_cycle) {
+            return;
+        }
+        last_cycle = cycle;
+        edges_updated = 0;
+
+        // 1. 节点集合：场上除守门员外的我方球员，集合变化时全部重建
+        RobotSet players = world_model->get_our_field_set();
+        bool rebuild = (players != node_set);
+        int n = rebuild ? std::min(players.size(), static_cast<int>(MAX_NODES)) : node_count;
+
+        bool dirty_row[MAX_NODES];
+        if (rebuild) {
+            node_set = players;
+            node_count = n;
+            for (int i = 0; i < MAX_TEAM_ROBOTS; i++) node_of[i] = -1;
+            int i = 0;
+            for (int id : players) {
+                if (i >= n) break;
+                node_ids[i] = id;
+                node_of[id] = i;
+                node_pos[i] = world_model->get_our_player_pos(id);
+                dirty_row[i] = true;
+                for (int j = 0; j < n; j++) edge_dirty[i][j] = true;
+                i++;
+            }
+        } else {
+            // 2. 移动过的球员：其出边、入边和射门概率需要更新
+            for (int i = 0; i < n; i++) {
+                point2f pos = world_model->get_our_player_pos(node_ids[i]);
+                dirty_row[i] = (pos - node_pos[i]).length() > MOVE_THRESHOLD;
+                if (dirty_row[i]) node_pos[i] = pos;
+            }
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    edge_dirty[i][j] = dirty_row[i] || dirty_row[j];
+                }
+            }
+        }
+
+        // 3. 移动过的对手：只影响从其新旧位置附近经过的路线
+        RobotSet opponents = world_model->get_opp_set();
+        for (int k : opponents | opp_known) {
+            bool present = opponents.contains(k);
+            point2f pos = present ? world_model->get_opp_player_pos(k) : opp_pos[k];
+            if (present == opp_known.contains(k) && (!present || (pos - opp_pos[k]).length() <= MOVE_THRESHOLD)) {
+                continue;
+            }
+            for (int i = 0; i < n; i++) {
+                if (lanePassesNear(node_pos[i], goalCenter(), opp_pos[k], pos)) dirty_row[i] = true;
+                for (int j = 0; j < n; j++) {
+                    if (!edge_dirty[i][j] && lanePassesNear(node_pos[i], node_pos[j], opp_pos[k], pos)) {
+                        edge_dirty[i][j] = true;
+                    }
+                }
+            }
+            opp_pos[k] = pos;
+        }
+        opp_known = opponents;
+
+        // 4. 按行批量重新计算需要更新的边和射门概率
+        for (int i = 0; i < n; i++) {
+            updateRow(i, dirty_row[i]);
+        }
+    }
+
+    /**
+     * @brief 从持球者出发搜索最优传球链
+     * @param holder_id 持球球员
+     * @param from 球的位置
+     * @param min_hops 至少传球次数
+     * @param out 最优传球链
+     * @return 没有找到满足条件的链时返回false
+     */
+    bool search(int holder_id, const point2f& from, int min_hops, PassChain& out) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        update();
+
+        out = PassChain();
+        if (holder_id < 0 || holder_id >= MAX_TEAM_ROBOTS || node_of[holder_id] < 0) {
+            return false;
+        }
+
+        // 第一跳从球的位置出发而不是持球者位置
+        float first_prob[MAX_NODES];
+        float first_time[MAX_NODES];
+        float tx[MAX_NODES], ty[MAX_NODES];
+        for (int j = 0; j < node_count; j++) {
+            tx[j] = node_pos[j].x;
+            ty[j] = node_pos[j].y;
+        }
+        lanes.evaluateLanes(from, node_count, tx, ty, first_prob, first_time);
+
+        // 最优优先搜索：按上界（已走概率 x 全图最大射门概率）排序，固定容量的数组作为开放表
+        double max_shot = 0.0;
+        for (int i = 0; i < node_count; i++) {
+            if (shot_prob[i] > max_shot) max_shot = shot_prob[i];
+        }
+
+        State* open = open_list;
+        int open_size = 0;
+        State root;
+        root.node = node_of[holder_id];
+        root.depth = 0;
+        root.prob = 1.0;
+        root.time = 0.0;
+        root.visited = 1u << root.node;
+        root.path[0] = root.node;
+        open[open_size++] = root;
+
+        int expansions = 0;
+        while (open_size > 0 && expansions < MAX_EXPANSIONS) {
+            // 取出上界最大的状态
+            int best = 0;
+            for (int i = 1; i < open_size; i++) {
+                if (open[i].prob > open[best].prob) best = i;
+            }
+            State s = open[best];
+            open[best] = open[--open_size];
+            expansions++;
+
+            // 上界不超过当前最优结果时剪枝
+            if (s.prob * max_shot * discount(std::max(s.depth, min_hops)) <= out.value) {
+                continue;
+            }
+
+            // 以当前节点射门结束
+            if (s.depth >= min_hops) {
+                double value = s.prob * shot_prob[s.node] * discount(s.depth) - TIME_WEIGHT * s.time;
+                if (value > out.value) {
+                    out.hops = s.depth;
+                    for (int h = 0; h <= s.depth; h++) out.ids[h] = node_ids[s.path[h]];
+                    out.probability = s.prob * shot_prob[s.node];
+                    out.time = s.time;
+                    out.value = value;
+                }
+            }
+
+            if (s.depth >= MAX_HOPS) continue;
+            for (int j = 0; j < node_count; j++) {
+                if (s.visited & (1u << j)) continue;
+                float p = (s.depth == 0) ? first_prob[j] : edge_prob[s.node][j];
+                float t = (s.depth == 0) ? first_time[j] : edge_time[s.node][j];
+                if (p < MIN_EDGE_PROB || open_size >= MAX_OPEN) continue;
+
+                State c = s;
+                c.node = j;
+                c.depth = s.depth + 1;
+                c.prob = s.prob * p;
+                c.time = s.time + t;
+                c.visited |= 1u << j;
+                c.path[c.depth] = j;
+                open[open_size++] = c;
+            }
+        }
+
+        last_search_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        return out.hops > 0;
+    }
+
+    /**
+     * @brief 获取两名球员之间的传球成功概率
+     * @return 任一球员不在图中时返回0
+     */
+    double edgeProbability(int from_id, int to_id) const {
+        if (from_id < 0 || to_id < 0 || from_id >= MAX_TEAM_ROBOTS || to_id >= MAX_TEAM_ROBOTS) return 0.0;
+        int i = node_of[from_id], j = node_of[to_id];
+        return (i < 0 || j < 0) ? 0.0 : edge_prob[i][j];
+    }
+
+    /**
+     * @brief 获取球员的射门成功概率
+     */
+    double shotProbability(int id) const {
+        if (id < 0 || id >= MAX_TEAM_ROBOTS || node_of[id] < 0) return 0.0;
+        return shot_prob[node_of[id]];
+    }
+
+    /**
+     * @brief 本帧重新计算的边数，用于观察增量更新效果
+     */
+    int edgesUpdated() const {
+        return edges_updated;
+    }
+
+    /**
+     * @brief 上次搜索（含增量更新）的耗时(微秒)
+     */
+    double lastSearchMicros() const {
+        return last_search_us;
+    }
+
+private:
+    static constexpr float MIN_EDGE_PROB = 0.3f;        // 低于该概率的边不扩展
+
+    /**
+     * @brief 搜索状态
+     */
+    struct State {
+        int node;
+        int depth;
+        double prob;
+        double time;
+        unsigned int visited;
+        int path[MAX_HOPS + 1];
+    };
+
+    // 开放表容量：每次扩展最多加入MAX_NODES - 1个后继，再加上根
+    static const int MAX_OPEN = MAX_EXPANSIONS * (MAX_NODES - 1) + 1;
+
+    static point2f goalCenter() {
+        return point2f(FIELD_LENGTH_H, 0);
+    }
+
+    static double discount(int hops) {
+        double d = 1.0;
+        for (int i = 1; i < hops; i++) d *= HOP_DISCOUNT;
+        return d;
+    }
+
+    /**
+     * @brief 判断路线是否经过对手新旧位置之一的附近
+     */
+    static bool lanePassesNear(const point2f& a, const point2f& b, const point2f& p1, const point2f& p2) {
+        return segmentDistance(a, b, p1) < OPP_INFLUENCE || segmentDistance(a, b, p2) < OPP_INFLUENCE;
+    }
+
+    static double segmentDistance(const point2f& a, const point2f& b, const point2f& p) {
+        point2f ab = b - a;
+        double len2 = ab.x * ab.x + ab.y * ab.y;
+        double t = (len2 < 1e-6) ? 0.0 : ((p.x - a.x) * ab.x + (p.y - a.y) * ab.y) / len2;
+        t = std::max(0.0, std::min(1.0, t));
+        point2f closest = a + ab * static_cast<float>(t);
+        return (p - closest).length();
+    }
+
+    /**
+     * @brief 批量重新计算节点i的出边（只写回标记为需要更新的边）和射门概率
+     */
+    void updateRow(int i, bool update_shot) {
+        bool any = false;
+        for (int j = 0; j < node_count; j++) {
+            if (j != i && edge_dirty[i][j]) any = true;
+        }
+
+        if (any) {
+            float tx[MAX_NODES], ty[MAX_NODES], prob[MAX_NODES], time[MAX_NODES];
+            for (int j = 0; j < node_count; j++) {
+                tx[j] = node_pos[j].x;
+                ty[j] = node_pos[j].y;
+            }
+            lanes.evaluateLanes(node_pos[i], node_count, tx, ty, prob, time);
+            for (int j = 0; j < node_count; j++) {
+                if (j == i || !edge_dirty[i][j]) continue;
+                edge_prob[i][j] = prob[j];
+                edge_time[i][j] = time[j];
+                edges_updated++;
+            }
+        }
+        edge_prob[i][i] = 0.0f;
+        edge_time[i][i] = 0.0f;
+
+        if (update_shot) {
+            // 射门：以最大速度射向球门上的瞄准点，取最好的一个，并按距离衰减
+            float tx[AIM_POINTS], ty[AIM_POINTS], prob[AIM_POINTS], time[AIM_POINTS];
+            for (int k = 0; k < AIM_POINTS; k++) {
+                tx[k] = float(FIELD_LENGTH_H);
+                ty[k] = float(-GOAL_WIDTH_H + GOAL_WIDTH * (k + 0.5) / AIM_POINTS);
+            }
+            lanes.evaluateLanes(node_pos[i], AIM_POINTS, tx, ty, prob, time, true);
+            float best = 0.0f;
+            for (int k = 0; k < AIM_POINTS; k++) {
+                if (prob[k] > best) best = prob[k];
+            }
+            double dist = (goalCenter() - node_pos[i]).length();
+            shot_prob[i] = best * (1.0 - std::min(dist / FIELD_LENGTH_H, 1.0));
+        }
+    }
+
+    const WorldModel* world_model;
+    PassEvaluator lanes;                            // 复用其批量路线评估
+    int last_cycle;
+
+    RobotSet node_set;                              // 图中的球员
+    int node_count;
+    int node_ids[MAX_NODES];                        // 节点对应的球员ID
+    int node_of[MAX_TEAM_ROBOTS];                   // 球员ID对应的节点，-1表示不在图中
+    point2f node_pos[MAX_NODES];                    // 上次计算边时的球员位置
+    float edge_prob[MAX_NODES][MAX_NODES];          // 传球成功概率
+    float edge_time[MAX_NODES][MAX_NODES];          // 球的飞行时间(s)
+    bool edge_dirty[MAX_NODES][MAX_NODES];
+    double shot_prob[MAX_NODES];                    // 射门成功概率
+
+    point2f opp_pos[MAX_TEAM_ROBOTS];               // 上次计算边时的对手位置
+    RobotSet opp_known;                             // 上次计算边时在场的对手
+
+    State open_list[MAX_OPEN];                      // 搜索的开放表，放在成员中不占用调用栈
+
+    int edges_updated;
+    double last_search_us;
+};
+
+#endif // PASS_NETWORK_H
@@ -0,0 +1,230 @@
+#ifndef PB_WIRE_H
+#define PB_WIRE_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+/**
+ * @brief protobuf线格式的类型
+ */
+enum PbWireType {
+    PB_VARINT = 0,
+    PB_FIXED64 = 1,
+    PB_LENGTH_DELIMITED = 2,
+    PB_FIXED32 = 5
+};
+
+/**
+ * @brief protobuf线格式读取器
+ * 直接在接收缓冲区上按字段顺序解析，不生成中间消息对象、不分配内存；
+ * 子消息返回指向同一缓冲区的子读取器。格式错误时ok()变为false，之后的读取都返回0。
+ */
+class PbReader {
+public:
+    PbReader() : cur(NULL), end(NULL), good(true) {}
+    PbReader(const unsigned char* data, size_t size) : cur(data), end(data + size), good(true) {}
+
+    /**
+     * @brief 读取下一个字段的标签
+     * @param field 输出字段号
+     * @param wire 输出线格式类型
+     * @return 是否还有字段（到达末尾或格式错误时返回false）
+     */
+    bool next(uint32_t& field, uint32_t& wire) {
+        if (!good || cur >= end) {
+            return false;
+        }
+        uint64_t tag = varint();
+        field = static_cast<uint32_t>(tag >> 3);
+        wire = static_cast<uint32_t>(tag & 7);
+        return good && field != 0;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cur >= end) {
+                good = false;
+                return 0;
+            }
+            unsigned char b = *cur++;
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                return value;
+            }
+        }
+        good = false;
+        return 0;
+    }
+
+    /**
+     * @brief 读取sint32/sint64字段（zigzag编码）
+     */
+    int64_t svarint() {
+        uint64_t v = varint();
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    float fixed32f() {
+        uint32_t bits = static_cast<uint32_t>(fixedBytes(4));
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    double fixed64d() {
+        uint64_t bits = fixedBytes(8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief 读取长度前缀的子消息
+     * @return 指向子消息内容的读取器，外层读取器跳过该段
+     */
+    PbReader message() {
+        size_t n = static_cast<size_t>(varint());
+        if (!good || n > static_cast<size_t>(end - cur)) {
+            good = false;
+            return PbReader();
+        }
+        PbReader sub(cur, n);
+        cur += n;
+        return sub;
+    }
+
+    /**
+     * @brief 跳过一个不关心的字段
+     */
+    void skip(uint32_t wire) {
+        switch (wire) {
+            case PB_VARINT: varint(); break;
+            case PB_FIXED64: advance(8); break;
+            case PB_LENGTH_DELIMITED: advance(static_cast<size_t>(varint())); break;
+            case PB_FIXED32: advance(4); break;
+            default: good = false; break;
+        }
+    }
+
+    bool ok() const { return good; }
+
+private:
+    uint64_t fixedBytes(int n) {
+        if (static_cast<size_t>(end - cur) < static_cast<size_t>(n)) {
+            good = false;
+            cur = end;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < n; i++) {
+            value |= static_cast<uint64_t>(cur[i]) << (8 * i);
+        }
+        cur += n;
+        return value;
+    }
+
+    void advance(size_t n) {
+        if (!good || n > static_cast<size_t>(end - cur)) {
+            good = false;
+            cur = end;
+            return;
+        }
+        cur += n;
+    }
+
+    const unsigned char* cur;
+    const unsigned char* end;
+    bool good;
+};
+
+/**
+ * @brief protobuf线格式写入器，用于回放工具和测试数据生成
+ * 写入固定容量的缓冲区，容量不足时overflow()为true。
+ * 子消息长度预留两个字节（非最简varint，标准解析器可正确读取），单个子消息不超过16383字节。
+ */
+class PbWriter {
+public:
+    PbWriter(unsigned char* buffer, size_t capacity) : buf(buffer), cap(capacity), len(0), over(false) {}
+
+    void tag(uint32_t field, uint32_t wire) { varint((static_cast<uint64_t>(field) << 3) | wire); }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            byte(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        byte(static_cast<unsigned char>(value));
+    }
+
+    void uint32Field(uint32_t field, uint32_t value) {
+        tag(field, PB_VARINT);
+        varint(value);
+    }
+
+    void uint64Field(uint32_t field, uint64_t value) {
+        tag(field, PB_VARINT);
+        varint(value);
+    }
+
+    void sint32Field(uint32_t field, int32_t value) {
+        tag(field, PB_VARINT);
+        varint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+
+    void floatField(uint32_t field, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        tag(field, PB_FIXED32);
+        for (int i = 0; i < 4; i++) byte(static_cast<unsigned char>(bits >> (8 * i)));
+    }
+
+    void doubleField(uint32_t field, double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        tag(field, PB_FIXED64);
+        for (int i = 0; i < 8; i++) byte(static_cast<unsigned char>(bits >> (8 * i)));
+    }
+
+    /**
+     * @brief 开始一个子消息
+     * @return 长度字段的位置，传给endMessage
+     */
+    size_t beginMessage(uint32_t field) {
+        tag(field, PB_LENGTH_DELIMITED);
+        size_t at = len;
+        byte(0x80);
+        byte(0);
+        return at;
+    }
+
+    void endMessage(size_t at) {
+        size_t n = len - at - 2;
+        if (over || n > 0x3FFF) {
+            over = true;
+            return;
+        }
+        buf[at] = static_cast<unsigned char>(0x80 | (n & 0x7F));
+        buf[at + 1] = static_cast<unsigned char>(n >> 7);
+    }
+
+    size_t size() const { return len; }
+    bool overflow() const { return over; }
+
+private:
+    void byte(unsigned char b) {
+        if (len >= cap) {
+            over = true;
+            return;
+        }
+        buf[len++] = b;
+    }
+
+    unsigned char* buf;
+    size_t cap;
+    size_t len;
+    bool over;
+};
+
+#endif // PB_WIRE_H
@@ -0,0 +1,195 @@
+#ifndef PLANNER_CONTEXT_H
+#define PLANNER_CONTEXT_H
+
+#include <memory>
+#include <string>
+#include "../utils/worldmodel.h"
+#include "../utils/task_board.h"
+#include "logger.h"
+#include "communication.h"
+#include "tactics.h"
+#include "team_state.h"
+#include "set_piece_planner.h"
+#include "rule_projection.h"
+#include "radio_output.h"
+#include "ball_tools.h"
+#include "players.h"
+#include "opp_players.h"
+#include "opp_goalie.h"
+#include "pass_network.h"
+
+/**
+ * @brief 一个规划器的运行时上下文
+ * 持有日志、通信、战术工厂、任务公告板、规则投影、无线输出、双方队伍状态、定位球方案、工具类和周期计数。
+ * getDefault()返回由原有单例组成的默认上下文，player_plan等旧入口继续使用，单例只经由它访问；
+ * 用构造函数创建的上下文各自拥有一套独立实例，同一进程内的多个规划器（并行仿真、策略对比）互不串话、无需加锁。
+ * 一个上下文同一时刻只能由一个规划线程使用。
+ */
+class PlannerContext {
+public:
+    /**
+     * @brief 获取默认上下文（由各单例组成）
+     * @return 默认上下文
+     */
+    static PlannerContext& getDefault() {
+        static PlannerContext instance(Defaults{});
+        return instance;
+    }
+
+    /**
+     * @brief 创建独立的上下文
+     * @param name 上下文名称，用于区分通信通道；同一支队伍分布在多个DLL中的规划器应使用相同的名称
+     */
+    explicit PlannerContext(const std::string& name) :
+        owned(new Owned()),
+        logger(&owned->logger),
+        communication(&owned->communication),
+        tactic_factory(&owned->tactic_factory),
+        task_board(&owned->task_board),
+        rule_projection(&owned->rule_projection),
+        radio_output(&owned->radio_output),
+        our_state(&owned->our_state),
+        opp_state(&owned->opp_state),
+        set_piece_planner(&owned->set_piece_planner),
+        context_name(name) {
+        communication->setChannel(std::string(Communication::DEFAULT_CHANNEL) + "_" + name);
+    }
+
+    ~PlannerContext() {
+        cleanup();
+    }
+
+    PlannerContext(const PlannerContext&) = delete;
+    PlannerContext& operator=(const PlannerContext&) = delete;
+
+    /**
+     * @brief 创建工具类并初始化日志和通信，已初始化时直接返回
+     * @param model 世界模型指针
+     * @param robot_id 当前机器人ID
+     */
+    void initialize(const WorldModel* model, int robot_id) {
+        if (initialized) {
+            return;
+        }
+        ball_tools = new BallTools(model);
+        our_players = new Players(model, *ball_tools, *our_state);
+        opp_players = new OppPlayers(model, *ball_tools, *opp_state);
+        opp_goalie = new OppGoalie(model);
+        pass_network = new PassNetwork(model);
+
+        logger->setLogLevel(LogLevel::INFO);
+        logger->setDebugOutput(true);
+        communication->initialize(robot_id);
+        initialized = true;
+    }
+
+    /**
+     * @brief 释放工具类并关闭通信
+     */
+    void cleanup() {
+        if (!initialized) {
+            return;
+        }
+        delete pass_network;
+        delete opp_goalie;
+        delete opp_players;
+        delete our_players;
+        delete ball_tools;
+        pass_network = nullptr;
+        opp_goalie = nullptr;
+        opp_players = nullptr;
+        our_players = nullptr;
+        ball_tools = nullptr;
+        communication->cleanup();
+        initialized = false;
+    }
+
+    /**
+     * @brief 周期计数加一
+     * @return 新的周期计数
+     */
+    int nextCycle() { return ++cycle_counter; }
+
+    int getCycleCounter() const { return cycle_counter; }
+    bool isInitialized() const { return initialized; }
+    bool isDefault() const { return !owned; }
+    const std::string& getName() const { return context_name; }
+
+    Logger& getLogger() { return *logger; }
+    Communication& getCommunication() { return *communication; }
+    TacticFactory& getTacticFactory() { return *tactic_factory; }
+    TeamTaskBoard& getTaskBoard() { return *task_board; }
+    RuleProjection& getRuleProjection() { return *rule_projection; }
+    RadioOutput& getRadioOutput() { return *radio_output; }
+    OurTeamState& getOurState() { return *our_state; }
+    OppTeamState& getOppState() { return *opp_state; }
+    SetPiecePlanner& getSetPiecePlanner() { return *set_piece_planner; }
+
+    /**
+     * @brief 本上下文上创建战术时使用的运行环境，须在initialize之后调用
+     * @return 指向本上下文各实例的战术运行环境
+     */
+    TacticEnv getTacticEnv() {
+        TacticEnv env;
+        env.our_state = our_state;
+        env.opp_state = opp_state;
+        env.set_piece_planner = set_piece_planner;
+        env.pass_network = pass_network;
+        env.logger = logger;
+        env.communication = communication;
+        return env;
+    }
+
+    // 工具类，initialize之后有效
+    BallTools* ball_tools = nullptr;
+    Players* our_players = nullptr;
+    OppPlayers* opp_players = nullptr;
+    OppGoalie* opp_goalie = nullptr;
+    PassNetwork* pass_network = nullptr;
+
+private:
+    struct Defaults {};
+
+    // 独立上下文拥有的实例
+    struct Owned {
+        Owned() : communication(logger) {}
+
+        Logger logger;
+        Communication communication;
+        TacticFactory tactic_factory;
+        TeamTaskBoard task_board;
+        RuleProjection rule_projection;
+        RadioOutput radio_output;
+        OurTeamState our_state;
+        OppTeamState opp_state;
+        SetPiecePlanner set_piece_planner;
+    };
+
+    explicit PlannerContext(Defaults) :
+        logger(&Logger::getInstance()),
+        communication(&Communication::getInstance()),
+        tactic_factory(&TacticFactory::getInstance()),
+        task_board(TaskMeditator::getInstance()),
+        rule_projection(&RuleProjection::getInstance()),
+        radio_output(&RadioOutput::getInstance()),
+        our_state(&OurTeamState::getInstance()),
+        opp_state(&OppTeamState::getInstance()),
+        set_piece_planner(&SetPiecePlanner::getInstance()),
+        context_name("default") {}
+
+    std::unique_ptr<Owned> owned;
+    Logger* logger;
+    Communication* communication;
+    TacticFactory* tactic_factory;
+    TeamTaskBoard* task_board;
+    RuleProjection* rule_projection;
+    RadioOutput* radio_output;
+    OurTeamState* our_state;
+    OppTeamState* opp_state;
+    SetPiecePlanner* set_piece_planner;
+    std::string context_name;
+    int cycle_counter = 0;
+    bool initialized = false;
+};
+
+#endif // PLANNER_CONTEXT_H
@@ -12,6 +12,7 @@
 #include "../utils/maths.h"
 #include "../utils/PlayerTask.h"
 #include "ball_tools.h"
+#include "team_state.h"
 
 // 常量定义
 #define PLAYER_HISTORY_SIZE 20     // 历史数据记录大小
@@ -91,7 +92,7 @@ public:
         double dt = duration / 1000.0; // 转换为秒
         
         // 更新球员基本信息
-        isActive = model->get_our_exist_id()[id];
+        isActive = model->get_our_set().contains(id);
         if (!isActive) {
             return; // 如果球员不存在则不更新
         }
@@ -346,8 +347,7 @@ public:
 class Players {
 public:
     // 直接访问的成员变量
-    Player player1;        // 第一个球员
-    Player player2;        // 第二个球员
+    std::vector<Player> players;  // 按车号索引的球员，长度为MAX_TEAM_ROBOTS
     Player* activePlayer;  // 指向当前活跃球员的指针
     
     // 球队整体信息
@@ -364,140 +364,100 @@ public:
      * @brief 构造函数
      * @param model 世界模型指针
      * @param ballTools 球工具类引用
+     * @param teamState 我方队伍状态，由所属的PlannerContext提供
      */
-    Players(const WorldModel* model, BallTools& ballTools) : 
+    Players(const WorldModel* model, BallTools& ballTools, OurTeamState& teamState) : 
         model(model), 
+        state(teamState),
         ball(ballTools),
         hasPossession(false),
         formationWidth(400),
         formationDepth(300) {
         
+        // 一次性分配所有车号的球员，之后不再扩容，activePlayers中的指针保持有效
+        players.reserve(MAX_TEAM_ROBOTS);
+        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
+            players.emplace_back(i, model, ballTools);
+        }
+        activePlayers.reserve(MAX_TEAM_ROBOTS);
+        
         updateState();
-        last_update_time = std::chrono::high_resolution_clock::now();
     }
     
     ~Players() {}
     
     /**
      * @brief 更新所有球员状态
-     * 每周期调用此函数更新信息
+     * 每周期调用此函数更新信息，原始数据由OurTeamState每帧统一更新一次
      */
     void updateState() {
-        auto current_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - last_update_time).count();
-        double dt = duration / 1000.0; // 转换为秒
+        state.update(model);
         
-        // 获取球员ID列表
-        const bool* exists = model->get_our_exist_id();
-        int goalie_id = model->get_our_goalie();
+        // 场上除守门员外的球员集合，以及其中持球的球员
+        RobotSet field_players = state.fieldPlayers();
+        RobotSet holders = state.ballHolders(field_players, get_ball_threshold);
         
         // 重置球员数组
         activePlayers.clear();
         
-        // 保存球员上一帧数据
-        player1.lastPosition = player1.position;
-        player1.lastVelocity = player1.velocity;
-        player1.lastOrientation = player1.orientation;
-        
-        player2.lastPosition = player2.position;
-        player2.lastVelocity = player2.velocity;
-        player2.lastOrientation = player2.orientation;
-        
-        // 更新各球员信息
-        bool foundPlayer1 = false;
-        bool foundPlayer2 = false;
-        
-        for (int i = 0; i < MAX_TEAM_ROBOTS; ++i) {
-            if (exists[i] && i != goalie_id) {
-                Player* currentPlayer = nullptr;
-                
-                // 为第一个找到的非守门员球员赋值
-                if (!foundPlayer1) {
-                    player1.id = i;
-                    player1.isActive = true;
-                    currentPlayer = &player1;
-                    foundPlayer1 = true;
-                }
-                // 为第二个找到的非守门员球员赋值
-                else if (!foundPlayer2) {
-                    player2.id = i;
-                    player2.isActive = true;
-                    currentPlayer = &player2;
-                    foundPlayer2 = true;
-                }
-                
-                if (currentPlayer) {
-                    // 更新基础属性
-                    currentPlayer->position = model->get_our_player_pos(i);
-                    currentPlayer->velocity = model->get_our_player_v(i);
-                    currentPlayer->orientation = model->get_our_player_dir(i);
-                    currentPlayer->speed = currentPlayer->velocity.length();
-                    
-                    // 计算旋转速度
-                    if (dt > 0) {
-                        double angle_diff = anglemod(currentPlayer->orientation - currentPlayer->lastOrientation);
-                        currentPlayer->rotationalSpeed = angle_diff / dt;
-                    }
-                    
-                    // 更新历史数据
-                    currentPlayer->updateHistory();
-                    
-                    // 检查是否持球
-                    double dist = (ball.position - currentPlayer->position).length();
-                    double angle_diff = fabs(anglemod((ball.position - currentPlayer->position).angle() - currentPlayer->orientation));
-                    currentPlayer->hasBall = (dist < get_ball_threshold && angle_diff < M_PI/4);
-                    
-                    // 添加到活跃球员列表
-                    activePlayers.push_back(currentPlayer);
-                }
-            }
+        // 保存球员上一帧数据，先全部设为不活跃
+        for (Player& player : players) {
+            player.lastPosition = player.position;
+            player.lastVelocity = player.velocity;
+            player.lastOrientation = player.orientation;
+            player.isActive = false;
         }
         
-        // 未找到的球员设为不活跃
-        if (!foundPlayer1) {
-            player1.isActive = false;
-        }
-        if (!foundPlayer2) {
-            player2.isActive = false;
+        // 更新场上各球员信息
+        for (int i : field_players) {
+            Player* currentPlayer = &players[i];
+            currentPlayer->id = i;
+            currentPlayer->isActive = true;
+            
+            // 更新基础属性
+            currentPlayer->position = state.position(i);
+            currentPlayer->velocity = state.velocity(i);
+            currentPlayer->orientation = state.orientation(i);
+            currentPlayer->speed = state.speedOf(i);
+            currentPlayer->rotSpeed = state.rotationSpeed(i);
+            currentPlayer->hasBall = holders.contains(i);
+            
+            // 更新历史数据
+            currentPlayer->updateHistory();
+            
+            // 添加到活跃球员列表
+            activePlayers.push_back(currentPlayer);
         }
         
         // 更新团队信息
         updateTeamInfo();
-        
-        // 更新时间
-        last_update_time = current_time;
     }
     
     /**
      * @brief 更新团队整体信息
      */
     void updateTeamInfo() {
-        // 检查队伍是否有球权
-        hasPossession = (player1.isActive && player1.hasBall) || 
-                        (player2.isActive && player2.hasBall);
-        
-        // 计算队伍质心
-        int activeCount = 0;
+        // 检查队伍是否有球权，同时计算队伍质心
+        hasPossession = false;
         point2f sum(0, 0);
-        
-        if (player1.isActive) {
-            sum = sum + player1.position;
-            activeCount++;
-        }
-        
-        if (player2.isActive) {
-            sum = sum + player2.position;
-            activeCount++;
+        for (const Player* player : activePlayers) {
+            hasPossession = hasPossession || player->hasBall;
+            sum = sum + player->position;
         }
         
+        int activeCount = static_cast<int>(activePlayers.size());
         if (activeCount > 0) {
             teamCentroid = sum / activeCount;
         }
         
-        // 计算球员分散度
+        // 计算球员分散度：到质心平均距离的两倍，两名球员时等于二者间距
         teamSpread = 0;
-        if (player1.isActive && player2.isActive) {
-            teamSpread = (player1.position - player2.position).length();
+        if (activeCount > 1) {
+            double total = 0;
+            for (const Player* player : activePlayers) {
+                total += (player->position - teamCentroid).length();
+            }
+            teamSpread = 2.0 * total / activeCount;
         }
     }
     
@@ -507,9 +467,8 @@ public:
      * @return 球员指针，若未找到则返回nullptr
      */
     Player* getPlayer(int id) {
-        if (player1.isActive && player1.id == id) return &player1;
-        if (player2.isActive && player2.id == id) return &player2;
-        return nullptr;
+        if (id < 0 || id >= MAX_TEAM_ROBOTS || !players[id].isActive) return nullptr;
+        return &players[id];
     }
     
     /**
@@ -520,6 +479,14 @@ public:
         return activePlayers;
     }
     
+    /**
+     * @brief 获取场上我方球员ID集合（不含守门员）
+     * @return 球员ID集合，可直接用for遍历，不分配内存
+     */
+    RobotSet getPlayerIds() const {
+        return model->get_our_field_set();
+    }
+    
     /**
      * @brief 获取最接近球的球员
      * @return 球员指针，若无球员则返回nullptr
@@ -876,10 +843,8 @@ public:
 
 private:
     const WorldModel* model;
+    OurTeamState& state;                 // 我方的逐帧共享状态
     std::vector<Player*> activePlayers;  // 活跃球员列表
-    
-    // 上次更新时间
-    std::chrono::time_point<std::chrono::high_resolution_clock> last_update_time;
 };
 
 #endif // PLAYERS_H 
\ No newline at end of file
@@ -0,0 +1,392 @@
+#ifndef RADIO_OUTPUT_H
+#define RADIO_OUTPUT_H
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include "../utils/worldmodel.h"
+#include "../utils/PlayerTask.h"
+#include "../utils/task_packet.h"
+#include "../utils/constants.h"
+#include "../utils/vector.h"
+#include "../utils/robot_set.h"
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 无线发送通道：UDP、串口或测试用的替身都实现这个接口
+ */
+class RadioTransport {
+public:
+    virtual ~RadioTransport() {}
+
+    /**
+     * @brief 发送一个完整的数据包，不应长时间阻塞
+     * @return 是否全部写出
+     */
+    virtual bool send(const unsigned char* data, int size) = 0;
+};
+
+#ifdef __linux__
+
+/**
+ * @brief 通过UDP把数据包发给无线基站
+ */
+class UdpRadioTransport : public RadioTransport {
+public:
+    UdpRadioTransport() : sock(-1) {
+        std::memset(&dest, 0, sizeof(dest));
+    }
+
+    ~UdpRadioTransport() {
+        close();
+    }
+
+    UdpRadioTransport(const UdpRadioTransport&) = delete;
+    UdpRadioTransport& operator=(const UdpRadioTransport&) = delete;
+
+    /**
+     * @brief 打开套接字
+     * @param host 基站地址
+     * @param port 基站端口
+     */
+    bool open(const char* host, int port) {
+        close();
+        sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (sock < 0) {
+            return false;
+        }
+        dest.sin_family = AF_INET;
+        dest.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, host, &dest.sin_addr) != 1) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (sock >= 0) {
+            ::close(sock);
+            sock = -1;
+        }
+    }
+
+    bool send(const unsigned char* data, int size) override {
+        return sock >= 0 && sendto(sock, data, size, 0, reinterpret_cast<const sockaddr*>(&dest), sizeof(dest)) == size;
+    }
+
+private:
+    int sock;
+    sockaddr_in dest;
+};
+
+/**
+ * @brief 通过串口把数据包发给无线发射模块（原始模式，8N1）
+ */
+class SerialRadioTransport : public RadioTransport {
+public:
+    SerialRadioTransport() : fd(-1) {}
+
+    ~SerialRadioTransport() {
+        close();
+    }
+
+    SerialRadioTransport(const SerialRadioTransport&) = delete;
+    SerialRadioTransport& operator=(const SerialRadioTransport&) = delete;
+
+    /**
+     * @brief 打开串口
+     * @param device 设备路径，例如/dev/ttyUSB0
+     * @param baud termios波特率常量，例如B115200
+     */
+    bool open(const char* device, speed_t baud = B115200) {
+        close();
+        fd = ::open(device, O_RDWR | O_NOCTTY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        termios tio;
+        if (tcgetattr(fd, &tio) != 0) {
+            close();
+            return false;
+        }
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, baud);
+        cfsetospeed(&tio, baud);
+        tio.c_cflag |= CLOCAL | CREAD;
+        if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    bool send(const unsigned char* data, int size) override {
+        int written = 0;
+        while (fd >= 0 && written < size) {
+            ssize_t n = ::write(fd, data + written, size - written);
+            if (n <= 0) {
+                return false;
+            }
+            written += static_cast<int>(n);
+        }
+        return fd >= 0;
+    }
+
+private:
+    int fd;
+};
+
+#endif // __linux__
+
+/**
+ * @brief 任务转速度指令的运动参数
+ */
+struct RadioOutputConfig {
+    double frame_time;          // 控制周期(s)
+    double max_speed;           // 最大平动速度(cm/s)
+    double default_acc;         // 任务未指定时的加速度(cm/s^2)
+    double default_dec;         // 任务未指定时的减速度(cm/s^2)
+    double max_rot_speed;       // 最大转动速度(rad/s)
+    double rot_acc;             // 转动加速度(rad/s^2)
+    int keyframe_interval;      // 关键帧间隔（帧）
+
+    RadioOutputConfig() : frame_time(1.0 / 60.0), max_speed(300), default_acc(300), default_dec(300),
+        max_rot_speed(6), rot_acc(20), keyframe_interval(60) {}
+};
+
+/**
+ * @brief 一帧发送的统计
+ */
+struct RadioFrameStats {
+    int cycle;                  // 周期
+    int robots;                 // 本帧收集到的任务数
+    int bytes;                  // 数据包长度，编码失败为-1
+    bool sent;                  // 是否成功写出
+    bool complete;              // 是否在全部机器人完成后发出（否则为下一帧到来时补发）
+    long long first_task_ns;    // 本帧第一个任务提交时刻(steady_clock, ns)
+    long long task_out_ns;      // 数据包离开本进程的时刻(steady_clock, ns)
+};
+
+/**
+ * @brief 无线指令输出阶段
+ * 收集本帧每个机器人的任务，最后一个机器人提交后立即把全队任务转换为速度指令，
+ * 用task_packet.h编码为一个数据包，通过RadioTransport发出，并记录发出时刻供延迟补偿和性能分析使用。
+ * 没有设置发送通道时只做收集和统计。
+ */
+class RadioOutput {
+public:
+    /**
+     * @brief 获取单例实例
+     * @return 输出阶段实例
+     */
+    static RadioOutput& getInstance() {
+        static RadioOutput instance;
+        return instance;
+    }
+
+    RadioOutput() : transport(NULL), encoder(config.keyframe_interval), frame_cycle(-1), flushed(true),
+        first_task_ns(0), frames_sent(0), send_failures(0), late(0) {
+        std::memset(&last, 0, sizeof(last));
+        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
+            last_vel[i] = point2f(0, 0);
+            last_rot[i] = 0;
+        }
+    }
+
+    /**
+     * @brief 设置发送通道，传NULL只统计不发送；通道的生命周期由调用方管理
+     */
+    void setTransport(RadioTransport* t) {
+        std::lock_guard<std::mutex> lock(mutex);
+        transport = t;
+        encoder.forceKeyframe();
+    }
+
+    void setConfig(const RadioOutputConfig& c) {
+        std::lock_guard<std::mutex> lock(mutex);
+        config = c;
+        encoder = TaskPacketEncoder(c.keyframe_interval);
+    }
+
+    /**
+     * @brief 提交一个机器人本帧的任务
+     * 新的周期的第一个任务开始新的一帧（上一帧若还未发出则先补发）；
+     * 本帧在场的我方非守门员机器人都提交后立即发送，守门员提交的任务同样计入数据包。
+     * @param model 世界模型指针
+     * @param robot_id 车号
+     * @param task 已完成规则投影的任务
+     * @return 本次提交是否触发了发送
+     */
+    bool submit(const WorldModel* model, int robot_id, const PlayerTask& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (robot_id < 0 || robot_id >= MAX_TEAM_ROBOTS) {
+            return false;
+        }
+        int cycle = model->get_cycle();
+        if (cycle != frame_cycle) {
+            if (frame_cycle >= 0 && !flushed) {
+                flushLocked(false);
+            }
+            beginFrame(model, cycle);
+        } else if (flushed) {
+            // 本帧已发出后迟到的任务，留到下一帧的差分中
+            late++;
+        }
+
+        tasks[robot_id] = task;
+        toVelocity(model, robot_id, tasks[robot_id]);
+        submitted.insert(robot_id);
+        if (!flushed && (expected - submitted).empty()) {
+            flushLocked(true);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 立即发出本帧已收集的任务（例如部分机器人规划超时）
+     */
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frame_cycle >= 0 && !flushed) {
+            flushLocked(false);
+        }
+    }
+
+    /**
+     * @brief 最近一帧数据包的发出时刻(steady_clock, ns)，还没有发送过为0
+     */
+    long long taskOutTime() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return last.task_out_ns;
+    }
+
+    /**
+     * @brief 最近一帧的发送统计
+     */
+    RadioFrameStats lastFrame() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return last;
+    }
+
+    long long framesSent() const { std::lock_guard<std::mutex> lock(mutex); return frames_sent; }
+    long long sendFailures() const { std::lock_guard<std::mutex> lock(mutex); return send_failures; }
+    long long lateTasks() const { std::lock_guard<std::mutex> lock(mutex); return late; }
+
+private:
+    RadioOutput(const RadioOutput&) = delete;
+    RadioOutput& operator=(const RadioOutput&) = delete;
+
+    void beginFrame(const WorldModel* model, int cycle) {
+        frame_cycle = cycle;
+        flushed = false;
+        // 守门员由单独的goalie_plan规划，不经过这里提交，只等场上的其他球员
+        expected = model->get_our_field_set();
+        submitted = RobotSet();
+        first_task_ns = now();
+    }
+
+    void flushLocked(bool complete) {
+        bool active[MAX_TEAM_ROBOTS];
+        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
+            active[i] = submitted.contains(i);
+        }
+        int bytes = encoder.encode(tasks, active, MAX_TEAM_ROBOTS, packet, sizeof(packet));
+        bool ok = bytes > 0 && (transport == NULL || transport->send(packet, bytes));
+
+        last.cycle = frame_cycle;
+        last.robots = submitted.size();
+        last.bytes = bytes;
+        last.sent = ok && transport != NULL;
+        last.complete = complete;
+        last.first_task_ns = first_task_ns;
+        last.task_out_ns = now();
+        if (last.sent) {
+            frames_sent++;
+        } else if (transport != NULL) {
+            send_failures++;
+            encoder.forceKeyframe();    // 接收端的差分基准已不可靠
+        }
+        flushed = true;
+    }
+
+    /**
+     * @brief 把目标点和到点速度转换为本周期的全局速度指令
+     * 平动按剩余距离的减速曲线求期望速度并受加速度限制，转动同理；结果写回global_vel和rot_vel
+     */
+    void toVelocity(const WorldModel* model, int id, PlayerTask& task) {
+        const double dt = config.frame_time;
+        double acc = task.maxAcceleration > 0 ? task.maxAcceleration : config.default_acc;
+        double dec = task.maxDeceleration > 0 ? task.maxDeceleration : config.default_dec;
+
+        point2f pos = model->get_our_player_pos(id);
+        point2f to_target = task.target_pos - pos;
+        double dist = to_target.length();
+        double end_speed = std::min(double(task.global_vel.length()), config.max_speed);
+        double speed = std::min(config.max_speed, std::sqrt(end_speed * end_speed + 2 * dec * dist));
+        point2f desired = dist > 1e-3 ? to_target * float(speed / dist) : task.global_vel;
+
+        point2f dv = desired - last_vel[id];
+        double dv_len = dv.length();
+        double dv_max = acc * dt;
+        if (dv_len > dv_max) {
+            dv = dv * float(dv_max / dv_len);
+        }
+        last_vel[id] = last_vel[id] + dv;
+
+        double err = anglemod(task.orientate - model->get_our_player_dir(id));
+        double rot = std::min(config.max_rot_speed, std::sqrt(2 * config.rot_acc * std::fabs(err)));
+        rot = err < 0 ? -rot : rot;
+        double drot_max = config.rot_acc * dt;
+        last_rot[id] += std::max(-drot_max, std::min(drot_max, rot - last_rot[id]));
+
+        task.global_vel = last_vel[id];
+        task.rot_vel = last_rot[id];
+        task.rot_dir = last_rot[id] > 0 ? 1 : (last_rot[id] < 0 ? -1 : 0);
+    }
+
+    static long long now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    mutable std::mutex mutex;
+    RadioOutputConfig config;
+    RadioTransport* transport;
+    TaskPacketEncoder encoder;
+
+    int frame_cycle;
+    bool flushed;
+    RobotSet expected;
+    RobotSet submitted;
+    long long first_task_ns;
+    PlayerTask tasks[MAX_TEAM_ROBOTS];
+    point2f last_vel[MAX_TEAM_ROBOTS];
+    double last_rot[MAX_TEAM_ROBOTS];
+    unsigned char packet[TASK_PACKET_MAX_SIZE];
+
+    RadioFrameStats last;
+    long long frames_sent;
+    long long send_failures;
+    long long late;
+};
+
+#endif // RADIO_OUTPUT_H
@@ -0,0 +1,530 @@
+#ifndef REFEREE_RECEIVER_H
+#define REFEREE_RECEIVER_H
+
+#ifdef __linux__
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "pb_wire.h"
+#include "spsc_queue.h"
+#include "../utils/game_state.h"
+#include "../utils/vector.h"
+
+/**
+ * @brief SSL Referee消息中的命令（Referee.Command）
+ */
+enum RefereeCommand {
+    REF_HALT = 0,
+    REF_STOP = 1,
+    REF_NORMAL_START = 2,
+    REF_FORCE_START = 3,
+    REF_PREPARE_KICKOFF_YELLOW = 4,
+    REF_PREPARE_KICKOFF_BLUE = 5,
+    REF_PREPARE_PENALTY_YELLOW = 6,
+    REF_PREPARE_PENALTY_BLUE = 7,
+    REF_DIRECT_FREE_YELLOW = 8,
+    REF_DIRECT_FREE_BLUE = 9,
+    REF_INDIRECT_FREE_YELLOW = 10,
+    REF_INDIRECT_FREE_BLUE = 11,
+    REF_TIMEOUT_YELLOW = 12,
+    REF_TIMEOUT_BLUE = 13,
+    REF_GOAL_YELLOW = 14,
+    REF_GOAL_BLUE = 15,
+    REF_BALL_PLACEMENT_YELLOW = 16,
+    REF_BALL_PLACEMENT_BLUE = 17
+};
+
+/**
+ * @brief SSL Referee消息中的比赛阶段（Referee.Stage）
+ */
+enum RefereeStage {
+    REF_STAGE_NORMAL_FIRST_HALF_PRE = 0,
+    REF_STAGE_NORMAL_FIRST_HALF = 1,
+    REF_STAGE_NORMAL_HALF_TIME = 2,
+    REF_STAGE_NORMAL_SECOND_HALF_PRE = 3,
+    REF_STAGE_NORMAL_SECOND_HALF = 4,
+    REF_STAGE_EXTRA_TIME_BREAK = 5,
+    REF_STAGE_EXTRA_FIRST_HALF_PRE = 6,
+    REF_STAGE_EXTRA_FIRST_HALF = 7,
+    REF_STAGE_EXTRA_HALF_TIME = 8,
+    REF_STAGE_EXTRA_SECOND_HALF_PRE = 9,
+    REF_STAGE_EXTRA_SECOND_HALF = 10,
+    REF_STAGE_PENALTY_SHOOTOUT_BREAK = 11,
+    REF_STAGE_PENALTY_SHOOTOUT = 12,
+    REF_STAGE_POST_GAME = 13
+};
+
+/**
+ * @brief 解码后的一条裁判指令，按到达顺序进入队列
+ */
+struct RefereeEvent {
+    char command;                   // 对应的COMM_*字符，直接交给GameState::transition
+    int raw_command;                // 原始RefereeCommand，阶段变化事件为-1
+    int stage;                      // 当前比赛阶段RefereeStage
+    uint32_t command_counter;       // 裁判盒的指令计数
+    long long stage_time_left_us;   // 本阶段剩余时间(us)，可能为负（超时）
+    point2f designated_position;    // 摆球/任意球指定位置(cm)
+    bool has_designated_position;
+    double packet_time;             // 裁判盒发送时刻(s，UNIX时间)
+    double arrival_time;            // 到达时刻(s，与GameState相同的steady_clock)
+};
+
+/**
+ * @brief 网络裁判盒接收器
+ * 在接收线程（或RtLoop的滤波线程）中非阻塞地读取SSL Referee组播包，直接在缓冲区上解码，
+ * 只在指令计数或比赛阶段变化时生成RefereeEvent，带时间戳放入无锁队列；
+ * 规划线程在每帧开始时调用drain，把排队的指令按顺序交给GameState。
+ * 代替原来9600波特串口逐字符输入、没有时间信息的方式。
+ */
+class RefereeReceiver {
+public:
+    static const int PACKET_SIZE = 2048;
+    static const size_t QUEUE_SIZE = 64;
+
+    RefereeReceiver() : sock(-1), running(false), packets(0), parse_errors(0), dropped(0),
+        last_counter(-1), last_stage(-1), latest_event(), has_latest(false) {}
+
+    ~RefereeReceiver() {
+        stop();
+        close();
+    }
+
+    RefereeReceiver(const RefereeReceiver&) = delete;
+    RefereeReceiver& operator=(const RefereeReceiver&) = delete;
+
+    /**
+     * @brief 加入裁判盒组播组
+     * @param group 组播地址，SSL裁判盒默认224.5.23.1
+     * @param port 端口，SSL裁判盒默认10003
+     * @param iface 接收组播的本机网卡地址，0.0.0.0为系统默认
+     * @return 是否成功
+     */
+    bool open(const char* group = "224.5.23.1", int port = 10003, const char* iface = "0.0.0.0") {
+        close();
+        sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (sock < 0) {
+            return fail("socket");
+        }
+        int one = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            return fail("bind");
+        }
+
+        ip_mreq mreq;
+        std::memset(&mreq, 0, sizeof(mreq));
+        if (inet_pton(AF_INET, group, &mreq.imr_multiaddr) != 1 || inet_pton(AF_INET, iface, &mreq.imr_interface) != 1) {
+            errno = EINVAL;
+            return fail("multicast address");
+        }
+        if (setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+            return fail("IP_ADD_MEMBERSHIP");
+        }
+        return true;
+    }
+
+    void close() {
+        if (sock >= 0) {
+            ::close(sock);
+            sock = -1;
+        }
+    }
+
+    int fd() const { return sock; }
+
+    // ---------------- 生产者（接收线程） ----------------
+
+    /**
+     * @brief 读空套接字中已到达的裁判包，解码后入队，不阻塞
+     * @return 本次入队的事件数
+     */
+    int poll() {
+        if (sock < 0) {
+            return 0;
+        }
+        int queued = 0;
+        for (;;) {
+            ssize_t n = recv(sock, buffer, sizeof(buffer), MSG_DONTWAIT | MSG_TRUNC);
+            if (n < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    warn("recv");
+                }
+                break;
+            }
+            packets++;
+            if (n > static_cast<ssize_t>(sizeof(buffer))) {
+                parse_errors++;
+                continue;
+            }
+            queued += parsePacket(buffer, static_cast<size_t>(n), now());
+        }
+        return queued;
+    }
+
+    /**
+     * @brief 解码一个SSL Referee包并把新指令入队，供poll和测试使用；格式错误计入errorCount
+     * @param arrival_time 到达时刻(s)
+     * @return 入队的事件数
+     */
+    int parsePacket(const unsigned char* data, size_t size, double arrival_time) {
+        PbReader packet(data, size);
+        uint32_t field, wire;
+        RefereeEvent e = RefereeEvent();
+        e.arrival_time = arrival_time;
+        bool has_command = false, has_counter = false;
+        while (packet.next(field, wire)) {
+            switch (field) {
+                case 1: e.packet_time = packet.varint() * 1e-6; break;
+                case 2: e.stage = static_cast<int>(packet.varint()); break;
+                case 3: e.stage_time_left_us = packet.svarint(); break;
+                case 4: e.raw_command = static_cast<int>(packet.varint()); has_command = true; break;
+                case 5: e.command_counter = static_cast<uint32_t>(packet.varint()); has_counter = true; break;
+                case 9: {
+                    PbReader point = packet.message();
+                    e.designated_position = parsePoint(point);
+                    e.has_designated_position = point.ok();
+                    break;
+                }
+                default: packet.skip(wire); break;
+            }
+        }
+        if (!packet.ok() || !has_command || !has_counter) {
+            parse_errors++;
+            return 0;
+        }
+
+        int queued = 0;
+        // 阶段变化先于同一包中的指令，与原串口裁判盒的发送顺序一致
+        if (e.stage != last_stage) {
+            last_stage = e.stage;
+            char stage_command = stageCommand(e.stage);
+            if (stage_command) {
+                RefereeEvent s = e;
+                s.command = stage_command;
+                s.raw_command = -1;
+                queued += enqueue(s);
+            }
+        }
+        if (static_cast<long long>(e.command_counter) != last_counter) {
+            last_counter = e.command_counter;
+            e.command = commandChar(e.raw_command);
+            if (e.command) {
+                queued += enqueue(e);
+            }
+        }
+        return queued;
+    }
+
+    /**
+     * @brief 启动后台接收线程，阻塞在套接字上等待，stop()时退出
+     */
+    bool start() {
+        if (sock < 0 || running.load()) {
+            return false;
+        }
+        running.store(true);
+        worker = std::thread([this]() {
+            pollfd p;
+            p.fd = sock;
+            p.events = POLLIN;
+            while (running.load(std::memory_order_relaxed)) {
+                if (::poll(&p, 1, 100) > 0) {
+                    poll();
+                }
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        running.store(false);
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // ---------------- 消费者（规划线程） ----------------
+
+    /**
+     * @brief 取出一条排队的指令
+     */
+    bool pop(RefereeEvent& e) {
+        if (!queue.pop(e)) {
+            return false;
+        }
+        latest_event = e;
+        has_latest = true;
+        return true;
+    }
+
+    /**
+     * @brief 帧开始时调用：把排队的指令按到达顺序交给GameState，时间戳为到达时刻
+     * @param state 比赛状态机
+     * @param ball_kicked 球是否已被踢出（原transition的参数）
+     * @return 处理的指令数
+     */
+    int drain(GameState& state, bool ball_kicked) {
+        int n = 0;
+        RefereeEvent e;
+        while (pop(e)) {
+            state.transition(e.command, ball_kicked, e.arrival_time);
+            n++;
+        }
+        return n;
+    }
+
+    /**
+     * @brief 最近一条已被消费的指令（含阶段剩余时间和指定位置），没有时返回false
+     */
+    bool latest(RefereeEvent& e) const {
+        if (has_latest) {
+            e = latest_event;
+        }
+        return has_latest;
+    }
+
+    long long packetCount() const { return packets.load(std::memory_order_relaxed); }
+    long long errorCount() const { return parse_errors.load(std::memory_order_relaxed); }
+    long long droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief RefereeCommand转为COMM_*字符
+     * 摆球没有对应的串口指令，按STOP处理（状态机中视为比赛暂停），原始命令保留在raw_command中
+     * @return 未知命令返回0
+     */
+    static char commandChar(int command) {
+        switch (command) {
+            case REF_HALT: return COMM_HALT;
+            case REF_STOP: return COMM_STOP;
+            case REF_NORMAL_START: return COMM_READY;
+            case REF_FORCE_START: return COMM_START;
+            case REF_PREPARE_KICKOFF_YELLOW: return COMM_KICKOFF_YELLOW;
+            case REF_PREPARE_KICKOFF_BLUE: return COMM_KICKOFF_BLUE;
+            case REF_PREPARE_PENALTY_YELLOW: return COMM_PENALTY_YELLOW;
+            case REF_PREPARE_PENALTY_BLUE: return COMM_PENALTY_BLUE;
+            case REF_DIRECT_FREE_YELLOW: return COMM_DIRECT_YELLOW;
+            case REF_DIRECT_FREE_BLUE: return COMM_DIRECT_BLUE;
+            case REF_INDIRECT_FREE_YELLOW: return COMM_INDIRECT_YELLOW;
+            case REF_INDIRECT_FREE_BLUE: return COMM_INDIRECT_BLUE;
+            case REF_TIMEOUT_YELLOW: return COMM_TIMEOUT_YELLOW;
+            case REF_TIMEOUT_BLUE: return COMM_TIMEOUT_BLUE;
+            case REF_GOAL_YELLOW: return COMM_GOAL_YELLOW;
+            case REF_GOAL_BLUE: return COMM_GOAL_BLUE;
+            case REF_BALL_PLACEMENT_YELLOW:
+            case REF_BALL_PLACEMENT_BLUE: return COMM_STOP;
+            default: return 0;
+        }
+    }
+
+    /**
+     * @brief 比赛阶段转为COMM_*字符，只有原串口裁判盒会发送的阶段才有对应字符
+     * @return 没有对应字符返回0
+     */
+    static char stageCommand(int stage) {
+        switch (stage) {
+            case REF_STAGE_NORMAL_FIRST_HALF: return COMM_FIRST_HALF;
+            case REF_STAGE_NORMAL_HALF_TIME: return COMM_HALF_TIME;
+            case REF_STAGE_NORMAL_SECOND_HALF: return COMM_SECOND_HALF;
+            case REF_STAGE_EXTRA_FIRST_HALF: return COMM_OVER_TIME1;
+            case REF_STAGE_EXTRA_SECOND_HALF: return COMM_OVER_TIME2;
+            case REF_STAGE_PENALTY_SHOOTOUT: return COMM_PENALTY_SHOOTOUT;
+            default: return 0;
+        }
+    }
+
+private:
+    int enqueue(const RefereeEvent& e) {
+        if (!queue.push(e)) {
+            dropped++;
+            return 0;
+        }
+        return 1;
+    }
+
+    static point2f parsePoint(PbReader& point) {
+        uint32_t field, wire;
+        float x = 0, y = 0;
+        while (point.next(field, wire)) {
+            if (field == 1 && wire == PB_FIXED32) x = point.fixed32f();
+            else if (field == 2 && wire == PB_FIXED32) y = point.fixed32f();
+            else point.skip(wire);
+        }
+        return point2f(x * MM_TO_CM, y * MM_TO_CM);
+    }
+
+    static double now() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool fail(const char* what) {
+        warn(what);
+        close();
+        return false;
+    }
+
+    static void warn(const char* what) {
+        std::fprintf(stderr, "[RefereeReceiver] %s: %s\n", what, std::strerror(errno));
+    }
+
+    static constexpr float MM_TO_CM = 0.1f;
+
+    int sock;
+    std::atomic<bool> running;
+    std::thread worker;
+    std::atomic<long long> packets;
+    std::atomic<long long> parse_errors;
+    std::atomic<long long> dropped;
+
+    // 生产者线程私有
+    long long last_counter;
+    int last_stage;
+    unsigned char buffer[PACKET_SIZE];
+
+    SpscQueue<RefereeEvent, QUEUE_SIZE> queue;
+
+    // 消费者线程私有
+    RefereeEvent latest_event;
+    bool has_latest;
+};
+
+/**
+ * @brief 本地模拟裁判盒，向组播组发送SSL Referee包，用于联调和测试
+ * 每次sendCommand使指令计数加一；sendState只刷新阶段和剩余时间，接收端不会生成新指令。
+ */
+class FakeReferee {
+public:
+    static const int PACKET_SIZE = RefereeReceiver::PACKET_SIZE;
+
+    FakeReferee() : sock(-1), counter(0), command(REF_HALT), stage(REF_STAGE_NORMAL_FIRST_HALF_PRE),
+        stage_time_left_us(0), designated(0, 0), has_designated(false) {
+        std::memset(&dest, 0, sizeof(dest));
+    }
+
+    ~FakeReferee() {
+        close();
+    }
+
+    FakeReferee(const FakeReferee&) = delete;
+    FakeReferee& operator=(const FakeReferee&) = delete;
+
+    /**
+     * @brief 打开发送套接字，组播只在本机回环（TTL为0）
+     * @param group 组播地址
+     * @param port 端口
+     * @param iface 发送组播的本机网卡地址，须与RefereeReceiver::open的iface相同才能收到；0.0.0.0为系统默认
+     */
+    bool open(const char* group = "224.5.23.1", int port = 10003, const char* iface = "0.0.0.0") {
+        close();
+        sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (sock < 0) {
+            return false;
+        }
+        unsigned char ttl = 0, loop = 1;
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        in_addr local;
+        dest.sin_family = AF_INET;
+        dest.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, iface, &local) != 1 || inet_pton(AF_INET, group, &dest.sin_addr) != 1 ||
+            setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local)) != 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (sock >= 0) {
+            ::close(sock);
+            sock = -1;
+        }
+    }
+
+    /**
+     * @brief 发出一条新指令
+     * @param cmd RefereeCommand
+     * @param position 指定位置(cm)，为NULL时不带指定位置
+     */
+    bool sendCommand(int cmd, const point2f* position = NULL) {
+        counter++;
+        command = cmd;
+        has_designated = position != NULL;
+        if (position) {
+            designated = *position;
+        }
+        return sendState();
+    }
+
+    /**
+     * @brief 设置比赛阶段和剩余时间，下一次发送时生效
+     */
+    void setStage(int new_stage, long long time_left_us) {
+        stage = new_stage;
+        stage_time_left_us = time_left_us;
+    }
+
+    /**
+     * @brief 重发当前状态（裁判盒会周期性地重复发送）
+     */
+    bool sendState() {
+        unsigned char out[PACKET_SIZE];
+        int n = encode(out, sizeof(out));
+        return n > 0 && sock >= 0 &&
+               sendto(sock, out, n, 0, reinterpret_cast<const sockaddr*>(&dest), sizeof(dest)) == n;
+    }
+
+    /**
+     * @brief 把当前状态编码为SSL Referee包
+     * @return 编码长度，缓冲区不足返回-1
+     */
+    int encode(unsigned char* out, size_t capacity) const {
+        uint64_t t = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        PbWriter w(out, capacity);
+        w.uint64Field(1, t);
+        w.uint32Field(2, static_cast<uint32_t>(stage));
+        w.sint32Field(3, static_cast<int32_t>(stage_time_left_us));
+        w.uint32Field(4, static_cast<uint32_t>(command));
+        w.uint32Field(5, counter);
+        w.uint64Field(6, t);
+        if (has_designated) {
+            size_t point = w.beginMessage(9);
+            w.floatField(1, designated.x * CM_TO_MM);
+            w.floatField(2, designated.y * CM_TO_MM);
+            w.endMessage(point);
+        }
+        return w.overflow() ? -1 : static_cast<int>(w.size());
+    }
+
+private:
+    static constexpr float CM_TO_MM = 10.0f;
+
+    int sock;
+    sockaddr_in dest;
+    uint32_t counter;
+    int command;
+    int stage;
+    long long stage_time_left_us;
+    point2f designated;
+    bool has_designated;
+};
+
+#endif // __linux__
+
+#endif // REFEREE_RECEIVER_H
@@ -0,0 +1,457 @@
+#ifndef RT_LOOP_H
+#define RT_LOOP_H
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+/**
+ * @brief 实时循环配置
+ */
+struct RtLoopConfig {
+    long long frame_period_ns = 16666667;   // 帧周期(ns)，视觉60Hz
+    int vision_fd = -1;                     // 视觉数据fd（如组播UDP套接字），可读即为新帧；有滤波回调时由回调读空（如VisionReceiver::poll），没有时由循环丢弃，非套接字须为非阻塞；小于0时用定时器作为帧时钟
+    int filter_cpu = -1;                    // 滤波线程绑定的CPU核，-1不绑定
+    int planner_cpu = -1;                   // 规划线程绑定的CPU核，-1不绑定
+    bool use_fifo = false;                  // 是否使用SCHED_FIFO实时调度（需要CAP_SYS_NICE）
+    int filter_priority = 80;               // SCHED_FIFO优先级
+    int planner_priority = 79;
+    bool lock_memory = false;               // 是否mlockall锁定内存，避免缺页
+    int report_frames = 600;                // 每隔多少帧报告一次统计，0为不报告
+};
+
+/**
+ * @brief 定长直方图的时延统计，记录时不分配内存，可在实时线程中使用
+ */
+class LatencyStats {
+public:
+    static const int BUCKET_NS = 10000;     // 每个桶10us
+    static const int BUCKETS = 2000;        // 覆盖0~20ms，更大的值计入最后一个桶
+
+    LatencyStats() { reset(); }
+
+    void reset() {
+        std::memset(buckets, 0, sizeof(buckets));
+        samples = 0;
+        sum_ns = 0;
+        max_ns = 0;
+    }
+
+    void record(long long ns) {
+        if (ns < 0) ns = 0;
+        long long b = ns / BUCKET_NS;
+        buckets[b < BUCKETS ? b : BUCKETS - 1]++;
+        samples++;
+        sum_ns += ns;
+        if (ns > max_ns) max_ns = ns;
+    }
+
+    /**
+     * @brief 分位数，返回所在桶的上界(us)
+     * @param p 0~1
+     */
+    double percentileUs(double p) const {
+        if (samples == 0) return 0.0;
+        long long target = static_cast<long long>(p * samples + 0.5);
+        if (target < 1) target = 1;
+        long long acc = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            acc += buckets[i];
+            if (acc >= target) return (i + 1) * (BUCKET_NS / 1000.0);
+        }
+        return BUCKETS * (BUCKET_NS / 1000.0);
+    }
+
+    long long count() const { return samples; }
+    double meanUs() const { return samples ? sum_ns / 1000.0 / samples : 0.0; }
+    double maxUs() const { return max_ns / 1000.0; }
+
+private:
+    unsigned int buckets[BUCKETS];
+    long long samples;
+    long long sum_ns;
+    long long max_ns;
+};
+
+/**
+ * @brief 一个报告周期的统计结果
+ */
+struct RtLoopReport {
+    const char* name;           // "wakeup"（滤波线程被唤醒的抖动）或"latency"（帧开始到任务发出）
+    long long frames;
+    long long overruns;         // 错过的帧数（定时器到期多次才被处理）
+    double mean_us, p50_us, p99_us, max_us;
+};
+
+/**
+ * @brief 按视觉帧对齐的实时调度循环（Linux）
+ * 滤波线程在epoll上等待视觉fd或timerfd，醒来后记录唤醒抖动并运行滤波回调，
+ * 再通过eventfd把帧交给规划线程；规划线程运行规划回调（回调返回时任务已发出），
+ * 记录帧开始到任务发出的时延。两个线程可分别绑核、使用SCHED_FIFO，统计按报告周期输出。
+ */
+class RtLoop {
+public:
+    typedef std::function<void(long long frame)> FrameHandler;
+    typedef std::function<void(const RtLoopReport&)> Reporter;
+
+    explicit RtLoop(const RtLoopConfig& config) :
+        config(config),
+        running(false),
+        timer_fd(-1), handoff_fd(-1), stop_fd(-1),
+        frame_seq(0), frame_start_ns(0), frame_index(0),
+        reporter(defaultReporter) {}
+
+    ~RtLoop() {
+        stop();
+    }
+
+    RtLoop(const RtLoop&) = delete;
+    RtLoop& operator=(const RtLoop&) = delete;
+
+    /**
+     * @brief 设置统计报告回调，默认输出到stderr；回调在实时线程中执行，应尽量轻
+     */
+    void setReporter(Reporter r) {
+        reporter = r ? r : Reporter(defaultReporter);
+    }
+
+    /**
+     * @brief 启动滤波和规划线程
+     * @param filter 每帧先执行的滤波回调（接收视觉、更新世界模型），可以为空
+     * @param planner 每帧的规划回调，返回时本帧任务应已发出
+     * @return 是否启动成功
+     */
+    bool start(FrameHandler filter, FrameHandler planner) {
+        if (running.load()) return false;
+        on_filter = filter;
+        on_planner = planner;
+
+        if (config.lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            warn("mlockall failed", errno);
+        }
+
+        stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        handoff_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (stop_fd < 0 || handoff_fd < 0) {
+            warn("eventfd failed", errno);
+            closeFds();
+            return false;
+        }
+        if (config.vision_fd < 0) {
+            timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (timer_fd < 0) {
+                warn("timerfd_create failed", errno);
+                closeFds();
+                return false;
+            }
+        }
+
+        running.store(true);
+        filter_thread = std::thread(&RtLoop::filterLoop, this);
+        planner_thread = std::thread(&RtLoop::plannerLoop, this);
+        return true;
+    }
+
+    /**
+     * @brief 停止并等待两个线程退出
+     */
+    void stop() {
+        abortLoop();
+        if (filter_thread.joinable()) filter_thread.join();
+        if (planner_thread.joinable()) planner_thread.join();
+        closeFds();
+    }
+
+    bool isRunning() const { return running.load(); }
+
+    /**
+     * @brief 把当前线程绑定到指定CPU核
+     * @return 是否成功，cpu<0时不做处理并返回true
+     */
+    static bool pinCurrentThread(int cpu) {
+        if (cpu < 0) return true;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) warn("pthread_setaffinity_np failed", err);
+        return err == 0;
+    }
+
+    /**
+     * @brief 把当前线程切换为SCHED_FIFO
+     * @return 是否成功
+     */
+    static bool makeCurrentThreadFifo(int priority) {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) warn("pthread_setschedparam(SCHED_FIFO) failed", err);
+        return err == 0;
+    }
+
+    static long long nowNs() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+private:
+    void filterLoop() {
+        pinCurrentThread(config.filter_cpu);
+        if (config.use_fifo) makeCurrentThreadFifo(config.filter_priority);
+
+        int ep = epoll_create1(EPOLL_CLOEXEC);
+        int frame_fd = config.vision_fd >= 0 ? config.vision_fd : timer_fd;
+        if (ep < 0 || !watch(ep, frame_fd) || !watch(ep, stop_fd)) {
+            warn("filter epoll setup failed", errno);
+            if (ep >= 0) close(ep);
+            abortLoop();
+            return;
+        }
+
+        // 定时器用绝对时间，到期时刻固定在start + n * period上，抖动不会累积
+        long long expected = nowNs() + config.frame_period_ns;
+        if (timer_fd >= 0) {
+            itimerspec its;
+            its.it_value = toTimespec(expected);
+            its.it_interval = toTimespec(config.frame_period_ns);
+            timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+        }
+
+        LatencyStats wakeup;
+        long long overruns = 0;
+        long long last_wake = 0;
+        epoll_event events[2];
+        while (running.load()) {
+            int n = epoll_wait(ep, events, 2, -1);
+            long long wake = nowNs();
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                warn("filter epoll_wait failed", errno);
+                abortLoop();
+                break;
+            }
+            // 停止信号只用于唤醒，是否退出由running决定
+            bool frame = false;
+            for (int i = 0; i < n; i++) {
+                if (events[i].data.fd == frame_fd) frame = true;
+            }
+            if (!frame) continue;
+
+            if (timer_fd >= 0) {
+                uint64_t expirations = 0;
+                if (read(timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) continue;
+                // 到期多次说明错过了帧，抖动按最近一次到期计算
+                overruns += static_cast<long long>(expirations) - 1;
+                expected += static_cast<long long>(expirations - 1) * config.frame_period_ns;
+                wakeup.record(wake - expected);
+                expected += config.frame_period_ns;
+            } else if (last_wake > 0) {
+                // 视觉驱动时没有理论到期时刻，用帧间隔相对周期的偏差作为抖动
+                long long interval = wake - last_wake;
+                long long deviation = interval - config.frame_period_ns;
+                wakeup.record(deviation < 0 ? -deviation : deviation);
+                if (interval > config.frame_period_ns * 3 / 2) overruns += interval / config.frame_period_ns - 1;
+            }
+            last_wake = wake;
+
+            long long index = frame_index.load(std::memory_order_relaxed) + 1;
+            // epoll是水平触发，视觉fd里的数据不读走会让下一次epoll_wait立即返回，循环空转。
+            // 滤波回调负责读空fd；滤波期间才到达的数据（如另一个摄像头的包）留在fd里，下一次唤醒再处理，不能在这里丢弃
+            if (on_filter) on_filter(index);
+            else if (config.vision_fd >= 0) drain(config.vision_fd);
+
+            // 交给规划线程：帧号和帧开始时间在同一个顺序锁下发布，规划线程不会读到一新一旧
+            publishFrame(index, wake);
+            uint64_t one = 1;
+            if (write(handoff_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+                warn("handoff signal failed", errno);
+            }
+
+            if (config.report_frames > 0 && wakeup.count() >= config.report_frames) {
+                report("wakeup", wakeup, overruns);
+                wakeup.reset();
+                overruns = 0;
+            }
+        }
+        close(ep);
+    }
+
+    void plannerLoop() {
+        pinCurrentThread(config.planner_cpu);
+        if (config.use_fifo) makeCurrentThreadFifo(config.planner_priority);
+
+        int ep = epoll_create1(EPOLL_CLOEXEC);
+        if (ep < 0 || !watch(ep, handoff_fd) || !watch(ep, stop_fd)) {
+            warn("planner epoll setup failed", errno);
+            if (ep >= 0) close(ep);
+            abortLoop();
+            return;
+        }
+
+        LatencyStats latency;
+        long long skipped = 0;
+        long long last_index = 0;
+        epoll_event events[2];
+        while (running.load()) {
+            int n = epoll_wait(ep, events, 2, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                warn("planner epoll_wait failed", errno);
+                abortLoop();
+                break;
+            }
+            bool frame = false;
+            for (int i = 0; i < n; i++) {
+                if (events[i].data.fd == handoff_fd) frame = true;
+            }
+            if (!frame) continue;
+
+            uint64_t pending = 0;
+            if (read(handoff_fd, &pending, sizeof(pending)) != sizeof(pending)) continue;
+
+            // 只规划最新的一帧，规划跟不上时丢弃中间帧
+            long long index, start;
+            readFrame(index, start);
+            if (last_index > 0 && index - last_index > 1) skipped += index - last_index - 1;
+            last_index = index;
+
+            if (on_planner) on_planner(index);
+            latency.record(nowNs() - start);
+
+            if (config.report_frames > 0 && latency.count() >= config.report_frames) {
+                report("latency", latency, skipped);
+                latency.reset();
+                skipped = 0;
+            }
+        }
+        close(ep);
+    }
+
+    /**
+     * @brief 发布一帧（只由滤波线程调用）：序号改为奇数后写入帧号和开始时间，写完改回偶数
+     */
+    void publishFrame(long long index, long long start_ns) {
+        unsigned int s = frame_seq.load(std::memory_order_relaxed);
+        frame_seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        frame_start_ns.store(start_ns, std::memory_order_relaxed);
+        frame_index.store(index, std::memory_order_relaxed);
+        frame_seq.store(s + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief 读最新一帧的帧号和开始时间，读的过程中被改写时重读
+     */
+    void readFrame(long long& index, long long& start_ns) const {
+        unsigned int s1, s2;
+        do {
+            s1 = frame_seq.load(std::memory_order_acquire);
+            index = frame_index.load(std::memory_order_relaxed);
+            start_ns = frame_start_ns.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            s2 = frame_seq.load(std::memory_order_relaxed);
+        } while ((s1 & 1u) || s1 != s2);
+    }
+
+    /**
+     * @brief 丢弃fd中剩余的数据；套接字用MSG_DONTWAIT读，其他fd只在非阻塞时读
+     */
+    static void drain(int fd) {
+        char buf[2048];
+        for (;;) {
+            ssize_t r = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (r < 0 && errno == ENOTSOCK && (fcntl(fd, F_GETFL) & O_NONBLOCK)) {
+                r = read(fd, buf, sizeof(buf));
+            }
+            if (r <= 0) return;
+        }
+    }
+
+    /**
+     * @brief 置停止标记并唤醒两个线程；stop_fd计数不清零，之后的epoll_wait都会立即返回
+     */
+    void abortLoop() {
+        if (running.exchange(false)) {
+            uint64_t one = 1;
+            if (write(stop_fd, &one, sizeof(one)) < 0) {
+                warn("stop signal failed", errno);
+            }
+        }
+    }
+
+    void report(const char* name, const LatencyStats& stats, long long overruns) {
+        RtLoopReport r;
+        r.name = name;
+        r.frames = stats.count();
+        r.overruns = overruns;
+        r.mean_us = stats.meanUs();
+        r.p50_us = stats.percentileUs(0.50);
+        r.p99_us = stats.percentileUs(0.99);
+        r.max_us = stats.maxUs();
+        reporter(r);
+    }
+
+    static void defaultReporter(const RtLoopReport& r) {
+        std::fprintf(stderr, "[RtLoop] %s: frames=%lld overruns=%lld mean=%.1fus p50=%.1fus p99=%.1fus max=%.1fus\n",
+                     r.name, r.frames, r.overruns, r.mean_us, r.p50_us, r.p99_us, r.max_us);
+    }
+
+    static void warn(const char* what, int err) {
+        std::fprintf(stderr, "[RtLoop] %s: %s\n", what, std::strerror(err));
+    }
+
+    static bool watch(int ep, int fd) {
+        epoll_event ev;
+        std::memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        return epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev) == 0;
+    }
+
+    static timespec toTimespec(long long ns) {
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+        return ts;
+    }
+
+    void closeFds() {
+        if (timer_fd >= 0) close(timer_fd);
+        if (handoff_fd >= 0) close(handoff_fd);
+        if (stop_fd >= 0) close(stop_fd);
+        timer_fd = handoff_fd = stop_fd = -1;
+    }
+
+    RtLoopConfig config;
+    std::atomic<bool> running;
+    int timer_fd, handoff_fd, stop_fd;
+    std::atomic<unsigned int> frame_seq;        // 帧号和帧开始时间的顺序锁，奇数表示正在写
+    std::atomic<long long> frame_start_ns;      // 最新一帧的开始时刻（滤波线程被唤醒的时刻）
+    std::atomic<long long> frame_index;         // 最新一帧的帧号
+    FrameHandler on_filter, on_planner;
+    Reporter reporter;
+    std::thread filter_thread, planner_thread;
+};
+
+#endif // __linux__
+
+#endif // RT_LOOP_H
@@ -0,0 +1,248 @@
+#ifndef RULE_PROJECTION_H
+#define RULE_PROJECTION_H
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include "../utils/worldmodel.h"
+#include "../utils/PlayerTask.h"
+#include "../utils/constants.h"
+#include "../utils/field_geometry.h"
+#include "../utils/vector.h"
+#include "../utils/play_mode.h"
+
+/**
+ * @brief 规则投影的球员标记
+ */
+enum RuleRobotFlag : unsigned char {
+    RULE_FIELD_PLAYER = 0,
+    RULE_GOALIE = 1 << 0,       // 守门员：可以进入我方禁区
+    RULE_KICKER = 1 << 1        // 定位球主罚者：不受开球中圈、点球站位限制
+};
+
+/**
+ * @brief 规则合规投影
+ * 所有战术规划完成后，把本帧输出任务的目标点投影出当前比赛模式下的禁区：
+ * 双方禁区、停止状态和对方定位球时的避让圆、开球时的中圈和本方半场、点球时的站位线以及场地边界。
+ * 禁区按Field的圆角矩形计算，老场地的D形禁区和A/B组的矩形禁区都是精确的。
+ * 区域几何每帧按比赛模式和球的位置预先计算一次，投影对所有目标点逐个约束批量进行，内层循环无分支。
+ */
+class RuleProjection {
+public:
+    static constexpr double FIELD_MARGIN = 30.0;        // 场上球员离边线的距离(cm)
+    static constexpr double PENALTY_MARK_BEHIND = 40.0; // 点球时其他球员在罚球点后方的距离(cm)
+    static const int MAX_TARGETS = MAX_ROBOTS;
+
+    /**
+     * @brief 获取单例实例
+     * @return 规则投影实例
+     */
+    static RuleProjection& getInstance() {
+        static RuleProjection instance;
+        return instance;
+    }
+
+    RuleProjection() :
+        prepared_cycle(-1),
+        area_r(0.0f), area_half(0.0f), area_depth(0.0f),
+        circle_on(0.0f), circle_kicker_exempt(0.0f), circle_x(0.0f), circle_y(0.0f), circle_r(0.0f),
+        x_min(0.0f), x_max(0.0f), y_max(0.0f), goalie_x_min(0.0f),
+        line_kicker_exempt(0.0f), line_min(0.0f), line_max(0.0f) {}
+
+    /**
+     * @brief 按当前比赛模式和球的位置预先计算区域几何，同一帧重复调用直接返回
+     * @param model 世界模型指针
+     */
+    void prepare(const WorldModel* model) {
+        int cycle = model->get_cycle();
+        if (cycle == prepared_cycle) {
+            return;
+        }
+        prepared_cycle = cycle;
+
+        PlayMode mode = model->get_play_mode();
+        const point2f& ball = model->get_ball_pos();
+        const float robot_r = float(MAX_ROBOT_SIZE);
+
+        // 禁区：到禁区矩形距离小于半径的区域（老场地矩形深度为0，即D形），任何时候场上球员都不能进入
+        area_r = float(Field::DEFENSE_RADIUS + MAX_ROBOT_SIZE + PENALTY_BUFF);
+        area_half = float(Field::DEFENSE_WIDTH_H);
+        area_depth = float(Field::DEFENSE_DEPTH);
+
+        // 避让圆：停止状态离球Stop_Dist，对方定位球离球Free_Kick_Away_Dist，开球时为中圈
+        circle_on = 0.0f;
+        circle_kicker_exempt = 0.0f;
+        circle_x = ball.x;
+        circle_y = ball.y;
+        circle_r = 0.0f;
+        if (mode == PlayMode::Stop) {
+            circle_on = 1.0f;
+            circle_r = float(RuleParam::Stop_Dist) + robot_r;
+        } else if (mode == PlayMode::OppFreeKick) {
+            circle_on = 1.0f;
+            circle_r = float(RuleParam::Free_Kick_Away_Dist) + robot_r;
+        } else if (mode == PlayMode::OurKickOff || mode == PlayMode::OppKickOff) {
+            circle_on = 1.0f;
+            circle_kicker_exempt = (mode == PlayMode::OurKickOff) ? 1.0f : 0.0f;
+            circle_x = 0.0f;
+            circle_y = 0.0f;
+            circle_r = float(CENTER_CIRCLE_RADIUS) + robot_r;
+        }
+
+        // x方向的上下限：开球时留在本方半场，点球时其他球员在罚球点后方
+        x_min = -float(FIELD_LENGTH_H - FIELD_MARGIN);
+        x_max = float(FIELD_LENGTH_H - FIELD_MARGIN);
+        line_kicker_exempt = 0.0f;
+        line_max = x_max;
+        line_min = x_min;
+        if (mode == PlayMode::OurKickOff || mode == PlayMode::OppKickOff) {
+            line_kicker_exempt = (mode == PlayMode::OurKickOff) ? 1.0f : 0.0f;
+            line_max = -robot_r;
+        } else if (mode == PlayMode::OurPenaltyKick) {
+            line_kicker_exempt = 1.0f;
+            line_max = ball.x - float(PENALTY_MARK_BEHIND);
+        } else if (mode == PlayMode::OppPenaltyKick) {
+            line_min = ball.x + float(PENALTY_MARK_BEHIND);
+        }
+        y_max = float(FIELD_WIDTH_H - FIELD_MARGIN);
+        goalie_x_min = -float(FIELD_LENGTH_H - MAX_ROBOT_SIZE);
+    }
+
+    /**
+     * @brief 批量投影目标点，需先调用prepare
+     * @param x 目标点x坐标数组，原地修改
+     * @param y 目标点y坐标数组，原地修改
+     * @param flags 每个目标的RuleRobotFlag
+     * @param n 目标数量
+     */
+    void project(float* x, float* y, const unsigned char* flags, int n) const {
+        n = std::min(n, static_cast<int>(MAX_TARGETS));
+        float goalie[MAX_TARGETS], kicker[MAX_TARGETS];
+        for (int i = 0; i < n; i++) {
+            goalie[i] = (flags[i] & RULE_GOALIE) ? 1.0f : 0.0f;
+            kicker[i] = (flags[i] & RULE_KICKER) ? 1.0f : 0.0f;
+        }
+
+        // 推出一个区域可能进入另一个区域，做两遍
+        for (int pass = 0; pass < 2; pass++) {
+            // 1. 我方禁区（守门员除外）和对方禁区
+            pushOutOfArea(x, y, goalie, n, -1.0f);
+            pushOutOfArea(x, y, NULL, n, 1.0f);
+
+            // 2. 避让圆
+            if (circle_on > 0.0f) {
+                for (int i = 0; i < n; i++) {
+                    float dx = x[i] - circle_x;
+                    float dy = y[i] - circle_y;
+                    float d = std::sqrt(dx * dx + dy * dy);
+                    float inside = (d < circle_r) ? 1.0f : 0.0f;
+                    float apply = inside * (1.0f - kicker[i] * circle_kicker_exempt);
+                    // 目标恰好在圆心时朝本方球门方向推出
+                    float ux = (d > 1e-3f) ? dx / d : -1.0f;
+                    float uy = (d > 1e-3f) ? dy / d : 0.0f;
+                    x[i] += apply * (circle_x + ux * circle_r - x[i]);
+                    y[i] += apply * (circle_y + uy * circle_r - y[i]);
+                }
+            }
+
+            // 3. 站位线和场地边界；守门员不受站位线限制，可以贴近本方底线
+            for (int i = 0; i < n; i++) {
+                float line_on = (1.0f - kicker[i] * line_kicker_exempt) * (1.0f - goalie[i]);
+                float bound_lo = x_min + goalie[i] * (goalie_x_min - x_min);
+                float lo = std::max(bound_lo, line_on * line_min + (1.0f - line_on) * bound_lo);
+                float hi = std::min(x_max, line_on * line_max + (1.0f - line_on) * x_max);
+                x[i] = std::min(std::max(x[i], lo), std::max(hi, lo));
+                y[i] = std::min(std::max(y[i], -y_max), y_max);
+            }
+        }
+    }
+
+    /**
+     * @brief 投影一组任务的目标点
+     * 主罚者按角色指定而不是按needKick判断：needKick要到接近球时才置位，
+     * 在此之前主罚者的目标（球的位置）会被推出中圈或点球站位线，永远到不了球边
+     * @param model 世界模型指针
+     * @param ids 每个任务对应的球员ID
+     * @param tasks 任务数组，原地修改
+     * @param n 任务数量
+     * @param kicker_id 本帧定位球主罚者的ID，没有时为-1
+     */
+    void projectTasks(const WorldModel* model, const int* ids, PlayerTask* tasks, int n, int kicker_id) {
+        prepare(model);
+        n = std::min(n, static_cast<int>(MAX_TARGETS));
+        float x[MAX_TARGETS], y[MAX_TARGETS];
+        unsigned char flags[MAX_TARGETS];
+        int goalie_id = model->get_our_goalie();
+        for (int i = 0; i < n; i++) {
+            x[i] = tasks[i].target_pos.x;
+            y[i] = tasks[i].target_pos.y;
+            flags[i] = (ids[i] == goalie_id ? RULE_GOALIE : RULE_FIELD_PLAYER) | (ids[i] == kicker_id ? RULE_KICKER : 0);
+        }
+        project(x, y, flags, n);
+        for (int i = 0; i < n; i++) {
+            tasks[i].target_pos = point2f(x[i], y[i]);
+        }
+    }
+
+    /**
+     * @brief 投影单个任务的目标点
+     * @param model 世界模型指针
+     * @param robot_id 球员ID
+     * @param task 任务，原地修改
+     * @param kicker_id 本帧定位球主罚者的ID，没有时为-1
+     */
+    void projectTask(const WorldModel* model, int robot_id, PlayerTask& task, int kicker_id) {
+        projectTasks(model, &robot_id, &task, 1, kicker_id);
+    }
+
+private:
+    RuleProjection(const RuleProjection&) = delete;
+    RuleProjection& operator=(const RuleProjection&) = delete;
+
+    /**
+     * @brief 把目标点推出一侧的禁区
+     * @param exempt 不受限制的目标标记（1表示不受限），可以为NULL
+     * @param side -1为我方禁区，1为对方禁区
+     */
+    void pushOutOfArea(float* x, float* y, const float* exempt, int n, float side) const {
+        const float gx = side * float(Field::LENGTH_H);
+        for (int i = 0; i < n; i++) {
+            // 到禁区矩形的最近点及距离，u为离球门线的距离，指向场内为正
+            float u = (x[i] - gx) * -side;
+            float ay = std::fabs(y[i]);
+            float sy = (y[i] < 0.0f) ? -1.0f : 1.0f;
+            float cu = std::min(u, area_depth);
+            float cy = std::min(ay, area_half);
+            float du = u - cu;
+            float dy = ay - cy;
+            float d = std::sqrt(du * du + dy * dy);
+            float inside = (d < area_r) ? 1.0f : 0.0f;
+            float apply = inside * (exempt ? 1.0f - exempt[i] : 1.0f);
+            // 在球门线前且在矩形外：沿最近点方向推到边界上
+            float round = (d > 1e-3f && u > 0.0f) ? 1.0f : 0.0f;
+            float inv_d = 1.0f / std::max(d, 1e-3f);
+            float ru = cu + du * inv_d * area_r;
+            float ry = cy + dy * inv_d * area_r;
+            // 在矩形内、球门线上或场外：沿场内方向推出；矩形有深度时从正面和侧面中较近的一边推出
+            float front = area_depth + area_r - u;
+            float lateral = area_half + area_r - ay;
+            float sideways = (u > 0.0f && lateral < front) ? 1.0f : 0.0f;
+            float fu = u + (1.0f - sideways) * (area_depth + area_r - u);
+            float fy = cy + sideways * (area_half + area_r - cy);
+            float nu = round * ru + (1.0f - round) * fu;
+            float ny = sy * (round * ry + (1.0f - round) * fy);
+            x[i] += apply * (gx - side * nu - x[i]);
+            y[i] += apply * (ny - y[i]);
+        }
+    }
+
+    int prepared_cycle;
+
+    float area_r, area_half, area_depth;                        // 禁区圆角半径（已加车身）、矩形半宽和深度
+    float circle_on, circle_kicker_exempt;                      // 避让圆是否生效，主罚者是否不受限
+    float circle_x, circle_y, circle_r;                         // 避让圆
+    float x_min, x_max, y_max, goalie_x_min;                    // 场地边界
+    float line_kicker_exempt, line_min, line_max;               // 开球、点球站位线
+};
+
+#endif // RULE_PROJECTION_H
@@ -0,0 +1,495 @@
+#ifndef SET_PIECE_PLANNER_H
+#define SET_PIECE_PLANNER_H
+
+#include <cmath>
+#include <vector>
+#include "../utils/worldmodel.h"
+#include "../utils/PlayerTask.h"
+#include "../utils/play_mode.h"
+#include "../utils/constants.h"
+#include "../utils/vector.h"
+#include "../utils/maths.h"
+
+/**
+ * @brief 定位球类型
+ */
+enum class SetPieceKind {
+    KICKOFF,        // 开球
+    FREE_KICK,      // 任意球
+    CORNER_KICK     // 角球
+};
+
+/**
+ * @brief 判断球是否在角球位置（任意球在角落时按角球处理）
+ * @param ball_pos 球位置
+ * @param attacking true表示我方角球（对方底线角落），false表示对方角球
+ * @return 是否为角球位置
+ */
+inline bool isCornerPosition(const point2f& ball_pos, bool attacking) {
+    double x = attacking ? ball_pos.x : -ball_pos.x;
+    return x > FIELD_LENGTH_H - 50 && fabs(ball_pos.y) > FIELD_WIDTH_H - 50;
+}
+
+/**
+ * @brief 预先计算好的定位球方案
+ */
+struct SetPiecePlan {
+    bool valid;                                 // 方案是否有效
+    SetPieceKind kind;                          // 定位球类型
+    point2f ball_pos;                           // 计算方案时的球位置
+    int kicker_id;                              // 主罚球员
+    int receiver_id;                            // 接球球员，直接射门时为-1
+    point2f kick_target;                        // 踢球目标点
+    double kick_power;                          // 踢球力度
+    bool is_pass;                               // 是否为传球
+    double score;                               // 方案评分
+    point2f support_pos[MAX_TEAM_ROBOTS];       // 其余球员的站位
+    bool has_support[MAX_TEAM_ROBOTS];          // 该球员是否分配了站位
+
+    SetPiecePlan() : valid(false), kind(SetPieceKind::FREE_KICK), kicker_id(-1), receiver_id(-1),
+                     kick_power(0.0), is_pass(false), score(-1.0) {
+        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
+            has_support[i] = false;
+        }
+    }
+};
+
+/**
+ * @brief 定位球方案预计算器
+ * 比赛处于GAME_OFF或定位球等待开始时，把所有(主罚球员, 目标点)组合分摊到若干帧中
+ * 用较重的评估函数穷举评估；完成后把方案放入就绪缓冲区，开球指令到来时战术直接查表。
+ * 停止阶段和开球准备阶段持续期间会周期性地重新搜索，对手站位变化后方案随之更新；定位球可以开踢后方案冻结，不再重新搜索。
+ */
+class SetPiecePlanner {
+public:
+    /**
+     * @brief 获取默认实例
+     * @return 默认定位球方案预计算器
+     */
+    static SetPiecePlanner& getInstance() {
+        static SetPiecePlanner instance;
+        return instance;
+    }
+
+    /**
+     * @brief 独立的预计算器，由PlannerContext持有；getInstance()为默认实例
+     */
+    SetPiecePlanner() :
+        last_cycle(-1),
+        searching(false),
+        was_planning(false),
+        frames_since_search(0),
+        next_candidate(0),
+        best_score(-1.0) {}
+
+    /**
+     * @brief 每帧调用一次，推进预计算阶段
+     * 同一帧内重复调用不会重复计算
+     * @param model 世界模型指针
+     */
+    void update(const WorldModel* model) {
+        int cycle = model->get_cycle();
+        if (cycle == last_cycle) {
+            return;
+        }
+        last_cycle = cycle;
+
+        PlayMode mode = model->get_play_mode();
+        if (!isPlanningPhase(mode)) {
+            // 比赛进行中：停止搜索，就绪方案保留到下一次停止阶段
+            searching = false;
+            was_planning = false;
+            return;
+        }
+
+        point2f ball_pos = model->get_ball_pos();
+        SetPieceKind kind = classify(mode, ball_pos);
+
+        // 定位球已经可以开踢（任意球指令下达，或开球收到开始指令），球员正在执行方案；
+        // 开球的准备阶段(NOTREADY)仍按停止阶段处理，继续预计算
+        const GameState* game_state = model->game_states();
+        bool restart_live = mode != PlayMode::Stop && game_state && game_state->canKickBall();
+
+        // 新的停止阶段开始、球被重新摆放或定位球类型与方案不符时，旧的就绪方案不再可用；
+        // 可以开踢后主罚球员接近、触碰球会让球移动，这时不再按球的位置作废方案
+        if (ready.valid && (!was_planning || ready.kind != kind ||
+                            (!restart_live && (ball_pos - ready.ball_pos).length() > BALL_MOVED_DIST))) {
+            ready.valid = false;
+        }
+
+        bool restart_search;
+        if (restart_live) {
+            // 可以开踢后方案冻结，主罚球员和目标在接近球的过程中不再变化；
+            // 只有此时还没有可用方案（准备阶段没算完或类型猜错）才搜索，搜完即冻结
+            restart_search = !ready.valid && (!searching || kind != working.kind);
+            if (ready.valid) {
+                // 停止阶段里还在进行的定期重算作废，避免算完后替换掉正在执行的方案
+                searching = false;
+            }
+        } else {
+            // 刚进入停止或开球准备阶段、定位球类型确定、球被重新摆放或到了定期重算时间时重新搜索
+            restart_search = !was_planning || kind != working.kind ||
+                             (ball_pos - working.ball_pos).length() > BALL_MOVED_DIST ||
+                             (!searching && frames_since_search >= REPLAN_FRAMES);
+        }
+        was_planning = true;
+        if (restart_search) {
+            beginSearch(model, kind, ball_pos);
+        }
+
+        frames_since_search++;
+        if (searching) {
+            step(model);
+        }
+    }
+
+    /**
+     * @brief 获取已就绪的定位球方案
+     * @param kind 定位球类型
+     * @return 就绪方案，尚未算完或类型不符时返回nullptr
+     */
+    const SetPiecePlan* getReadyPlan(SetPieceKind kind) const {
+        if (!ready.valid || ready.kind != kind) {
+            return nullptr;
+        }
+        return &ready;
+    }
+
+    /**
+     * @brief 按方案生成某个球员的任务
+     * @param model 世界模型指针
+     * @param plan 定位球方案
+     * @param robot_id 机器人ID
+     * @param task 输出的任务
+     */
+    static void fillTask(const WorldModel* model, const SetPiecePlan& plan, int robot_id, PlayerTask& task) {
+        point2f ball_pos = model->get_ball_pos();
+
+        if (robot_id == plan.kicker_id) {
+            // 主罚球员：移动到球位置，面向方案目标，接近后按方案踢球
+            task.target_pos = ball_pos;
+            task.orientate = atan2(plan.kick_target.y - ball_pos.y, plan.kick_target.x - ball_pos.x);
+
+            point2f robot_pos = model->get_our_player_pos(robot_id);
+            if ((robot_pos - ball_pos).length() < 30) {
+                task.needKick = true;
+                task.isPass = plan.is_pass;
+                task.kickPower = plan.kick_power;
+            }
+        } else if (robot_id >= 0 && robot_id < MAX_TEAM_ROBOTS && plan.has_support[robot_id]) {
+            // 接应球员：前往预先分配的站位，面向球
+            const point2f& pos = plan.support_pos[robot_id];
+            task.target_pos = pos;
+            task.orientate = atan2(ball_pos.y - pos.y, ball_pos.x - pos.x);
+        } else {
+            // 没有分配站位的球员（如守门员）原地面向球
+            point2f robot_pos = model->get_our_player_pos(robot_id);
+            task.target_pos = robot_pos;
+            task.orientate = atan2(ball_pos.y - robot_pos.y, ball_pos.x - robot_pos.x);
+        }
+    }
+
+private:
+    // 禁止拷贝和赋值
+    SetPiecePlanner(const SetPiecePlanner&) = delete;
+    SetPiecePlanner& operator=(const SetPiecePlanner&) = delete;
+
+    /**
+     * @brief 候选方案：主罚球员 + 踢球目标
+     */
+    struct Candidate {
+        int kicker_id;
+        int receiver_id;        // 直接射门时为-1
+        point2f target;
+    };
+
+    static const int CANDIDATES_PER_FRAME = 24;     // 每帧最多评估的候选数
+    static const int REPLAN_FRAMES = 30;            // 停止阶段中重新搜索的间隔帧数
+    static const int AIM_POINTS = 5;                // 球门上的射门瞄准点数量
+    static const int SUPPORT_GRID_X = 6;            // 接应站位网格列数
+    static const int SUPPORT_GRID_Y = 5;            // 接应站位网格行数
+    static constexpr double BALL_MOVED_DIST = 10.0; // 球移动超过该距离视为重新摆放(cm)
+    static constexpr double ROBOT_SPEED = 200.0;    // 对手拦截速度估计(cm/s)
+    static constexpr double PASS_SPEED = 300.0;     // 传球平均速度估计(cm/s)
+    static constexpr double SHOT_POWER = 8.0;       // 射门力度
+
+    /**
+     * @brief 是否处于可以预计算的阶段：停止或我方开球/任意球尚未开始（点球不需要方案）
+     */
+    static bool isPlanningPhase(PlayMode mode) {
+        return mode == PlayMode::Stop || mode == PlayMode::OurKickOff || mode == PlayMode::OurFreeKick;
+    }
+
+    /**
+     * @brief 判断即将进行的定位球类型
+     * 裁判指令已下达时以指令为准，否则根据球的位置推测
+     */
+    static SetPieceKind classify(PlayMode mode, const point2f& ball_pos) {
+        if (mode == PlayMode::OurKickOff) {
+            return SetPieceKind::KICKOFF;
+        }
+        if (mode == PlayMode::Stop && ball_pos.length() < CENTER_CIRCLE_RADIUS * 0.2) {
+            return SetPieceKind::KICKOFF;
+        }
+        if (isCornerPosition(ball_pos, true)) {
+            return SetPieceKind::CORNER_KICK;
+        }
+        return SetPieceKind::FREE_KICK;
+    }
+
+    /**
+     * @brief 开始新一轮搜索：生成所有候选
+     */
+    void beginSearch(const WorldModel* model, SetPieceKind kind, const point2f& ball_pos) {
+        candidates.clear();
+        next_candidate = 0;
+        best_score = -1.0;
+        frames_since_search = 0;
+        searching = true;
+
+        working = SetPiecePlan();
+        working.kind = kind;
+        working.ball_pos = ball_pos;
+
+        RobotSet field_players = model->get_our_field_set();
+
+        for (int kicker : field_players) {
+
+            // 直接射门：球门上均匀分布的瞄准点
+            for (int k = 0; k < AIM_POINTS; k++) {
+                Candidate c;
+                c.kicker_id = kicker;
+                c.receiver_id = -1;
+                c.target = point2f(FIELD_LENGTH_H, -GOAL_WIDTH_H + GOAL_WIDTH * (k + 0.5) / AIM_POINTS);
+                candidates.push_back(c);
+            }
+
+            // 传球：每个队友当前位置
+            for (int receiver : field_players - RobotSet::single(kicker)) {
+                point2f target = model->get_our_player_pos(receiver);
+                // 开球时所有球员必须在本方半场
+                if (kind == SetPieceKind::KICKOFF && target.x > 0) continue;
+                Candidate c;
+                c.kicker_id = kicker;
+                c.receiver_id = receiver;
+                c.target = target;
+                candidates.push_back(c);
+            }
+        }
+    }
+
+    /**
+     * @brief 推进一帧的搜索，搜索完成后生成接应站位并发布方案
+     */
+    void step(const WorldModel* model) {
+        int end = next_candidate + CANDIDATES_PER_FRAME;
+        if (end > static_cast<int>(candidates.size())) {
+            end = static_cast<int>(candidates.size());
+        }
+
+        for (; next_candidate < end; next_candidate++) {
+            const Candidate& c = candidates[next_candidate];
+            double score = evaluateCandidate(model, c);
+            if (score > best_score) {
+                best_score = score;
+                working.kicker_id = c.kicker_id;
+                working.receiver_id = c.receiver_id;
+                working.kick_target = c.target;
+                working.is_pass = (c.receiver_id >= 0);
+                working.kick_power = working.is_pass ? passPower((c.target - working.ball_pos).length()) : SHOT_POWER;
+                working.score = score;
+            }
+        }
+
+        if (next_candidate < static_cast<int>(candidates.size())) {
+            return;
+        }
+
+        // 所有候选评估完毕
+        searching = false;
+        if (working.kicker_id < 0) {
+            return;
+        }
+        assignSupport(model);
+        working.valid = true;
+        ready = working;
+    }
+
+    /**
+     * @brief 评估单个候选方案
+     * 综合主罚球员到位距离、路线上所有对手的拦截可能以及落点的射门角度
+     * @return 评分，越大越好
+     */
+    double evaluateCandidate(const WorldModel* model, const Candidate& c) const {
+        const point2f& ball_pos = working.ball_pos;
+        point2f kicker_pos = model->get_our_player_pos(c.kicker_id);
+
+        // 主罚球员离球越近越快到位
+        double approach = 1.0 - std::min((kicker_pos - ball_pos).length() / FIELD_LENGTH, 1.0);
+
+        // 路线安全性：对手到路线的时间与球到达该点时间之比
+        double lane = laneSafety(model, ball_pos, c.target);
+
+        if (c.receiver_id < 0) {
+            // 直接射门：路线安全且距离不远
+            double dist = (c.target - ball_pos).length();
+            double range = 1.0 - std::min(dist / FIELD_LENGTH_H, 1.0);
+            // 开球和角球一般不直接射门
+            double kind_factor = (working.kind == SetPieceKind::FREE_KICK) ? 1.0 : 0.3;
+            return kind_factor * (0.6 * lane + 0.3 * range + 0.1 * approach);
+        }
+
+        // 传球：接球点射门角度越大越好，传球距离适中
+        double pass_dist = (c.target - ball_pos).length();
+        double dist_score = (pass_dist < 50) ? 0.2 : 1.0 - std::min(fabs(pass_dist - 200.0) / 300.0, 1.0);
+        double shot = shotOpenness(model, c.target);
+        return 0.45 * lane + 0.3 * shot + 0.15 * dist_score + 0.1 * approach;
+    }
+
+    /**
+     * @brief 计算路线安全性
+     * 对每个对手求其到路线最近点的时间，与球到达该点的时间比较
+     * @return 0到1，1表示没有对手能拦截
+     */
+    static double laneSafety(const WorldModel* model, const point2f& from, const point2f& to) {
+        point2f seg = to - from;
+        double seg_len = seg.length();
+        if (seg_len < 1.0) {
+            return 1.0;
+        }
+
+        double worst = 1.0;
+        for (int i : model->get_opp_set()) {
+            const point2f& opp = model->get_opp_player_pos(i);
+
+            double t = ((opp.x - from.x) * seg.x + (opp.y - from.y) * seg.y) / (seg_len * seg_len);
+            if (t < 0.0 || t > 1.0) continue;
+
+            point2f closest = from + seg * static_cast<float>(t);
+            double opp_time = std::max((opp - closest).length() - MAX_ROBOT_SIZE - BALL_SIZE, 0.0) / ROBOT_SPEED;
+            double ball_time = t * seg_len / PASS_SPEED;
+            double ratio = (ball_time > 1e-3) ? opp_time / ball_time : 1.0;
+            if (ratio < worst) {
+                worst = ratio;
+            }
+        }
+        return std::max(std::min(worst, 1.0), 0.0);
+    }
+
+    /**
+     * @brief 计算某点射门的无遮挡程度
+     * @return 0到1，球门上未被对手遮挡的瞄准点比例
+     */
+    static double shotOpenness(const WorldModel* model, const point2f& from) {
+        int open = 0;
+        for (int k = 0; k < AIM_POINTS; k++) {
+            point2f aim(FIELD_LENGTH_H, -GOAL_WIDTH_H + GOAL_WIDTH * (k + 0.5) / AIM_POINTS);
+            if (laneSafety(model, from, aim) > 0.8) {
+                open++;
+            }
+        }
+        // 离球门太远时射门价值降低
+        double dist = (point2f(FIELD_LENGTH_H, 0) - from).length();
+        double range = 1.0 - std::min(dist / FIELD_LENGTH, 1.0);
+        return (static_cast<double>(open) / AIM_POINTS) * range;
+    }
+
+    /**
+     * @brief 根据传球距离计算力度
+     */
+    static double passPower(double dist) {
+        return Maths::clip(1.5 + dist * 0.005, 2.0, 5.0);
+    }
+
+    /**
+     * @brief 判断站位在当前定位球下是否合法
+     */
+    bool isLegalSupport(const point2f& pos) const {
+        if (fabs(pos.x) > FIELD_LENGTH_H - 30 || fabs(pos.y) > FIELD_WIDTH_H - 30) {
+            return false;
+        }
+        if (Maths::is_inside_penatly(pos)) {
+            return false;
+        }
+        // 对方禁区
+        if (Maths::is_inside_penatly(point2f(-pos.x, pos.y))) {
+            return false;
+        }
+        if (working.kind == SetPieceKind::KICKOFF) {
+            // 开球：本方半场且在中圈外
+            return pos.x < -10 && pos.length() > CENTER_CIRCLE_RADIUS + MAX_ROBOT_SIZE;
+        }
+        return (pos - working.ball_pos).length() > RuleParam::Stop_Dist + MAX_ROBOT_SIZE;
+    }
+
+    /**
+     * @brief 为主罚和接球以外的球员分配站位
+     * 接球球员站在方案目标点，其余球员在网格站位中按评分贪心分配
+     */
+    void assignSupport(const WorldModel* model) {
+        if (working.receiver_id >= 0) {
+            working.support_pos[working.receiver_id] = working.kick_target;
+            working.has_support[working.receiver_id] = true;
+        }
+
+        // 生成候选站位：开球在本方半场，其余在球前方区域
+        std::vector<point2f> slots;
+        double x_min = (working.kind == SetPieceKind::KICKOFF) ? -FIELD_LENGTH_H + 80 : std::max(working.ball_pos.x - 150.0, -FIELD_LENGTH_H + 80);
+        double x_max = (working.kind == SetPieceKind::KICKOFF) ? -20.0 : FIELD_LENGTH_H - 60;
+        for (int ix = 0; ix < SUPPORT_GRID_X; ix++) {
+            for (int iy = 0; iy < SUPPORT_GRID_Y; iy++) {
+                point2f pos(x_min + (x_max - x_min) * (ix + 0.5) / SUPPORT_GRID_X,
+                            -FIELD_WIDTH_H + FIELD_WIDTH * (iy + 0.5) / SUPPORT_GRID_Y);
+                if (isLegalSupport(pos)) {
+                    slots.push_back(pos);
+                }
+            }
+        }
+
+        // 每个站位的评分：接球路线安全性和射门角度
+        std::vector<double> slot_scores(slots.size());
+        for (size_t s = 0; s < slots.size(); s++) {
+            slot_scores[s] = 0.6 * laneSafety(model, working.ball_pos, slots[s]) + 0.4 * shotOpenness(model, slots[s]);
+        }
+
+        std::vector<bool> taken(slots.size(), false);
+        for (int i : model->get_our_field_set() - RobotSet::single(working.kicker_id)) {
+            if (working.has_support[i]) continue;
+
+            point2f robot_pos = model->get_our_player_pos(i);
+            int best_slot = -1;
+            double best = -1e9;
+            for (size_t s = 0; s < slots.size(); s++) {
+                if (taken[s]) continue;
+                // 评分减去移动距离代价，并避免与已分配站位太近
+                double score = slot_scores[s] - (slots[s] - robot_pos).length() / FIELD_LENGTH;
+                for (int j = 0; j < MAX_TEAM_ROBOTS; j++) {
+                    if (working.has_support[j] && (working.support_pos[j] - slots[s]).length() < 60) {
+                        score -= 0.5;
+                    }
+                }
+                if (score > best) {
+                    best = score;
+                    best_slot = static_cast<int>(s);
+                }
+            }
+            if (best_slot >= 0) {
+                taken[best_slot] = true;
+                working.support_pos[i] = slots[best_slot];
+                working.has_support[i] = true;
+            }
+        }
+    }
+
+    int last_cycle;                         // 上次更新的周期
+    bool searching;                         // 是否正在搜索
+    bool was_planning;                      // 上一帧是否处于预计算阶段
+    int frames_since_search;                // 距上次开始搜索的帧数
+    std::vector<Candidate> candidates;      // 本轮搜索的全部候选
+    int next_candidate;                     // 下一个待评估的候选下标
+    double best_score;                      // 本轮搜索目前最高评分
+    SetPiecePlan working;                   // 正在搜索的方案
+    SetPiecePlan ready;                     // 已就绪的方案
+};
+
+#endif // SET_PIECE_PLANNER_H
@@ -2,6 +2,9 @@
 #define SPECIAL_TACTICS_H
 
 #include "tactics.h"
+#include "set_piece_planner.h"
+#include "pass_evaluator.h"
+#include "communication.h"
 #include "../utils/PlayerTask.h"
 #include "../utils/WorldModel.h"
 #include "../utils/game_state.h"
@@ -9,23 +12,6 @@
 #include <memory>
 #include <cmath>
 
-// 游戏状态常量（从game_state.h中提取关键常量）
-// 这些常量用于比赛状态判断
-#define PM_STOP 0
-#define PM_OurKickOff 1
-#define PM_OppKickOff 2
-#define PM_OurThrowIn 3
-#define PM_OppThrowIn 4
-#define PM_OurGoalKick 5
-#define PM_OppGoalKick 6
-#define PM_OurCornerKick 7
-#define PM_OppCornerKick 8
-#define PM_OurFreeKick 9
-#define PM_OppFreeKick 10
-#define PM_OurPenaltyKick 11
-#define PM_OppPenaltyKick 12
-#define PM_Normal 99
-
 /**
  * @brief 开球战术类
  * 处理比赛开球情况的战术
@@ -39,8 +25,9 @@ public:
     /**
      * @brief 构造函数
      * @param model 世界模型指针
+     * @param env 所属上下文的运行环境
      */
-    explicit KickoffTactic(const WorldModel* model) : Tactic(model) {
+    explicit KickoffTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env) {
         name = "Kickoff Tactic";
         type = TacticType::SPECIAL_SITUATION;
     }
@@ -61,6 +48,15 @@ public:
         return type;
     }
 
+    /**
+     * @brief 获取战术评估依赖的世界事件
+     * 定位球战术只在比赛状态变化时需要重新评估
+     * @return WorldEvent位掩码
+     */
+    unsigned int getDependencies() const override {
+        return EVENT_REFEREE_COMMAND;
+    }
+
     /**
      * @brief 评估当前战术的适用性
      * @return 战术评估结果
@@ -68,14 +64,14 @@ public:
     TacticEvaluation evaluate() const override {
         TacticEvaluation eval;
         
-        // 获取游戏状态
-        int play_mode = world_model->get_game_state();
+        // 获取本帧解码好的比赛模式
+        PlayMode play_mode = world_model->get_play_mode();
         
         // 如果当前是开球状态，则评分高
-        if (play_mode == PM_OurKickOff) {
+        if (play_mode == PlayMode::OurKickOff) {
             eval.score = 1.0;
             eval.description = "Our kickoff situation";
-        } else if (play_mode == PM_OppKickOff) {
+        } else if (play_mode == PlayMode::OppKickOff) {
             eval.score = 0.8;
             eval.description = "Opponent kickoff situation";
         } else {
@@ -97,11 +93,18 @@ public:
         // 获取球位置
         point2f ball_pos = world_model->get_ball_pos();
         
-        // 获取游戏状态
-        int play_mode = world_model->get_game_state();
+        // 获取本帧解码好的比赛模式
+        PlayMode play_mode = world_model->get_play_mode();
         
-        if (play_mode == PM_OurKickOff) {
+        if (play_mode == PlayMode::OurKickOff) {
             // 我方开球
+
+            // 停止阶段已预先算好方案时直接查表执行
+            const SetPiecePlan* plan = set_piece_planner->getReadyPlan(SetPieceKind::KICKOFF);
+            if (plan) {
+                SetPiecePlanner::fillTask(world_model, *plan, robot_id, task);
+                return task;
+            }
             
             // 在实际比赛中，会有专门指定的开球球员
             // 这里简单地判断：如果是最接近球的球员，则执行开球
@@ -131,7 +134,7 @@ public:
                 task.target_pos = position;
                 task.orientate = atan2(0 - position.y, FIELD_LENGTH_H - position.x);
             }
-        } else if (play_mode == PM_OppKickOff) {
+        } else if (play_mode == PlayMode::OppKickOff) {
             // 对方开球，保持在我方半场
             
             // 设置防守阵型
@@ -158,13 +161,15 @@ class FreeKickTactic : public Tactic {
 private:
     std::string name;
     TacticType type;
+    PassEvaluator pass_evaluator;   // 传球候选批量评估
 
 public:
     /**
      * @brief 构造函数
      * @param model 世界模型指针
+     * @param env 所属上下文的运行环境
      */
-    explicit FreeKickTactic(const WorldModel* model) : Tactic(model) {
+    explicit FreeKickTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env), pass_evaluator(model) {
         name = "Free Kick Tactic";
         type = TacticType::SPECIAL_SITUATION;
     }
@@ -185,6 +190,15 @@ public:
         return type;
     }
 
+    /**
+     * @brief 获取战术评估依赖的世界事件
+     * 任意球与角球由球的位置区分，球被摆放到其他区域时也需要重新评估
+     * @return WorldEvent位掩码
+     */
+    unsigned int getDependencies() const override {
+        return EVENT_REFEREE_COMMAND | EVENT_BALL_ZONE_CHANGE;
+    }
+
     /**
      * @brief 评估当前战术的适用性
      * @return 战术评估结果
@@ -192,14 +206,14 @@ public:
     TacticEvaluation evaluate() const override {
         TacticEvaluation eval;
         
-        // 获取游戏状态
-        int play_mode = world_model->get_game_state();
+        // 获取本帧解码好的比赛模式
+        PlayMode play_mode = world_model->get_play_mode();
         
         // 如果当前是我方任意球状态，则评分高
-        if (play_mode == PM_OurFreeKick) {
+        if (play_mode == PlayMode::OurFreeKick && !isCornerPosition(world_model->get_ball_pos(), true)) {
             eval.score = 1.0;
             eval.description = "Our free kick situation";
-        } else if (play_mode == PM_OppFreeKick) {
+        } else if (play_mode == PlayMode::OppFreeKick && !isCornerPosition(world_model->get_ball_pos(), false)) {
             eval.score = 0.8;
             eval.description = "Opponent free kick situation";
         } else {
@@ -221,11 +235,18 @@ public:
         // 获取球位置
         point2f ball_pos = world_model->get_ball_pos();
         
-        // 获取游戏状态
-        int play_mode = world_model->get_game_state();
+        // 获取本帧解码好的比赛模式
+        PlayMode play_mode = world_model->get_play_mode();
         
-        if (play_mode == PM_OurFreeKick) {
+        if (play_mode == PlayMode::OurFreeKick && !isCornerPosition(world_model->get_ball_pos(), true)) {
             // 我方任意球
+
+            // 停止阶段已预先算好方案时直接查表执行
+            const SetPiecePlan* plan = set_piece_planner->getReadyPlan(SetPieceKind::FREE_KICK);
+            if (plan) {
+                SetPiecePlanner::fillTask(world_model, *plan, robot_id, task);
+                return task;
+            }
             
             // 获取对方球门位置
             point2f goal_pos(FIELD_LENGTH_H, 0);
@@ -253,39 +274,18 @@ public:
                         task.needKick = true;
                         task.kickPower = 8.0;  // 全力射门
                     } else {
-                        // 寻找传球目标
-                        int pass_target = -1;
-                        double best_score = -1;
-                        
-                        // 评估所有队友的位置，找出最佳传球目标
-                        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-                            if (i == robot_id || !world_model->get_our_exist_id()[i]) continue;
-                            
-                            point2f teammate_pos = world_model->get_our_player_pos(i);
-                            double dist_to_teammate = (ball_pos - teammate_pos).length();
-                            double teammate_to_goal = (teammate_pos - goal_pos).length();
-                            
-                            // 简单评分：队友越靠近对方球门越好
-                            double score = 1000 - teammate_to_goal;
-                            
-                            // 但距离不能太远
-                            if (dist_to_teammate > 300) {
-                                score *= 0.5;
-                            }
-                            
-                            if (score > best_score) {
-                                best_score = score;
-                                pass_target = i;
-                            }
-                        }
+                        // 批量评估所有队友及其周围提前量点的传球成功概率
+                        pass_evaluator.evaluate(robot_id, ball_pos);
+                        PassCandidate best_pass;
                         
-                        if (pass_target >= 0) {
+                        if (pass_evaluator.best(best_pass) && best_pass.probability > 0.6) {
                             // 有传球目标
-                            point2f target_pos = world_model->get_our_player_pos(pass_target);
-                            task.orientate = atan2(target_pos.y - ball_pos.y, target_pos.x - ball_pos.x);
+                            task.orientate = atan2(best_pass.target.y - ball_pos.y, best_pass.target.x - ball_pos.x);
                             task.needKick = true;
                             task.isPass = true;
-                            task.kickPower = 3.0;  // 适中的传球力度
+                            task.kickPower = PassEvaluator::kickPowerForSpeed(best_pass.kick_speed);
+                            // 通知接球者跑到提前量落点
+                            communication->sendPassIntention(best_pass.receiver_id, best_pass.target);
                         } else {
                             // 没有好的传球目标，尝试自己带球
                             task.needCb = true; // 开启吸球带球
@@ -315,20 +315,18 @@ public:
                 task.target_pos = strategic_pos;
                 task.orientate = atan2(goal_pos.y - strategic_pos.y, goal_pos.x - strategic_pos.x);
             }
-        } else if (play_mode == PM_OppFreeKick) {
+        } else if (play_mode == PlayMode::OppFreeKick && !isCornerPosition(world_model->get_ball_pos(), false)) {
             // 对方任意球，需要防守
             
             // 计算所有机器人与球的距离
             double min_dist = 9999.0;
             int closest_id = -1;
             
-            for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-                if (world_model->get_our_exist_id()[i]) {
-                    double dist = (world_model->get_our_player_pos(i) - ball_pos).length();
-                    if (dist < min_dist) {
-                        min_dist = dist;
-                        closest_id = i;
-                    }
+            for (int i : world_model->get_our_set()) {
+                double dist = (world_model->get_our_player_pos(i) - ball_pos).length();
+                if (dist < min_dist) {
+                    min_dist = dist;
+                    closest_id = i;
                 }
             }
             
@@ -387,8 +385,9 @@ public:
     /**
      * @brief 构造函数
      * @param model 世界模型指针
+     * @param env 所属上下文的运行环境
      */
-    explicit CornerKickTactic(const WorldModel* model) : Tactic(model) {
+    explicit CornerKickTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env) {
         name = "Corner Kick Tactic";
         type = TacticType::SPECIAL_SITUATION;
     }
@@ -409,6 +408,15 @@ public:
         return type;
     }
 
+    /**
+     * @brief 获取战术评估依赖的世界事件
+     * 任意球与角球由球的位置区分，球被摆放到其他区域时也需要重新评估
+     * @return WorldEvent位掩码
+     */
+    unsigned int getDependencies() const override {
+        return EVENT_REFEREE_COMMAND | EVENT_BALL_ZONE_CHANGE;
+    }
+
     /**
      * @brief 评估当前战术的适用性
      * @return 战术评估结果
@@ -416,14 +424,14 @@ public:
     TacticEvaluation evaluate() const override {
         TacticEvaluation eval;
         
-        // 获取游戏状态
-        int play_mode = world_model->get_game_state();
+        // 获取本帧解码好的比赛模式
+        PlayMode play_mode = world_model->get_play_mode();
         
         // 如果当前是我方角球状态，则评分高
-        if (play_mode == PM_OurCornerKick) {
+        if (play_mode == PlayMode::OurFreeKick && isCornerPosition(world_model->get_ball_pos(), true)) {
             eval.score = 1.0;
             eval.description = "Our corner kick situation";
-        } else if (play_mode == PM_OppCornerKick) {
+        } else if (play_mode == PlayMode::OppFreeKick && isCornerPosition(world_model->get_ball_pos(), false)) {
             eval.score = 0.8;
             eval.description = "Opponent corner kick situation";
         } else {
@@ -445,11 +453,18 @@ public:
         // 获取球位置
         point2f ball_pos = world_model->get_ball_pos();
         
-        // 获取游戏状态
-        int play_mode = world_model->get_game_state();
+        // 获取本帧解码好的比赛模式
+        PlayMode play_mode = world_model->get_play_mode();
         
-        if (play_mode == PM_OurCornerKick) {
+        if (play_mode == PlayMode::OurFreeKick && isCornerPosition(world_model->get_ball_pos(), true)) {
             // 我方角球
+
+            // 停止阶段已预先算好方案时直接查表执行
+            const SetPiecePlan* plan = set_piece_planner->getReadyPlan(SetPieceKind::CORNER_KICK);
+            if (plan) {
+                SetPiecePlanner::fillTask(world_model, *plan, robot_id, task);
+                return task;
+            }
             
             // 在实际比赛中，会有专门指定的角球球员
             // 这里简单地判断：如果是最接近球的球员，则执行角球
@@ -470,9 +485,7 @@ public:
                 point2f penalty_area_front(FIELD_LENGTH_H - 200, 0);
                 double best_score = -1;
                 
-                for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-                    if (i == robot_id || !world_model->get_our_exist_id()[i]) continue;
-                    
+                for (int i : world_model->get_our_set() - RobotSet::single(robot_id)) {
                     point2f teammate_pos = world_model->get_our_player_pos(i);
                     
                     // 计算到禁区前沿的距离
@@ -537,7 +550,7 @@ public:
                 task.target_pos = strategic_pos;
                 task.orientate = atan2(ball_pos.y - strategic_pos.y, ball_pos.x - strategic_pos.x);
             }
-        } else if (play_mode == PM_OppCornerKick) {
+        } else if (play_mode == PlayMode::OppFreeKick && isCornerPosition(world_model->get_ball_pos(), false)) {
             // 对方角球，加强防守
             
             // 确定守门员ID
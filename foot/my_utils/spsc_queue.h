@@ -0,0 +1,64 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief 单生产者单消费者无锁环形队列
+ * 容量固定为N-1（N须为2的幂），不分配内存；生产者和消费者各只能有一个线程。
+ * 队列满时push返回false，由调用方决定丢弃还是稍后重试。
+ */
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief 入队，只能由生产者线程调用
+     * @return 队列已满时返回false
+     */
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) & (N - 1);
+        if (next == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots[t] = item;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 出队，只能由消费者线程调用
+     * @return 队列为空时返回false
+     */
+    bool pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = slots[h];
+        head.store((h + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return N - 1; }
+
+private:
+    // 生产者和消费者的下标放在不同的缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) T slots[N];
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,209 @@
+#ifndef SUPPORT_MAP_H
+#define SUPPORT_MAP_H
+
+#include <cmath>
+#include <algorithm>
+#include "../utils/constants.h"
+#include "../utils/field_geometry.h"
+#include "../utils/world_snapshot.h"
+#include "background_planner.h"
+
+/**
+ * @brief 一个接应点
+ */
+struct SupportSpot {
+    float x, y;
+    float value;                        // 接应价值(0~1)
+};
+
+/**
+ * @brief 对方半场的接应点热图计算结果：价值最高且彼此分开的若干个接应点
+ */
+struct SupportMap {
+    static const int MAX_SPOTS = TEAM_SIZE > 2 ? TEAM_SIZE - 2 : 1;   // 除守门员和持球者外每人一个，至少一个
+
+    int resolution = 0;                 // 本结果使用的栅格边长(cm)
+    int spot_count = 0;
+    SupportSpot spots[MAX_SPOTS];       // 按价值从高到低排列
+};
+
+/**
+ * @brief 接应点热图的后台任务
+ * 在对方半场的栅格上评估每个点作为接应点的价值：离对手的空位、从球到该点的传球路线是否安全、该点的射门角度。
+ * 栅格从粗到细逐遍细化（40、20、10、5cm），每遍发布一次结果；球或对手移动较大、比赛模式变化时从最粗的一遍重新开始，
+ * 小的变化只换上最新快照，在当前分辨率上继续。
+ */
+class SupportMapTask : public BackgroundTask<SupportMap> {
+public:
+    static const int LEVELS = 4;
+    static const int COARSEST_RESOLUTION = 40;          // 第一遍的栅格边长(cm)，每遍减半
+    static const int ROWS_PER_STEP = 4;                 // 每次refine计算的栅格行数
+    static const int AIM_POINTS = 5;                    // 球门上的射门瞄准点数量
+    static constexpr double RESET_MOVE_DIST = 30.0;     // 球或对手移动超过该距离时从最粗的一遍重新开始(cm)
+    static constexpr double FIELD_MARGIN = 30.0;        // 接应点离边线的最小距离(cm)
+    static constexpr double DEFENSE_MARGIN = 20.0;      // 接应点离对方禁区的最小距离(cm)
+    static constexpr double OPEN_RADIUS = 100.0;        // 离最近对手超过该距离视为完全空位(cm)
+    static constexpr double LANE_RADIUS = 40.0;         // 传球路线离对手超过该距离视为安全(cm)
+    static constexpr double BLOCK_RADIUS = MAX_ROBOT_SIZE + BALL_SIZE;  // 对手挡住射门路线的距离(cm)
+    static constexpr double MIN_PASS_DIST = 80.0;       // 传球距离下限(cm)
+    static constexpr double MAX_PASS_DIST = 450.0;      // 传球距离上限(cm)
+    static constexpr double SPOT_SEPARATION = 100.0;    // 接应点之间的最小距离(cm)
+
+    SupportMapTask() : level(0), row(0), finished_level(-1), rows(0), cols(0) {}
+
+    void begin(const WorldSnapshot& snapshot) override {
+        bool reset = finished_level < 0 || changedMuch(snapshot);
+        if (reset) {
+            level = 0;
+            finished_level = -1;
+        } else if (finished_level + 1 < LEVELS) {
+            level = finished_level + 1;
+        }
+        world = snapshot;
+        if (reset) {
+            reference = snapshot;
+        }
+
+        int step = resolution();
+        cols = static_cast<int>((Field::LENGTH_H - 2 * FIELD_MARGIN) / step) + 1;
+        rows = static_cast<int>((Field::WIDTH - 2 * FIELD_MARGIN) / step) + 1;
+        row = 0;
+        current.resolution = step;
+        current.spot_count = 0;
+    }
+
+    bool refine(SupportMap& out) override {
+        int step = resolution();
+        int end = std::min(row + ROWS_PER_STEP, rows);
+        for (; row < end; row++) {
+            float y = static_cast<float>(-Field::WIDTH_H + FIELD_MARGIN + row * step);
+            for (int c = 0; c < cols; c++) {
+                float x = static_cast<float>(FIELD_MARGIN + c * step);
+                if (Field::in_opp_defense(x, y, static_cast<float>(DEFENSE_MARGIN))) {
+                    continue;
+                }
+                insertSpot(x, y, static_cast<float>(evaluate(x, y)));
+            }
+        }
+        if (row < rows) {
+            return false;
+        }
+        finished_level = level;
+        out = current;
+        return true;
+    }
+
+    bool done() const override {
+        return finished_level == LEVELS - 1;
+    }
+
+private:
+    int resolution() const {
+        return COARSEST_RESOLUTION >> level;
+    }
+
+    // 与上次从头开始时的快照比较，比赛模式变化、球或对手移动较大时需要从头开始
+    bool changedMuch(const WorldSnapshot& s) const {
+        if (s.play_mode != reference.play_mode) {
+            return true;
+        }
+        if (std::hypot(s.ball_x - reference.ball_x, s.ball_y - reference.ball_y) > RESET_MOVE_DIST) {
+            return true;
+        }
+        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
+            const RobotSnapshot& a = s.opp[i];
+            const RobotSnapshot& b = reference.opp[i];
+            if (a.exist != b.exist || (a.exist && std::hypot(a.x - b.x, a.y - b.y) > RESET_MOVE_DIST)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 点到线段的距离
+    static double segmentDistance(double ax, double ay, double bx, double by, double px, double py) {
+        double dx = bx - ax, dy = by - ay;
+        double len2 = dx * dx + dy * dy;
+        double t = len2 > 0 ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0.0;
+        t = std::max(0.0, std::min(1.0, t));
+        return std::hypot(ax + t * dx - px, ay + t * dy - py);
+    }
+
+    // 一个点作为接应点的价值：空位 × 传球路线安全 × 射门机会
+    double evaluate(float x, float y) const {
+        double open_dist = OPEN_RADIUS;
+        double lane_dist = LANE_RADIUS;
+        for (int k = 0; k < MAX_TEAM_ROBOTS; k++) {
+            const RobotSnapshot& o = world.opp[k];
+            if (!o.exist) continue;
+            open_dist = std::min(open_dist, static_cast<double>(std::hypot(o.x - x, o.y - y)));
+            lane_dist = std::min(lane_dist, segmentDistance(world.ball_x, world.ball_y, x, y, o.x, o.y));
+        }
+        double open = open_dist / OPEN_RADIUS;
+        double lane = lane_dist / LANE_RADIUS;
+
+        double pass_dist = std::hypot(x - world.ball_x, y - world.ball_y);
+        if (pass_dist < MIN_PASS_DIST || pass_dist > MAX_PASS_DIST) {
+            lane *= 0.3;
+        }
+
+        // 球门上未被对手挡住的瞄准点比例，乘以球门张角的饱和函数
+        double goal_x = Field::LENGTH_H;
+        int clear = 0;
+        for (int a = 0; a < AIM_POINTS; a++) {
+            double aim_y = -Field::GOAL_WIDTH_H + Field::GOAL_WIDTH_H * 2 * (a + 0.5) / AIM_POINTS;
+            bool blocked = false;
+            for (int k = 0; k < MAX_TEAM_ROBOTS && !blocked; k++) {
+                const RobotSnapshot& o = world.opp[k];
+                blocked = o.exist && segmentDistance(x, y, goal_x, aim_y, o.x, o.y) < BLOCK_RADIUS;
+            }
+            if (!blocked) clear++;
+        }
+        double angle = std::fabs(std::atan2(Field::GOAL_WIDTH_H - y, goal_x - x) -
+                                 std::atan2(-Field::GOAL_WIDTH_H - y, goal_x - x));
+        double shot = static_cast<double>(clear) / AIM_POINTS * angle / (angle + 0.3);
+
+        return open * lane * (0.3 + 0.7 * shot);
+    }
+
+    // 维护价值最高且彼此相距至少SPOT_SEPARATION的接应点
+    void insertSpot(float x, float y, float value) {
+        SupportSpot* spots = current.spots;
+        int& n = current.spot_count;
+        if (n == SupportMap::MAX_SPOTS && value <= spots[n - 1].value) {
+            return;
+        }
+        // 与已有接应点太近时只保留价值高的
+        for (int i = 0; i < n; i++) {
+            if (std::hypot(spots[i].x - x, spots[i].y - y) < SPOT_SEPARATION && value <= spots[i].value) {
+                return;
+            }
+        }
+        int kept = 0;
+        for (int i = 0; i < n; i++) {
+            if (std::hypot(spots[i].x - x, spots[i].y - y) >= SPOT_SEPARATION) {
+                spots[kept++] = spots[i];
+            }
+        }
+        n = kept;
+        int pos = std::min(n, SupportMap::MAX_SPOTS - 1);
+        while (pos > 0 && spots[pos - 1].value < value) {
+            if (pos < SupportMap::MAX_SPOTS) spots[pos] = spots[pos - 1];
+            pos--;
+        }
+        spots[pos].x = x;
+        spots[pos].y = y;
+        spots[pos].value = value;
+        if (n < SupportMap::MAX_SPOTS) n++;
+    }
+
+    WorldSnapshot world;                // 本遍使用的快照
+    WorldSnapshot reference;            // 最近一次从头开始时的快照
+    SupportMap current;                 // 本遍的结果
+    int level;                          // 本遍的细化层级，0最粗
+    int row;                            // 本遍下一个要计算的栅格行
+    int finished_level;                 // 已完成的最细层级，-1表示还没有完成任何一遍
+    int rows, cols;
+};
+
+#endif // SUPPORT_MAP_H
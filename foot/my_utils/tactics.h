@@ -15,6 +15,11 @@
 #include "opp_players.h"
 #include "opp_goalie.h"
 #include "logger.h"
+#include "communication.h"
+#include "team_state.h"
+#include "set_piece_planner.h"
+#include "pass_network.h"
+#include "world_events.h"
 
 // 前向声明解决循环包含问题
 class BallTools;
@@ -33,6 +38,9 @@ enum class TacticType {
     SPECIAL_SITUATION   // 特殊情况
 };
 
+// 战术类型数量，用于按类型建立的数组
+const int TACTIC_TYPE_COUNT = 4;
+
 /**
  * @brief 进攻战术枚举
  */
@@ -77,6 +85,20 @@ struct TacticEvaluation {
     TacticEvaluation(double s, const std::string& desc) : score(s), description(desc) {}
 };
 
+/**
+ * @brief 战术运行环境，由所属的PlannerContext提供（PlannerContext::getTacticEnv）
+ * 战术通过它访问队伍状态、定位球方案、日志和通信，不直接使用单例；
+ * 不同上下文上的战术因此互不共享队伍状态的帧缓存和定位球方案
+ */
+struct TacticEnv {
+    OurTeamState* our_state;               // 我方队伍状态
+    OppTeamState* opp_state;               // 对方队伍状态
+    SetPiecePlanner* set_piece_planner;    // 定位球方案预计算器
+    PassNetwork* pass_network;             // 传球网络，帧级作业每帧更新
+    Logger* logger;                        // 日志
+    Communication* communication;          // 球员间通信
+};
+
 /**
  * @brief 战术基类，提供战术评估和执行接口
  */
@@ -85,14 +107,19 @@ public:
     /**
      * @brief 构造函数
      * @param model 世界模型指针
+     * @param env 所属上下文的运行环境
      */
-    Tactic(const WorldModel* model)
+    Tactic(const WorldModel* model, const TacticEnv& env)
         : world_model(model), 
           ball_tools(new BallTools(model)),
-          our_players(new Players(model)),
+          our_players(new Players(model, *ball_tools, *env.our_state)),
           our_goalie(new Goalie(model)),
-          opp_players(new OppPlayers(model)),
-          opp_goalie(new OppGoalie(model)) {}
+          opp_players(new OppPlayers(model, *ball_tools, *env.opp_state)),
+          opp_goalie(new OppGoalie(model)),
+          set_piece_planner(env.set_piece_planner),
+          pass_network(env.pass_network),
+          logger(env.logger),
+          communication(env.communication) {}
 
     /**
      * @brief 析构函数
@@ -123,6 +150,15 @@ public:
      */
     virtual TacticEvaluation evaluate() const = 0;
     
+    /**
+     * @brief 获取战术评估所依赖的世界事件
+     * 只有依赖的事件发生时才重新评估，默认依赖全部事件（每帧评估）
+     * @return WorldEvent位掩码
+     */
+    virtual unsigned int getDependencies() const {
+        return EVENT_ALL;
+    }
+    
     /**
      * @brief 执行战术，为指定球员生成任务
      * @param robot_id 执行战术的球员ID
@@ -137,69 +173,188 @@ protected:
     Goalie* our_goalie;            // 我方守门员工具
     OppPlayers* opp_players;       // 对方球员工具
     OppGoalie* opp_goalie;         // 对方守门员工具
+    SetPiecePlanner* set_piece_planner;  // 定位球方案预计算器（所属上下文持有）
+    PassNetwork* pass_network;     // 传球网络（所属上下文持有）
+    Logger* logger;                // 日志（所属上下文持有）
+    Communication* communication;  // 球员间通信（所属上下文持有）
 };
 
+/**
+ * @brief 战术句柄，注册时分配，整个生命周期内保持不变
+ */
+typedef int TacticHandle;
+const TacticHandle INVALID_TACTIC_HANDLE = -1;
+
 /**
  * @brief 战术工厂类，用于创建和管理不同战术
+ * 注册时按战术类型分桶并缓存类型、名称和事件依赖；
+ * 选择和按句柄查找都返回非拥有的裸指针，热路径上没有引用计数和字符串比较
  */
 class TacticFactory {
 public:
     /**
-     * @brief 获取单例实例
-     * @return 战术工厂单例
+     * @brief 获取默认实例
+     * @return 默认战术工厂
      */
     static TacticFactory& getInstance() {
         static TacticFactory instance;
         return instance;
     }
     
+    /**
+     * @brief 独立的战术工厂，由PlannerContext持有；getInstance()为默认实例
+     */
+    TacticFactory() : frames_since_refresh(0) {
+        for (int i = 0; i < TACTIC_TYPE_COUNT; i++) {
+            best_tactics[i] = nullptr;
+            best_scores[i] = -1.0;
+            type_dirty[i] = true;
+        }
+    }
+    
+    ~TacticFactory() {}
+    
     /**
      * @brief 注册战术
-     * @param tactic 战术实例
+     * @param tactic 战术实例（工厂持有所有权）
+     * @return 战术句柄
      */
-    void registerTactic(std::shared_ptr<Tactic> tactic) {
-        tactics.push_back(tactic);
+    TacticHandle registerTactic(std::shared_ptr<Tactic> tactic) {
+        TacticHandle handle = static_cast<TacticHandle>(entries.size());
+        int type_index = static_cast<int>(tactic->getType());
+        
+        TacticEntry entry;
+        entry.tactic = tactic.get();
+        entry.type_index = type_index;
+        entry.dependencies = tactic->getDependencies();
+        entry.name = tactic->getName();
+        entry.dirty = true;
+        
+        owned_tactics.push_back(tactic);
+        entries.push_back(entry);
+        buckets[type_index].push_back(handle);
+        type_dirty[type_index] = true;
+        return handle;
+    }
+    
+    /**
+     * @brief 新的一帧开始时根据世界事件使相关战术的评估失效
+     * 只有依赖这些事件的战术会在下次选择时重新评估；
+     * 每隔SAFETY_REFRESH_FRAMES帧强制全部重新评估，兜底未被事件覆盖的变化
+     * @param events 本帧的WorldEvent位掩码
+     */
+    void invalidate(unsigned int events) {
+        frames_since_refresh++;
+        if (frames_since_refresh >= SAFETY_REFRESH_FRAMES) {
+            events = EVENT_ALL;
+        }
+        if (events == EVENT_ALL) {
+            frames_since_refresh = 0;
+        }
+        if (events == EVENT_NONE) {
+            return;
+        }
+        
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].dependencies & events) {
+                entries[i].dirty = true;
+                type_dirty[entries[i].type_index] = true;
+            }
+        }
     }
     
     /**
      * @brief 根据当前情况选择最佳战术
-     * @param type 战术类型，默认为任意类型
-     * @return 最佳战术实例
+     * 只遍历该类型的桶，并且只重新评估已失效的战术
+     * @param type 战术类型，默认为进攻
+     * @return 最佳战术（非拥有指针），没有该类型战术时为nullptr
      */
-    std::shared_ptr<Tactic> selectBestTactic(TacticType type = TacticType::ATTACK) const {
+    Tactic* selectBestTactic(TacticType type = TacticType::ATTACK) {
+        int type_index = static_cast<int>(type);
+        
+        // 该类型没有任何失效的战术，直接返回上次结果
+        if (!type_dirty[type_index]) {
+            return best_tactics[type_index];
+        }
+        
         double best_score = -1.0;
-        std::shared_ptr<Tactic> best_tactic = nullptr;
+        Tactic* best_tactic = nullptr;
         
-        for (const auto& tactic : tactics) {
-            // 如果指定了类型，则只评估该类型的战术
-            if (tactic->getType() != type) {
-                continue;
-            }
-            
-            // 评估战术适用性
-            TacticEvaluation eval = tactic->evaluate();
-            
+        const std::vector<TacticHandle>& bucket = buckets[type_index];
+        for (size_t i = 0; i < bucket.size(); i++) {
+            const TacticEvaluation& eval = getEvaluation(bucket[i]);
             if (eval.score > best_score) {
                 best_score = eval.score;
-                best_tactic = tactic;
+                best_tactic = entries[bucket[i]].tactic;
             }
         }
         
+        best_tactics[type_index] = best_tactic;
+        best_scores[type_index] = best_score;
+        type_dirty[type_index] = false;
         return best_tactic;
     }
     
+    /**
+     * @brief 获取上次选择的最佳战术评分，避免调用方再次评估
+     * @param type 战术类型
+     * @return 最佳评分，没有该类型战术时为-1
+     */
+    double getBestScore(TacticType type) const {
+        return best_scores[static_cast<int>(type)];
+    }
+    
+    /**
+     * @brief 获取战术的评估结果，失效时才重新评估
+     * @param handle 战术句柄
+     * @return 评估结果
+     */
+    const TacticEvaluation& getEvaluation(TacticHandle handle) {
+        TacticEntry& entry = entries[handle];
+        if (entry.dirty) {
+            entry.evaluation = entry.tactic->evaluate();
+            entry.dirty = false;
+        }
+        return entry.evaluation;
+    }
+    
+    /**
+     * @brief 根据名称获取战术句柄，应在初始化时调用一次并保存结果
+     * @param name 战术名称
+     * @return 战术句柄，如果没找到则返回INVALID_TACTIC_HANDLE
+     */
+    TacticHandle getHandle(const std::string& name) const {
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].name == name) {
+                return static_cast<TacticHandle>(i);
+            }
+        }
+        return INVALID_TACTIC_HANDLE;
+    }
+    
+    /**
+     * @brief 根据句柄获取战术
+     * @param handle 战术句柄
+     * @return 战术（非拥有指针），句柄无效时返回nullptr
+     */
+    Tactic* getTactic(TacticHandle handle) const {
+        if (handle < 0 || handle >= static_cast<TacticHandle>(entries.size())) {
+            return nullptr;
+        }
+        return entries[handle].tactic;
+    }
+    
     /**
      * @brief 根据名称获取战术
      * @param name 战术名称
      * @return 战术实例，如果没找到则返回nullptr
      */
     std::shared_ptr<Tactic> getTacticByName(const std::string& name) const {
-        for (const auto& tactic : tactics) {
-            if (tactic->getName() == name) {
-                return tactic;
-            }
+        TacticHandle handle = getHandle(name);
+        if (handle == INVALID_TACTIC_HANDLE) {
+            return nullptr;
         }
-        return nullptr;
+        return owned_tactics[handle];
     }
     
     /**
@@ -207,32 +362,49 @@ public:
      * @return 战术列表
      */
     const std::vector<std::shared_ptr<Tactic>>& getAllTactics() const {
-        return tactics;
+        return owned_tactics;
     }
     
     /**
-     * @brief 清除所有战术
+     * @brief 清除所有战术，之前分配的句柄全部失效
      */
     void clearTactics() {
-        tactics.clear();
+        owned_tactics.clear();
+        entries.clear();
+        for (int i = 0; i < TACTIC_TYPE_COUNT; i++) {
+            buckets[i].clear();
+            best_tactics[i] = nullptr;
+            best_scores[i] = -1.0;
+            type_dirty[i] = true;
+        }
     }
 
 private:
-    /**
-     * @brief 私有构造函数，保证单例
-     */
-    TacticFactory() {}
+    // 禁止拷贝和赋值
+    TacticFactory(const TacticFactory&) = delete;
+    TacticFactory& operator=(const TacticFactory&) = delete;
     
     /**
-     * @brief 私有析构函数
+     * @brief 注册时缓存的战术信息
      */
-    ~TacticFactory() {}
+    struct TacticEntry {
+        Tactic* tactic;                 // 战术（由owned_tactics持有）
+        int type_index;                 // 战术类型下标
+        unsigned int dependencies;      // 评估依赖的世界事件
+        std::string name;               // 战术名称，仅用于初始化时查找句柄
+        TacticEvaluation evaluation;    // 缓存的评估结果
+        bool dirty;                     // 评估是否失效
+    };
     
-    // 禁止拷贝和赋值
-    TacticFactory(const TacticFactory&) = delete;
-    TacticFactory& operator=(const TacticFactory&) = delete;
+    static const int SAFETY_REFRESH_FRAMES = 30;  // 强制全部重新评估的帧间隔(约0.5秒)
     
-    std::vector<std::shared_ptr<Tactic>> tactics; // 战术列表
+    std::vector<std::shared_ptr<Tactic>> owned_tactics;       // 战术所有权，下标即句柄
+    std::vector<TacticEntry> entries;                         // 下标即句柄
+    std::vector<TacticHandle> buckets[TACTIC_TYPE_COUNT];     // 按类型分桶的句柄
+    Tactic* best_tactics[TACTIC_TYPE_COUNT];                  // 各类型上次选出的最佳战术
+    double best_scores[TACTIC_TYPE_COUNT];                    // 各类型上次的最佳评分
+    bool type_dirty[TACTIC_TYPE_COUNT];                       // 各类型是否有失效的战术
+    int frames_since_refresh;                                 // 距上次全部重新评估的帧数
 };
 
 #endif // TACTICS_H 
\ No newline at end of file
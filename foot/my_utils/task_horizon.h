@@ -0,0 +1,209 @@
+#ifndef TASK_HORIZON_H
+#define TASK_HORIZON_H
+
+#include <cmath>
+#include <cstring>
+#include "../utils/worldmodel.h"
+#include "../utils/PlayerTask.h"
+#include "../utils/maths.h"
+
+#define MAX_TASK_STEPS 4
+
+/**
+ * @brief 多步任务中每一步的完成条件
+ */
+enum StepCondition {
+    STEP_ARRIVE,            // 到达目标点，tolerance为距离(cm)
+    STEP_FACING,            // 朝向目标角度，tolerance为角度误差(rad)
+    STEP_BALL_CONTROL,      // 球进入控球范围，tolerance为球与车的距离(cm)
+    STEP_KICKED,            // 球已踢出，tolerance为球速阈值(cm/s)
+    STEP_TIME               // 持续timeout_frames帧
+};
+
+/**
+ * @brief 多步任务中的一步：目标、动作和完成条件；执行器按顺序推进，不需要每帧重新规划
+ */
+struct TaskStep {
+    point2f target_pos;
+    double orientate;
+    point2f global_vel;
+    bool needKick;
+    bool isPass;
+    bool needCb;
+    bool isChipKick;
+    double kickPower;
+    double chipKickPower;
+    int condition;              // StepCondition
+    double tolerance;
+    int timeout_frames;         // 超过该帧数仍未完成视为偏离计划，0表示不限
+};
+
+/**
+ * @brief 规划器内部的任务：单步任务加上可选的多步计划
+ * 多步计划只在DLL内部由执行器展开，导出给宿主的仍是布局不变的PlayerTask
+ */
+struct PlannedTask {
+    PlayerTask task;                        // 单步任务，也是各步骤共用的公共字段
+    TaskStep horizon[MAX_TASK_STEPS];       // 按顺序执行的步骤
+    int horizon_size;                       // 有效步骤数，为0时只使用task
+
+    PlannedTask() : horizon_size(0) {}
+};
+
+/**
+ * @brief 多步任务执行器
+ * 规划器给出带horizon的PlannedTask后，执行器每帧检查当前步骤的完成条件并推进到下一步，
+ * 输出当前步骤展开后的单步任务。规划器只需在偏离计划（步骤超时）或世界状态变化时重新规划。
+ */
+class TaskHorizonExecutor {
+public:
+    TaskHorizonExecutor() : step_index(0), step_start_cycle(0), running(false) {}
+
+    /**
+     * @brief 构造一个步骤，未指定的动作字段为零
+     * @param target 目标点
+     * @param orientate 目标朝向
+     * @param condition 完成条件(StepCondition)
+     * @param tolerance 完成条件的阈值
+     * @param timeout_frames 超时帧数，0表示不限
+     * @return 步骤
+     */
+    static TaskStep makeStep(const point2f& target, double orientate, StepCondition condition,
+                             double tolerance, int timeout_frames) {
+        TaskStep step;
+        memset(&step, 0, sizeof(TaskStep));
+        step.target_pos = target;
+        step.orientate = orientate;
+        step.condition = condition;
+        step.tolerance = tolerance;
+        step.timeout_frames = timeout_frames;
+        return step;
+    }
+
+    /**
+     * @brief 向任务追加一个步骤
+     * @param task 任务
+     * @param step 步骤
+     * @return 容量已满时返回false
+     */
+    static bool appendStep(PlannedTask& task, const TaskStep& step) {
+        if (task.horizon_size >= MAX_TASK_STEPS) {
+            return false;
+        }
+        task.horizon[task.horizon_size++] = step;
+        return true;
+    }
+
+    /**
+     * @brief 开始执行一个带horizon的任务
+     * @param task 任务
+     * @param cycle 当前周期
+     */
+    void start(const PlannedTask& task, int cycle) {
+        plan = task;
+        step_index = 0;
+        step_start_cycle = cycle;
+        running = (task.horizon_size > 0);
+    }
+
+    /**
+     * @brief 放弃当前计划
+     */
+    void cancel() {
+        running = false;
+    }
+
+    /**
+     * @brief 是否有正在执行的计划
+     * @return 是否正在执行
+     */
+    bool isActive() const {
+        return running;
+    }
+
+    /**
+     * @brief 当前步骤下标
+     * @return 步骤下标
+     */
+    int currentStep() const {
+        return step_index;
+    }
+
+    /**
+     * @brief 推进计划并输出当前步骤的单步任务
+     * @param model 世界模型指针
+     * @param robot_id 机器人ID
+     * @param out 输出的单步任务
+     * @return 计划仍在执行时返回true；全部完成或步骤超时（偏离计划）时返回false，需要重新规划
+     */
+    bool advance(const WorldModel* model, int robot_id, PlayerTask& out) {
+        if (!running) {
+            return false;
+        }
+
+        int cycle = model->get_cycle();
+        while (step_index < plan.horizon_size) {
+            const TaskStep& step = plan.horizon[step_index];
+            int elapsed = cycle - step_start_cycle;
+            if (isComplete(step, model, robot_id, elapsed)) {
+                step_index++;
+                step_start_cycle = cycle;
+                continue;
+            }
+            if (step.timeout_frames > 0 && elapsed > step.timeout_frames) {
+                // 超时未完成，说明实际情况偏离了计划
+                running = false;
+                return false;
+            }
+            break;
+        }
+
+        if (step_index >= plan.horizon_size) {
+            running = false;
+            return false;
+        }
+
+        // 以计划的公共字段为基础，用当前步骤覆盖目标和动作
+        const TaskStep& step = plan.horizon[step_index];
+        out = plan.task;
+        out.target_pos = step.target_pos;
+        out.orientate = step.orientate;
+        out.global_vel = step.global_vel;
+        out.needKick = step.needKick;
+        out.isPass = step.isPass;
+        out.needCb = step.needCb;
+        out.isChipKick = step.isChipKick;
+        out.kickPower = step.kickPower;
+        out.chipKickPower = step.chipKickPower;
+        return true;
+    }
+
+private:
+    /**
+     * @brief 判断步骤是否完成
+     */
+    static bool isComplete(const TaskStep& step, const WorldModel* model, int robot_id, int elapsed) {
+        const point2f& robot_pos = model->get_our_player_pos(robot_id);
+        switch (step.condition) {
+        case STEP_ARRIVE:
+            return (robot_pos - step.target_pos).length() < step.tolerance;
+        case STEP_FACING:
+            return fabs(Maths::normalize(model->get_our_player_dir(robot_id) - step.orientate)) < step.tolerance;
+        case STEP_BALL_CONTROL:
+            return (model->get_ball_pos() - robot_pos).length() < step.tolerance;
+        case STEP_KICKED:
+            return model->get_ball_vel().length() > step.tolerance;
+        case STEP_TIME:
+            return elapsed >= step.timeout_frames;
+        default:
+            return true;
+        }
+    }
+
+    PlannedTask plan;           // 正在执行的计划
+    int step_index;             // 当前步骤
+    int step_start_cycle;       // 当前步骤开始的周期
+    bool running;               // 是否正在执行
+};
+
+#endif // TASK_HORIZON_H
@@ -0,0 +1,315 @@
+#ifndef TEAM_STATE_H
+#define TEAM_STATE_H
+
+#include <cmath>
+#include <algorithm>
+#include "../utils/worldmodel.h"
+#include "../utils/constants.h"
+#include "../utils/vector.h"
+#include "../utils/field_geometry.h"
+
+/**
+ * @brief 队伍：我方或对方
+ */
+enum class TeamSide {
+    Our,
+    Opp
+};
+
+/**
+ * @brief 按队伍从世界模型取数据，TeamState的唯一差异点
+ */
+template <TeamSide Side>
+struct TeamSource;
+
+template <>
+struct TeamSource<TeamSide::Our> {
+    static RobotSet present(const WorldModel* model) { return model->get_our_set(); }
+    static int goalie(const WorldModel* model) { return model->get_our_goalie(); }
+    static point2f position(const WorldModel* model, int id) { return model->get_our_player_pos(id); }
+    static point2f velocity(const WorldModel* model, int id) { return model->get_our_player_v(id); }
+    static float orientation(const WorldModel* model, int id) { return model->get_our_player_dir(id); }
+};
+
+template <>
+struct TeamSource<TeamSide::Opp> {
+    static RobotSet present(const WorldModel* model) { return model->get_opp_set(); }
+    static int goalie(const WorldModel* model) { return model->get_opp_goalie(); }
+    static point2f position(const WorldModel* model, int id) { return model->get_opp_player_pos(id); }
+    static point2f velocity(const WorldModel* model, int id) { return model->get_opp_player(id).vel(); }
+    static float orientation(const WorldModel* model, int id) { return model->get_opp_player_dir(id); }
+};
+
+/**
+ * @brief 一支队伍的逐帧状态（结构数组布局）
+ * 每帧由世界模型更新一次，按车号索引的各字段分别连续存放，历史位置为环形缓冲区。
+ * Players、Teammates和OppPlayers都从这里读取，不再各自维护历史和扫描，
+ * 最近球员、半场、禁区、持球等查询以RobotSet为输入输出批量进行。
+ */
+template <TeamSide Side>
+class TeamState {
+public:
+    static const int MAX_ROBOTS_PER_TEAM = MAX_TEAM_ROBOTS;
+    static const int HISTORY_SIZE = 10;                 // 位置历史帧数
+    static constexpr double FRAME_TIME = 1.0 / 60.0;    // 视觉帧周期(秒)
+    static constexpr double CONTROL_ANGLE = M_PI / 4;   // 持球时球相对朝向的最大偏角
+
+    /**
+     * @brief 获取单例实例
+     * @return 队伍状态实例
+     */
+    static TeamState& getInstance() {
+        static TeamState instance;
+        return instance;
+    }
+
+    TeamState() : updated_cycle(-1), goalie_id(-1), history_head(0), ball(0, 0) {
+        for (int i = 0; i < MAX_ROBOTS_PER_TEAM; i++) {
+            x[i] = y[i] = vx[i] = vy[i] = dir[i] = 0;
+            last_x[i] = last_y[i] = last_dir[i] = 0;
+            speed[i] = rot_speed[i] = ball_dist[i] = ball_bearing[i] = 0;
+            for (int k = 0; k < HISTORY_SIZE; k++) {
+                hist_x[k][i] = hist_y[k][i] = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief 从世界模型更新本帧状态，同一帧重复调用直接返回
+     * @param model 世界模型指针
+     */
+    void update(const WorldModel* model) {
+        int cycle = model->get_cycle();
+        if (cycle == updated_cycle) {
+            return;
+        }
+        int frames = updated_cycle < 0 ? 0 : cycle - updated_cycle;
+        updated_cycle = cycle;
+
+        RobotSet previous = present;
+        present = TeamSource<Side>::present(model);
+        goalie_id = TeamSource<Side>::goalie(model);
+        field = present - RobotSet::single(goalie_id);
+        ball = model->get_ball_pos();
+        history_head = (history_head + 1) % HISTORY_SIZE;
+
+        // 1. 收集：只访问场上的车号
+        for (int i : present) {
+            point2f p = TeamSource<Side>::position(model, i);
+            point2f v = TeamSource<Side>::velocity(model, i);
+            last_x[i] = x[i];
+            last_y[i] = y[i];
+            last_dir[i] = dir[i];
+            x[i] = p.x;
+            y[i] = p.y;
+            vx[i] = v.x;
+            vy[i] = v.y;
+            dir[i] = TeamSource<Side>::orientation(model, i);
+        }
+        // 刚上场的机器人没有上一帧，用本帧代替，并用当前位置填满历史
+        for (int i : present - previous) {
+            last_x[i] = x[i];
+            last_y[i] = y[i];
+            last_dir[i] = dir[i];
+            for (int k = 0; k < HISTORY_SIZE; k++) {
+                hist_x[k][i] = x[i];
+                hist_y[k][i] = y[i];
+            }
+        }
+
+        // 2. 派生量：对整个数组做无分支的批量计算，不在场的车号结果无意义
+        float inv_dt = frames > 0 ? float(1.0 / (frames * FRAME_TIME)) : 0.0f;
+        for (int i = 0; i < MAX_ROBOTS_PER_TEAM; i++) {
+            float dx = ball.x - x[i];
+            float dy = ball.y - y[i];
+            speed[i] = std::sqrt(vx[i] * vx[i] + vy[i] * vy[i]);
+            ball_dist[i] = std::sqrt(dx * dx + dy * dy);
+            ball_bearing[i] = std::fabs(anglemod(std::atan2(dy, dx) - dir[i]));
+            rot_speed[i] = anglemod(dir[i] - last_dir[i]) * inv_dt;
+            hist_x[history_head][i] = x[i];
+            hist_y[history_head][i] = y[i];
+        }
+    }
+
+    /**
+     * @brief 最近一次更新时的周期，未更新过为-1
+     */
+    int cycle() const { return updated_cycle; }
+
+    // ---------------- 集合 ----------------
+    RobotSet robots() const { return present; }         // 场上全部机器人
+    RobotSet fieldPlayers() const { return field; }     // 场上除守门员外的机器人
+    int goalie() const { return goalie_id; }
+
+    // ---------------- 单个机器人 ----------------
+    point2f position(int id) const { return point2f(x[id], y[id]); }
+    point2f velocity(int id) const { return point2f(vx[id], vy[id]); }
+    point2f lastPosition(int id) const { return point2f(last_x[id], last_y[id]); }
+    float orientation(int id) const { return dir[id]; }
+    float speedOf(int id) const { return speed[id]; }
+    float rotationSpeed(int id) const { return rot_speed[id]; }
+    float ballDistance(int id) const { return ball_dist[id]; }
+
+    /**
+     * @brief 历史位置
+     * @param id 车号
+     * @param frames_ago 0为本帧，不超过HISTORY_SIZE-1
+     */
+    point2f history(int id, int frames_ago) const {
+        int k = (history_head - frames_ago % HISTORY_SIZE + HISTORY_SIZE) % HISTORY_SIZE;
+        return point2f(hist_x[k][id], hist_y[k][id]);
+    }
+
+    /**
+     * @brief 匀速预测位置
+     * @param id 车号
+     * @param time 预测时间（秒）
+     */
+    point2f predictPosition(int id, double time) const {
+        return point2f(float(x[id] + vx[id] * time), float(y[id] + vy[id] * time));
+    }
+
+    // ---------------- 批量查询 ----------------
+
+    /**
+     * @brief 在我方半场（x<0）的机器人
+     */
+    RobotSet inOurHalf(RobotSet set) const {
+        return set.filter([this](int i) { return x[i] < 0; });
+    }
+
+    /**
+     * @brief 在对方半场（x>0）的机器人
+     */
+    RobotSet inOppHalf(RobotSet set) const {
+        return set.filter([this](int i) { return x[i] > 0; });
+    }
+
+    /**
+     * @brief 在我方禁区内的机器人
+     * @param margin 禁区外扩距离
+     */
+    RobotSet inOurDefense(RobotSet set, float margin = 0) const {
+        return set.filter([this, margin](int i) { return Field::in_our_defense(x[i], y[i], margin); });
+    }
+
+    /**
+     * @brief 在对方禁区内的机器人
+     * @param margin 禁区外扩距离
+     */
+    RobotSet inOppDefense(RobotSet set, float margin = 0) const {
+        return set.filter([this, margin](int i) { return Field::in_opp_defense(x[i], y[i], margin); });
+    }
+
+    /**
+     * @brief 在以某点为圆心的圆内的机器人
+     */
+    RobotSet within(RobotSet set, const point2f& center, float radius) const {
+        float r2 = radius * radius;
+        return set.filter([this, &center, r2](int i) {
+            float dx = x[i] - center.x, dy = y[i] - center.y;
+            return dx * dx + dy * dy < r2;
+        });
+    }
+
+    /**
+     * @brief 控球的机器人：离球足够近且球在车头前方
+     * @param dist 控球距离阈值
+     */
+    RobotSet ballHolders(RobotSet set, float dist) const {
+        return set.filter([this, dist](int i) {
+            return (ball_dist[i] < dist) & (ball_bearing[i] < float(CONTROL_ANGLE));
+        });
+    }
+
+    /**
+     * @brief 离球最近的机器人（使用本帧预先算好的距离）
+     * @param set 候选集合
+     * @param out_dist 输出最近距离，可以为NULL
+     * @return 车号，集合为空时返回-1
+     */
+    int closestToBall(RobotSet set, float* out_dist = NULL) const {
+        int best = -1;
+        float best_dist = 1e9f;
+        for (int i : set) {
+            if (ball_dist[i] < best_dist) {
+                best_dist = ball_dist[i];
+                best = i;
+            }
+        }
+        if (out_dist) *out_dist = best_dist;
+        return best;
+    }
+
+    /**
+     * @brief 离指定点最近的机器人
+     * @param set 候选集合
+     * @param pos 目标点
+     * @param out_dist 输出最近距离，可以为NULL
+     * @return 车号，集合为空时返回-1
+     */
+    int closestTo(RobotSet set, const point2f& pos, float* out_dist = NULL) const {
+        int best = -1;
+        float best_d2 = 1e18f;
+        for (int i : set) {
+            float dx = x[i] - pos.x, dy = y[i] - pos.y;
+            float d2 = dx * dx + dy * dy;
+            if (d2 < best_d2) {
+                best_d2 = d2;
+                best = i;
+            }
+        }
+        if (out_dist) *out_dist = best < 0 ? 1e9f : std::sqrt(best_d2);
+        return best;
+    }
+
+    /**
+     * @brief 集合的平均位置，空集返回原点
+     */
+    point2f centroid(RobotSet set) const {
+        float sx = 0, sy = 0;
+        for (int i : set) {
+            sx += x[i];
+            sy += y[i];
+        }
+        int n = set.size();
+        return n > 0 ? point2f(sx / n, sy / n) : point2f(0, 0);
+    }
+
+    /**
+     * @brief 集合内两两之间的最大距离，不足两个时返回0
+     */
+    float maxPairDistance(RobotSet set) const {
+        float best_d2 = 0;
+        for (int i : set) {
+            for (int j : RobotSet(set.mask() & ~((2u << i) - 1u))) {
+                float dx = x[i] - x[j], dy = y[i] - y[j];
+                best_d2 = std::max(best_d2, dx * dx + dy * dy);
+            }
+        }
+        return std::sqrt(best_d2);
+    }
+
+private:
+    TeamState(const TeamState&) = delete;
+    TeamState& operator=(const TeamState&) = delete;
+
+    int updated_cycle;
+    RobotSet present, field;
+    int goalie_id;
+    int history_head;
+    point2f ball;
+
+    float x[MAX_ROBOTS_PER_TEAM], y[MAX_ROBOTS_PER_TEAM];
+    float vx[MAX_ROBOTS_PER_TEAM], vy[MAX_ROBOTS_PER_TEAM];
+    float dir[MAX_ROBOTS_PER_TEAM];
+    float last_x[MAX_ROBOTS_PER_TEAM], last_y[MAX_ROBOTS_PER_TEAM], last_dir[MAX_ROBOTS_PER_TEAM];
+    float speed[MAX_ROBOTS_PER_TEAM], rot_speed[MAX_ROBOTS_PER_TEAM];
+    float ball_dist[MAX_ROBOTS_PER_TEAM], ball_bearing[MAX_ROBOTS_PER_TEAM];
+    float hist_x[HISTORY_SIZE][MAX_ROBOTS_PER_TEAM], hist_y[HISTORY_SIZE][MAX_ROBOTS_PER_TEAM];
+};
+
+typedef TeamState<TeamSide::Our> OurTeamState;
+typedef TeamState<TeamSide::Opp> OppTeamState;
+
+#endif // TEAM_STATE_H
@@ -4,17 +4,15 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
-#include <chrono>
-#include <deque>
 #include "../utils/robot.h"
 #include "../utils/WorldModel.h"
 #include "../utils/constants.h"
 #include "../utils/vector.h"
 #include "../utils/maths.h"
 #include "ball_tools.h"
+#include "team_state.h"
 
 // 常量定义
-#define HISTORY_SIZE 10       // 历史数据记录大小
 #define BALL_CONTROL_THRESHOLD 50.0  // 球控制阈值(mm)
 
 /**
@@ -31,10 +29,7 @@ public:
     double orientation;             // 当前朝向(弧度)
     bool isActive;                  // 是否激活/存在
     bool hasBall;                   // 是否持球
-    
-    // 历史数据
-    std::deque<point2f> positionHistory;  // 位置历史
-    point2f lastPosition;                 // 上一帧位置
+    point2f lastPosition;           // 上一帧位置
     
     /**
      * @brief 构造函数
@@ -48,21 +43,7 @@ public:
         orientation(0),
         isActive(false),
         hasBall(false),
-        lastPosition(0, 0) {
-        
-        // 初始化历史数据队列
-        for (int i = 0; i < HISTORY_SIZE; i++) {
-            positionHistory.push_back(point2f(0, 0));
-        }
-    }
-    
-    /**
-     * @brief 更新历史数据
-     */
-    void updateHistory() {
-        positionHistory.pop_back();
-        positionHistory.push_front(position);
-    }
+        lastPosition(0, 0) {}
     
     /**
      * @brief 获取前进方向的单位向量
@@ -122,73 +103,47 @@ public:
      * @param model 世界模型指针
      * @param ballTools 球工具类引用
      * @param robotId 当前机器人ID
+     * @param teamState 我方队伍状态，由所属的PlannerContext提供
      */
-    Teammates(const WorldModel* model, BallTools& ballTools, int robotId) : 
+    Teammates(const WorldModel* model, BallTools& ballTools, int robotId, OurTeamState& teamState) : 
         model(model),
         ball(ballTools),
+        state(teamState),
         selfId(robotId),
         teammateCount(0) {
         
+        players.reserve(MAX_TEAM_ROBOTS);
         updateState();
-        last_update_time = std::chrono::high_resolution_clock::now();
     }
     
     /**
      * @brief 更新所有队友状态
-     * 每周期调用此函数更新信息
+     * 每周期调用此函数更新信息，位置、速度和历史由OurTeamState每帧统一更新一次，
+     * 各机器人的Teammates共用同一份
      */
     void updateState() {
-        auto current_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - last_update_time).count();
-        double dt = duration / 1000.0; // 转换为秒
+        state.update(model);
         
-        // 获取所有球员存在信息
-        const bool* exists = model->get_our_exist_id();
-        int goalieId = model->get_our_goalie();
+        // 场上除自己和守门员外的队友集合，players按车号从小到大排列，下标即rank
+        ids = state.fieldPlayers() - RobotSet::single(selfId);
+        holders = state.ballHolders(ids, BALL_CONTROL_THRESHOLD);
         
-        // 清空并重新填充队友信息
         players.clear();
         teammateCount = 0;
         
-        // 遍历所有可能的队友
-        for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-            // 排除自己、守门员和不存在的球员
-            if (exists[i] && i != selfId && i != goalieId) {
-                Teammate teammate(i);
-                teammate.isActive = true;
-                
-                // 更新基本信息
-                teammate.position = model->get_our_player_pos(i);
-                teammate.velocity = model->get_our_player_v(i);
-                teammate.orientation = model->get_our_player_dir(i);
-                teammate.speed = teammate.velocity.length();
-                
-                // 保存上一帧数据（如果有）
-                if (teammateCount < oldTeammates.size() && oldTeammates[teammateCount].id == i) {
-                    teammate.lastPosition = oldTeammates[teammateCount].position;
-                } else {
-                    teammate.lastPosition = teammate.position;
-                }
-                
-                // 更新历史数据
-                teammate.updateHistory();
-                
-                // 检查是否持球
-                double dist = (ball.position - teammate.position).length();
-                double angle_diff = fabs(anglemod((ball.position - teammate.position).angle() - teammate.orientation));
-                teammate.hasBall = (dist < BALL_CONTROL_THRESHOLD && angle_diff < M_PI/4);
-                
-                // 添加到队友列表
-                players.push_back(teammate);
-                teammateCount++;
-            }
+        for (int i : ids) {
+            Teammate teammate(i);
+            teammate.isActive = true;
+            teammate.position = state.position(i);
+            teammate.velocity = state.velocity(i);
+            teammate.orientation = state.orientation(i);
+            teammate.speed = state.speedOf(i);
+            teammate.lastPosition = state.lastPosition(i);
+            teammate.hasBall = holders.contains(i);
+            
+            players.push_back(teammate);
+            teammateCount++;
         }
-        
-        // 保存当前队友信息用于下一次更新
-        oldTeammates = players;
-        
-        // 更新时间
-        last_update_time = current_time;
     }
     
     /**
@@ -197,12 +152,8 @@ public:
      * @return 队友对象的引用，如果找不到则返回默认对象
      */
     const Teammate& getTeammate(int id) const {
-        for (const auto& teammate : players) {
-            if (teammate.id == id) {
-                return teammate;
-            }
-        }
-        return defaultTeammate;
+        int index = ids.rank(id);
+        return index < 0 ? defaultTeammate : players[index];
     }
     
     /**
@@ -210,22 +161,7 @@ public:
      * @return 最接近球的队友，如果没有则返回默认对象
      */
     const Teammate& getClosestToBall() const {
-        if (players.empty()) {
-            return defaultTeammate;
-        }
-        
-        double minDist = 9999.0;
-        int closestIndex = 0;
-        
-        for (size_t i = 0; i < players.size(); i++) {
-            double dist = players[i].distanceTo(ball.position);
-            if (dist < minDist) {
-                minDist = dist;
-                closestIndex = i;
-            }
-        }
-        
-        return players[closestIndex];
+        return getTeammate(state.closestToBall(ids));
     }
     
     /**
@@ -234,22 +170,7 @@ public:
      * @return 最接近的队友，如果没有则返回默认对象
      */
     const Teammate& getClosestToPosition(const point2f& pos) const {
-        if (players.empty()) {
-            return defaultTeammate;
-        }
-        
-        double minDist = 9999.0;
-        int closestIndex = 0;
-        
-        for (size_t i = 0; i < players.size(); i++) {
-            double dist = players[i].distanceTo(pos);
-            if (dist < minDist) {
-                minDist = dist;
-                closestIndex = i;
-            }
-        }
-        
-        return players[closestIndex];
+        return getTeammate(state.closestTo(ids, pos));
     }
     
     /**
@@ -257,12 +178,7 @@ public:
      * @return 持球队友，如果没有则返回默认对象
      */
     const Teammate& getBallHolder() const {
-        for (const auto& teammate : players) {
-            if (teammate.hasBall) {
-                return teammate;
-            }
-        }
-        return defaultTeammate;
+        return getTeammate(holders.first());
     }
     
     /**
@@ -270,12 +186,7 @@ public:
      * @return 是否有队友持球
      */
     bool hasTeammateBall() const {
-        for (const auto& teammate : players) {
-            if (teammate.hasBall) {
-                return true;
-            }
-        }
-        return false;
+        return !holders.empty();
     }
     
     /**
@@ -291,16 +202,7 @@ public:
      * @return 平均位置
      */
     point2f getAveragePosition() const {
-        if (players.empty()) {
-            return point2f(0, 0);
-        }
-        
-        point2f sum(0, 0);
-        for (const auto& teammate : players) {
-            sum = sum + teammate.position;
-        }
-        
-        return sum / static_cast<float>(players.size());
+        return state.centroid(ids);
     }
     
     /**
@@ -308,22 +210,7 @@ public:
      * @return 最大距离，如果不足两名队友则返回0
      */
     double getMaxTeammateDistance() const {
-        if (players.size() < 2) {
-            return 0.0;
-        }
-        
-        double maxDist = 0.0;
-        
-        for (size_t i = 0; i < players.size(); i++) {
-            for (size_t j = i+1; j < players.size(); j++) {
-                double dist = players[i].distanceTo(players[j].position);
-                if (dist > maxDist) {
-                    maxDist = dist;
-                }
-            }
-        }
-        
-        return maxDist;
+        return state.maxPairDistance(ids);
     }
     
     /**
@@ -402,11 +289,10 @@ public:
 private:
     const WorldModel* model;
     BallTools& ball;
-    std::vector<Teammate> oldTeammates;  // 上一帧的队友信息
+    OurTeamState& state;                 // 我方的逐帧共享状态
+    RobotSet ids;                        // 本次更新时场上的队友
+    RobotSet holders;                    // 本次更新时持球的队友
     Teammate defaultTeammate;            // 默认队友对象，用于找不到时返回
-    
-    // 上次更新时间
-    std::chrono::time_point<std::chrono::high_resolution_clock> last_update_time;
 };
 
 #endif // TEAMMATES_H 
\ No newline at end of file
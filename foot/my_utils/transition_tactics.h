@@ -22,8 +22,9 @@ public:
     /**
      * @brief 构造函数
      * @param model 世界模型指针
+     * @param env 所属上下文的运行环境
      */
-    explicit CounterAttackTactic(const WorldModel* model) : Tactic(model) {
+    explicit CounterAttackTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env) {
         name = "Counter Attack Tactic";
         type = TacticType::TRANSITION;
     }
@@ -44,6 +45,15 @@ public:
         return type;
     }
 
+    /**
+     * @brief 获取战术评估依赖的世界事件
+     * 攻防转换取决于球权与球所在区域
+     * @return WorldEvent位掩码
+     */
+    unsigned int getDependencies() const override {
+        return EVENT_POSSESSION_CHANGE | EVENT_BALL_ZONE_CHANGE | EVENT_REFEREE_COMMAND | EVENT_ROBOT_SET_CHANGE;
+    }
+
     /**
      * @brief 评估当前战术的适用性
      * @return 战术评估结果
@@ -62,15 +72,13 @@ public:
         if (ball_pos.x < 0 && ball_vel.x > 50) {
             // 检查我方是否控球
             bool our_ball_possession = false;
-            for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-                if (world_model->get_our_exist_id()[i]) {
-                    point2f player_pos = world_model->get_our_player_pos(i);
-                    
-                    // 如果有球员靠近球且正在移动
-                    if ((player_pos - ball_pos).length() < 30) {
-                        our_ball_possession = true;
-                        break;
-                    }
+            for (int i : world_model->get_our_set()) {
+                point2f player_pos = world_model->get_our_player_pos(i);
+                
+                // 如果有球员靠近球且正在移动
+                if ((player_pos - ball_pos).length() < 30) {
+                    our_ball_possession = true;
+                    break;
                 }
             }
             
@@ -79,14 +87,12 @@ public:
                 int opp_in_path = 0;
                 
                 // 计算通向对方球门的路径上有多少对手
-                for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-                    if (world_model->get_opp_exist_id()[i]) {
-                        point2f opp_pos = world_model->get_opp_player_pos(i);
-                        
-                        // 简单判断：如果对手在球和对方球门之间，则路径不开阔
-                        if (opp_pos.x > ball_pos.x && opp_pos.x < FIELD_LENGTH_H) {
-                            opp_in_path++;
-                        }
+                for (int i : world_model->get_opp_set()) {
+                    point2f opp_pos = world_model->get_opp_player_pos(i);
+                    
+                    // 简单判断：如果对手在球和对方球门之间，则路径不开阔
+                    if (opp_pos.x > ball_pos.x && opp_pos.x < FIELD_LENGTH_H) {
+                        opp_in_path++;
                     }
                 }
                 
@@ -187,8 +193,9 @@ public:
     /**
      * @brief 构造函数
      * @param model 世界模型指针
+     * @param env 所属上下文的运行环境
      */
-    explicit QuickDefenseTactic(const WorldModel* model) : Tactic(model) {
+    explicit QuickDefenseTactic(const WorldModel* model, const TacticEnv& env) : Tactic(model, env) {
         name = "Quick Defense Tactic";
         type = TacticType::TRANSITION;
     }
@@ -209,6 +216,15 @@ public:
         return type;
     }
 
+    /**
+     * @brief 获取战术评估依赖的世界事件
+     * 攻防转换取决于球权与球所在区域
+     * @return WorldEvent位掩码
+     */
+    unsigned int getDependencies() const override {
+        return EVENT_POSSESSION_CHANGE | EVENT_BALL_ZONE_CHANGE | EVENT_REFEREE_COMMAND | EVENT_ROBOT_SET_CHANGE;
+    }
+
     /**
      * @brief 评估当前战术的适用性
      * @return 战术评估结果
@@ -227,15 +243,13 @@ public:
         if (ball_pos.x > 0 && ball_vel.x < -50) {
             // 检查对方是否控球
             bool opp_ball_possession = false;
-            for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-                if (world_model->get_opp_exist_id()[i]) {
-                    point2f opp_pos = world_model->get_opp_player_pos(i);
-                    
-                    // 如果有对手靠近球且正在移动
-                    if ((opp_pos - ball_pos).length() < 30) {
-                        opp_ball_possession = true;
-                        break;
-                    }
+            for (int i : world_model->get_opp_set()) {
+                point2f opp_pos = world_model->get_opp_player_pos(i);
+                
+                // 如果有对手靠近球且正在移动
+                if ((opp_pos - ball_pos).length() < 30) {
+                    opp_ball_possession = true;
+                    break;
                 }
             }
             
@@ -243,14 +257,12 @@ public:
             if (opp_ball_possession) {
                 // 检查我方半场是否有足够防守队员
                 int defenders_count = 0;
-                for (int i = 0; i < MAX_TEAM_ROBOTS; i++) {
-                    if (world_model->get_our_exist_id()[i]) {
-                        point2f player_pos = world_model->get_our_player_pos(i);
-                        
-                        // 如果队员在我方半场
-                        if (player_pos.x < 0) {
-                            defenders_count++;
-                        }
+                for (int i : world_model->get_our_set()) {
+                    point2f player_pos = world_model->get_our_player_pos(i);
+                    
+                    // 如果队员在我方半场
+                    if (player_pos.x < 0) {
+                        defenders_count++;
                     }
                 }
                 
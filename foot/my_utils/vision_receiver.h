@@ -0,0 +1,471 @@
+#ifndef VISION_RECEIVER_H
+#define VISION_RECEIVER_H
+
+#ifdef __linux__
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <thread>
+#include <chrono>
+#include <utility>
+#include "pb_wire.h"
+#include "../utils/basevision.h"
+
+/**
+ * @brief 一个摄像头最近一次的检测结果
+ */
+struct VisionCameraFrame {
+    FieldVisionMsg msg;         // 球和机器人，单位cm，容量在接收器构造时预先分配
+    long long arrival_ns;       // 数据包到达时刻（内核时间戳，CLOCK_REALTIME，ns）
+    double t_capture;           // 视觉系统的采集时刻(s)
+    double t_sent;              // 视觉系统的发送时刻(s)
+    bool valid;                 // 是否收到过数据
+};
+
+/**
+ * @brief SSL-Vision组播接收器
+ * 用recvmmsg一次读取一批数据包，在接收缓冲区上直接解析SSL_WrapperPacket中的检测帧，
+ * 写入预先分配好的各摄像头FieldVisionMsg（mm转为cm），不产生临时消息对象；
+ * 套接字为非阻塞，fd()可交给RtLoop作为帧时钟。
+ */
+class VisionReceiver {
+public:
+    static const int MAX_CAMERAS = 8;
+    static const int BATCH = 16;                // 每次recvmmsg最多读取的包数
+    static const int PACKET_SIZE = 4096;        // 单个数据包的最大长度
+    static const int MAX_BALLS = 16;            // 每个摄像头预留的球数
+    static const int MAX_ROBOTS_PER_TEAM = 16;  // 每个摄像头每队预留的机器人数（车号0~15）
+
+    VisionReceiver() : sock(-1), packets(0), parse_errors(0), updated(0) {
+        for (int c = 0; c <= MAX_CAMERAS; c++) {
+            VisionCameraFrame& f = (c < MAX_CAMERAS) ? frames[c] : scratch;
+            f.msg.ball.reserve(MAX_BALLS);
+            f.msg.buleRobot.reserve(MAX_ROBOTS_PER_TEAM);
+            f.msg.yellowRobot.reserve(MAX_ROBOTS_PER_TEAM);
+            f.arrival_ns = 0;
+            f.t_capture = 0;
+            f.t_sent = 0;
+            f.valid = false;
+        }
+        std::memset(headers, 0, sizeof(headers));
+        for (int i = 0; i < BATCH; i++) {
+            iov[i].iov_base = buffers[i];
+            iov[i].iov_len = PACKET_SIZE;
+            headers[i].msg_hdr.msg_iov = &iov[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    ~VisionReceiver() {
+        close();
+    }
+
+    VisionReceiver(const VisionReceiver&) = delete;
+    VisionReceiver& operator=(const VisionReceiver&) = delete;
+
+    /**
+     * @brief 加入组播组并开始接收
+     * @param group 组播地址，SSL-Vision默认224.5.23.2
+     * @param port 端口，SSL-Vision默认10006
+     * @param iface 接收组播的本机网卡地址，0.0.0.0为系统默认
+     * @return 是否成功
+     */
+    bool open(const char* group = "224.5.23.2", int port = 10006, const char* iface = "0.0.0.0") {
+        close();
+        sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (sock < 0) {
+            return fail("socket");
+        }
+        int one = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) != 0) {
+            warn("SO_TIMESTAMPNS");
+        }
+        int rcvbuf = BATCH * PACKET_SIZE * 8;
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            return fail("bind");
+        }
+
+        ip_mreq mreq;
+        std::memset(&mreq, 0, sizeof(mreq));
+        if (inet_pton(AF_INET, group, &mreq.imr_multiaddr) != 1 || inet_pton(AF_INET, iface, &mreq.imr_interface) != 1) {
+            errno = EINVAL;
+            return fail("multicast address");
+        }
+        if (setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+            return fail("IP_ADD_MEMBERSHIP");
+        }
+        return true;
+    }
+
+    void close() {
+        if (sock >= 0) {
+            ::close(sock);
+            sock = -1;
+        }
+    }
+
+    int fd() const { return sock; }
+
+    /**
+     * @brief 读空套接字中所有已到达的数据包并解析，不阻塞
+     * @return 本次解析成功的检测帧数量
+     */
+    int poll() {
+        updated = 0;
+        if (sock < 0) {
+            return 0;
+        }
+        int parsed = 0;
+        for (;;) {
+            for (int i = 0; i < BATCH; i++) {
+                headers[i].msg_hdr.msg_control = control[i];
+                headers[i].msg_hdr.msg_controllen = sizeof(control[i]);
+                headers[i].msg_hdr.msg_flags = 0;
+            }
+            int n = recvmmsg(sock, headers, BATCH, MSG_DONTWAIT, NULL);
+            if (n <= 0) {
+                if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    warn("recvmmsg");
+                }
+                break;
+            }
+            for (int i = 0; i < n; i++) {
+                packets++;
+                if (headers[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                    parse_errors++;
+                    continue;
+                }
+                if (parseWrapper(buffers[i], headers[i].msg_len, arrivalTime(headers[i].msg_hdr))) {
+                    parsed++;
+                }
+            }
+            if (n < BATCH) {
+                break;
+            }
+        }
+        return parsed;
+    }
+
+    /**
+     * @brief 解析一个SSL_WrapperPacket，供poll和离线回放使用；格式错误计入errorCount
+     * @param arrival_ns 到达时刻
+     * @return 是否包含有效的检测帧（只有几何信息的包返回false）
+     */
+    bool parseWrapper(const unsigned char* data, size_t size, long long arrival_ns) {
+        PbReader wrapper(data, size);
+        uint32_t field, wire;
+        bool found = false;
+        bool good = true;
+        while (wrapper.next(field, wire)) {
+            if (field == 1 && wire == PB_LENGTH_DELIMITED) {
+                PbReader detection = wrapper.message();
+                bool parsed = parseDetection(detection, arrival_ns);
+                found = found || parsed;
+                good = good && parsed;
+            } else {
+                wrapper.skip(wire);   // 几何信息等
+            }
+        }
+        if (!good || !wrapper.ok()) {
+            parse_errors++;
+        }
+        return found;
+    }
+
+    const VisionCameraFrame& camera(int id) const { return frames[id]; }
+
+    /**
+     * @brief 最近一次poll中更新过的摄像头，第i位对应摄像头i
+     */
+    unsigned int updatedCameras() const { return updated; }
+
+    long long packetCount() const { return packets; }
+    long long errorCount() const { return parse_errors; }
+
+private:
+    /**
+     * @brief 解析SSL_DetectionFrame
+     * 先扫一遍取camera_id（字段顺序不保证），再把球和机器人解析到scratch，
+     * 整帧解析成功后才和该摄像头的缓冲区交换，格式错误的包不会破坏上一帧
+     */
+    bool parseDetection(PbReader detection, long long arrival_ns) {
+        PbReader scan = detection;
+        uint32_t field, wire;
+        int camera_id = -1;
+        while (scan.next(field, wire)) {
+            if (field == 4 && wire == PB_VARINT) {
+                camera_id = static_cast<int>(scan.varint());
+            } else {
+                scan.skip(wire);
+            }
+        }
+        if (!scan.ok() || camera_id < 0 || camera_id >= MAX_CAMERAS) {
+            return false;
+        }
+
+        VisionCameraFrame& f = scratch;
+        FieldVisionMsg& msg = f.msg;
+        msg.cameraId = camera_id;
+        msg.ball.clear();
+        msg.buleRobot.clear();
+        msg.yellowRobot.clear();
+        while (detection.next(field, wire)) {
+            switch (field) {
+                case 1: msg.frame = static_cast<int>(detection.varint()); break;
+                case 2: f.t_capture = detection.fixed64d(); break;
+                case 3: f.t_sent = detection.fixed64d(); break;
+                case 5: {
+                    PbReader ball = detection.message();
+                    if (msg.ball.size() < static_cast<size_t>(MAX_BALLS)) {
+                        msg.ball.push_back(parseBall(ball));
+                    }
+                    break;
+                }
+                case 6:
+                case 7: {
+                    PbReader robot = detection.message();
+                    std::vector<Robot>& team = (field == 6) ? msg.yellowRobot : msg.buleRobot;
+                    if (team.size() < static_cast<size_t>(MAX_ROBOTS_PER_TEAM)) {
+                        team.push_back(parseRobot(robot));
+                    }
+                    break;
+                }
+                default: detection.skip(wire); break;
+            }
+        }
+        if (!detection.ok()) {
+            return false;
+        }
+        f.arrival_ns = arrival_ns;
+        f.valid = true;
+        // 交换只移动vector的指针，旧缓冲区留作下一帧的scratch，不分配内存
+        std::swap(frames[camera_id], scratch);
+        updated |= 1u << camera_id;
+        return true;
+    }
+
+    static point2f parseBall(PbReader ball) {
+        uint32_t field, wire;
+        float x = 0, y = 0;
+        while (ball.next(field, wire)) {
+            if (field == 3 && wire == PB_FIXED32) x = ball.fixed32f();
+            else if (field == 4 && wire == PB_FIXED32) y = ball.fixed32f();
+            else ball.skip(wire);
+        }
+        return point2f(x * MM_TO_CM, y * MM_TO_CM);
+    }
+
+    static Robot parseRobot(PbReader robot) {
+        uint32_t field, wire;
+        Robot r;
+        while (robot.next(field, wire)) {
+            if (field == 2 && wire == PB_VARINT) r.id = static_cast<int>(robot.varint());
+            else if (field == 3 && wire == PB_FIXED32) r.pos.x = robot.fixed32f() * MM_TO_CM;
+            else if (field == 4 && wire == PB_FIXED32) r.pos.y = robot.fixed32f() * MM_TO_CM;
+            else if (field == 5 && wire == PB_FIXED32) r.orientation = robot.fixed32f();
+            else robot.skip(wire);
+        }
+        return r;
+    }
+
+    static long long arrivalTime(const msghdr& hdr) {
+        for (cmsghdr* c = CMSG_FIRSTHDR(const_cast<msghdr*>(&hdr)); c; c = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+            }
+        }
+        // 内核未提供时间戳时用读取时刻代替
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    bool fail(const char* what) {
+        warn(what);
+        close();
+        return false;
+    }
+
+    static void warn(const char* what) {
+        std::fprintf(stderr, "[VisionReceiver] %s: %s\n", what, std::strerror(errno));
+    }
+
+    static constexpr float MM_TO_CM = 0.1f;
+
+    int sock;
+    long long packets;
+    long long parse_errors;
+    unsigned int updated;
+    VisionCameraFrame frames[MAX_CAMERAS];
+    VisionCameraFrame scratch;                  // 正在解析的检测帧，成功后与frames交换
+    unsigned char buffers[BATCH][PACKET_SIZE];
+    char control[BATCH][CMSG_SPACE(sizeof(timespec))];
+    iovec iov[BATCH];
+    mmsghdr headers[BATCH];
+};
+
+/**
+ * @brief 本地视觉数据包回放器，代替SSL-Vision向组播组发送检测帧，用于联调和测试
+ * 录像文件格式：每条记录为 到达时刻ns(int64) | 长度(uint32) | SSL_WrapperPacket原始字节
+ */
+class VisionReplayer {
+public:
+    static const int PACKET_SIZE = VisionReceiver::PACKET_SIZE;
+
+    VisionReplayer() : sock(-1) {
+        std::memset(&dest, 0, sizeof(dest));
+    }
+
+    ~VisionReplayer() {
+        close();
+    }
+
+    VisionReplayer(const VisionReplayer&) = delete;
+    VisionReplayer& operator=(const VisionReplayer&) = delete;
+
+    /**
+     * @brief 打开发送套接字，组播只在本机回环（TTL为0）
+     * @param group 组播地址
+     * @param port 端口
+     * @param iface 发送组播的本机网卡地址，须与VisionReceiver::open的iface相同才能收到；0.0.0.0为系统默认
+     */
+    bool open(const char* group = "224.5.23.2", int port = 10006, const char* iface = "0.0.0.0") {
+        close();
+        sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (sock < 0) {
+            return false;
+        }
+        unsigned char ttl = 0, loop = 1;
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        in_addr local;
+        dest.sin_family = AF_INET;
+        dest.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, iface, &local) != 1 || inet_pton(AF_INET, group, &dest.sin_addr) != 1 ||
+            setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local)) != 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (sock >= 0) {
+            ::close(sock);
+            sock = -1;
+        }
+    }
+
+    bool send(const unsigned char* data, size_t size) {
+        return sock >= 0 && sendto(sock, data, size, 0, reinterpret_cast<const sockaddr*>(&dest), sizeof(dest)) == static_cast<ssize_t>(size);
+    }
+
+    /**
+     * @brief 把一帧FieldVisionMsg（单位cm）编码为SSL_WrapperPacket
+     * @return 编码长度，缓冲区不足返回-1
+     */
+    static int encode(const FieldVisionMsg& msg, double t_capture, unsigned char* out, size_t capacity) {
+        PbWriter w(out, capacity);
+        size_t detection = w.beginMessage(1);
+        w.uint32Field(1, static_cast<uint32_t>(msg.frame));
+        w.doubleField(2, t_capture);
+        w.doubleField(3, t_capture);
+        w.uint32Field(4, static_cast<uint32_t>(msg.cameraId));
+        for (size_t i = 0; i < msg.ball.size(); i++) {
+            size_t ball = w.beginMessage(5);
+            w.floatField(1, 1.0f);
+            w.floatField(3, msg.ball[i].x * CM_TO_MM);
+            w.floatField(4, msg.ball[i].y * CM_TO_MM);
+            w.endMessage(ball);
+        }
+        encodeRobots(w, 6, msg.yellowRobot);
+        encodeRobots(w, 7, msg.buleRobot);
+        w.endMessage(detection);
+        return w.overflow() ? -1 : static_cast<int>(w.size());
+    }
+
+    /**
+     * @brief 向录像文件追加一条记录
+     */
+    static bool appendRecord(FILE* file, long long arrival_ns, const unsigned char* data, uint32_t size) {
+        int64_t t = arrival_ns;
+        return std::fwrite(&t, sizeof(t), 1, file) == 1 &&
+               std::fwrite(&size, sizeof(size), 1, file) == 1 &&
+               std::fwrite(data, 1, size, file) == size;
+    }
+
+    /**
+     * @brief 按录制时的间隔回放录像文件
+     * @param speed 回放倍速，小于等于0时不等待、尽快发送
+     * @return 发送的数据包数量，文件无法打开返回-1
+     */
+    int replayFile(const char* path, double speed = 1.0) {
+        FILE* file = std::fopen(path, "rb");
+        if (!file) {
+            return -1;
+        }
+        unsigned char buffer[PACKET_SIZE];
+        int sent = 0;
+        long long first_record = 0;
+        auto first_wall = std::chrono::steady_clock::now();
+        int64_t t;
+        uint32_t size;
+        while (std::fread(&t, sizeof(t), 1, file) == 1 && std::fread(&size, sizeof(size), 1, file) == 1) {
+            if (size > sizeof(buffer) || std::fread(buffer, 1, size, file) != size) {
+                break;
+            }
+            if (sent == 0) {
+                first_record = t;
+                first_wall = std::chrono::steady_clock::now();
+            } else if (speed > 0) {
+                auto due = first_wall + std::chrono::nanoseconds(static_cast<long long>((t - first_record) / speed));
+                std::this_thread::sleep_until(due);
+            }
+            if (send(buffer, size)) {
+                sent++;
+            }
+        }
+        std::fclose(file);
+        return sent;
+    }
+
+private:
+    static void encodeRobots(PbWriter& w, uint32_t field, const std::vector<Robot>& robots) {
+        for (size_t i = 0; i < robots.size(); i++) {
+            size_t robot = w.beginMessage(field);
+            w.floatField(1, 1.0f);
+            w.uint32Field(2, static_cast<uint32_t>(robots[i].id));
+            w.floatField(3, robots[i].pos.x * CM_TO_MM);
+            w.floatField(4, robots[i].pos.y * CM_TO_MM);
+            w.floatField(5, robots[i].orientation);
+            w.endMessage(robot);
+        }
+    }
+
+    static constexpr float CM_TO_MM = 10.0f;
+
+    int sock;
+    sockaddr_in dest;
+};
+
+#endif // __linux__
+
+#endif // VISION_RECEIVER_H
@@ -0,0 +1,185 @@
+#ifndef WORLD_EVENTS_H
+#define WORLD_EVENTS_H
+
+#include <cmath>
+#include "../utils/worldmodel.h"
+#include "../utils/constants.h"
+#include "../utils/vector.h"
+#include "../utils/maths.h"
+
+/**
+ * @brief 世界状态变化事件（位掩码），战术通过它声明自己依赖哪些变化
+ */
+enum WorldEvent : unsigned int {
+    EVENT_NONE               = 0,
+    EVENT_POSSESSION_CHANGE  = 1u << 0,   // 球权变化（我方/对方/无人控球）
+    EVENT_BALL_ZONE_CHANGE   = 1u << 1,   // 球跨越区域边界
+    EVENT_REFEREE_COMMAND    = 1u << 2,   // 裁判指令导致比赛状态变化
+    EVENT_OPP_BOX_CHANGE     = 1u << 3,   // 对手进入或离开我方禁区
+    EVENT_ROBOT_SET_CHANGE   = 1u << 4,   // 场上机器人出现或消失
+    EVENT_ALL                = 0xFFFFFFFFu
+};
+
+/**
+ * @brief 球权归属
+ */
+enum class Possession {
+    NONE,   // 无人控球
+    OURS,   // 我方控球
+    THEIRS  // 对方控球
+};
+
+/**
+ * @brief 世界状态变化检测器
+ * 每帧比较一次关键状态，产生失效事件；同一帧内重复调用不会重复产生事件
+ */
+class WorldChangeDetector {
+public:
+    WorldChangeDetector() :
+        last_cycle(-1),
+        current_events(EVENT_ALL),
+        possession(Possession::NONE),
+        zone_x(-1),
+        zone_y(-1),
+        game_state(-1),
+        opp_in_box(false),
+        our_mask(0),
+        opp_mask(0) {}
+
+    /**
+     * @brief 检测本帧的状态变化
+     * @param model 世界模型指针
+     * @return 是否进入了新的一帧（同一帧的后续调用返回false）
+     */
+    bool update(const WorldModel* model) {
+        int cycle = model->get_cycle();
+        if (cycle == last_cycle) {
+            return false;
+        }
+        bool first_frame = (last_cycle < 0);
+        last_cycle = cycle;
+
+        unsigned int events = first_frame ? EVENT_ALL : EVENT_NONE;
+        point2f ball_pos = model->get_ball_pos();
+
+        // 1. 裁判指令
+        const GameState* state = model->game_states();
+        int new_game_state = state ? state->get() : 0;
+        if (new_game_state != game_state) {
+            events |= EVENT_REFEREE_COMMAND;
+            game_state = new_game_state;
+        }
+
+        // 2. 场上机器人集合直接取位掩码，再遍历集合求最近距离和对手进入禁区
+        RobotSet our_set = model->get_our_set();
+        RobotSet opp_set = model->get_opp_set();
+        unsigned int new_our_mask = our_set.mask();
+        unsigned int new_opp_mask = opp_set.mask();
+        bool new_opp_in_box = false;
+        double our_min_dist = 9999.0;
+        double opp_min_dist = 9999.0;
+
+        for (int i : our_set) {
+            double dist = (model->get_our_player_pos(i) - ball_pos).length();
+            if (dist < our_min_dist) our_min_dist = dist;
+        }
+        for (int i : opp_set) {
+            const point2f& opp_pos = model->get_opp_player_pos(i);
+            double dist = (opp_pos - ball_pos).length();
+            if (dist < opp_min_dist) opp_min_dist = dist;
+            if (Maths::is_inside_penatly(opp_pos)) new_opp_in_box = true;
+        }
+
+        if (new_our_mask != our_mask || new_opp_mask != opp_mask) {
+            events |= EVENT_ROBOT_SET_CHANGE;
+            our_mask = new_our_mask;
+            opp_mask = new_opp_mask;
+        }
+
+        if (new_opp_in_box != opp_in_box) {
+            events |= EVENT_OPP_BOX_CHANGE;
+            opp_in_box = new_opp_in_box;
+        }
+
+        // 3. 球权：最近机器人在控球距离内才算控球
+        Possession new_possession = Possession::NONE;
+        if (our_min_dist < POSSESSION_DIST && our_min_dist <= opp_min_dist) {
+            new_possession = Possession::OURS;
+        } else if (opp_min_dist < POSSESSION_DIST) {
+            new_possession = Possession::THEIRS;
+        }
+        if (new_possession != possession) {
+            events |= EVENT_POSSESSION_CHANGE;
+            possession = new_possession;
+        }
+
+        // 4. 球所在区域（纵向三等分 x 横向三等分），带滞回避免在边界抖动
+        int new_zone_x = zoneIndex(ball_pos.x, FIELD_LENGTH, zone_x);
+        int new_zone_y = zoneIndex(ball_pos.y, FIELD_WIDTH, zone_y);
+        if (new_zone_x != zone_x || new_zone_y != zone_y) {
+            events |= EVENT_BALL_ZONE_CHANGE;
+            zone_x = new_zone_x;
+            zone_y = new_zone_y;
+        }
+
+        current_events = events;
+        return true;
+    }
+
+    /**
+     * @brief 获取本帧产生的事件
+     * @return 事件位掩码
+     */
+    unsigned int events() const {
+        return current_events;
+    }
+
+    /**
+     * @brief 获取当前球权归属
+     * @return 球权
+     */
+    Possession getPossession() const {
+        return possession;
+    }
+
+private:
+    static constexpr double POSSESSION_DIST = 30.0;   // 控球判定距离(cm)
+    static constexpr double ZONE_HYSTERESIS = 10.0;   // 区域边界滞回宽度(cm)
+
+    /**
+     * @brief 将坐标映射到三等分区域编号，只有越过边界超过滞回宽度才切换
+     * @param v 坐标值
+     * @param length 该方向场地总长
+     * @param last 上一帧的区域编号，-1表示无
+     * @return 区域编号(0-2)
+     */
+    static int zoneIndex(double v, double length, int last) {
+        double third = length / 3.0;
+        double shifted = v + length / 2.0;
+        int zone = static_cast<int>(std::floor(shifted / third));
+        if (zone < 0) zone = 0;
+        if (zone > 2) zone = 2;
+        if (last < 0 || zone == last) {
+            return zone;
+        }
+        // 距上一区域的边界不足滞回宽度时保持原区域
+        double lower = last * third;
+        double upper = (last + 1) * third;
+        if (shifted > lower - ZONE_HYSTERESIS && shifted < upper + ZONE_HYSTERESIS) {
+            return last;
+        }
+        return zone;
+    }
+
+    int last_cycle;
+    unsigned int current_events;
+    Possession possession;
+    int zone_x;
+    int zone_y;
+    int game_state;
+    bool opp_in_box;
+    unsigned int our_mask;
+    unsigned int opp_mask;
+};
+
+#endif // WORLD_EVENTS_H
@@ -5,6 +5,7 @@
 #include <vector>
 #include <chrono>
 #include <map>
+#include <atomic>
 
 // 工具头文件
 #include "utils/maths.h"
@@ -12,6 +13,8 @@
 #include "utils/WorldModel.h"
 #include "utils/game_state.h"
 #include "utils/PlayerTask.h"
+#include "utils/task_board.h"
+#include "utils/world_snapshot.h"
 #include "utils/vector.h"
 
 // 自定义工具
@@ -24,279 +27,470 @@
 #include "my_utils/logger.h"
 #include "my_utils/communication.h"
 #include "my_utils/tactics.h"
+#include "my_utils/world_events.h"
+#include "my_utils/behavior_tree.h"
+#include "my_utils/set_piece_planner.h"
+#include "my_utils/task_horizon.h"
+#include "my_utils/rule_projection.h"
+#include "my_utils/radio_output.h"
 #include "my_utils/attack_tactics.h"
 #include "my_utils/defense_tactics.h"
 #include "my_utils/special_tactics.h"
 #include "my_utils/transition_tactics.h"
+#include "my_utils/planner_context.h"
+#include "my_utils/job_graph.h"
+#include "my_utils/background_planner.h"
+#include "my_utils/support_map.h"
 
 using namespace std;
 
-// 定义比赛状态常量（如果在special_tactics.h中已有定义，则这些定义将被忽略）
-#ifndef PM_NORMAL
-#define PM_NORMAL 99
-#endif
+struct PlannerState;
 
-// 全局变量
-static BallTools* ball_tools = nullptr;
-static Players* our_players = nullptr;
-static OppPlayers* opp_players = nullptr;
-static OppGoalie* opp_goalie = nullptr;
-static TacticFactory* tactic_factory = nullptr;
-static int cycle_counter = 0;
-static bool initialized = false;
+// 行为树共享上下文
+struct PlanContext {
+    PlannerState* planner;            // 所属的规划器实例
+    const WorldModel* model;
+    int robot_id;
+    PlayMode play_mode;
+    point2f ball_pos;
+    point2f player_pos;
+    Message pass_msg;                 // 收到的传球意图
+    Tactic* tactic;                   // 条件节点选出的待执行战术
+    int pass_target;                  // 条件节点选出的传球目标
+    bool has_support;                 // support是否在时效内
+    BackgroundPlanner<SupportMap>::Published support;  // 后台计算的接应点
+    PlannedTask plan;                 // 输出任务及其多步计划
+};
+
+// 后台接应点结果最多滞后的帧数（60Hz下0.5s），更旧的结果不使用
+static const int SUPPORT_MAX_AGE = 30;
+
+// 一个规划器实例的决策状态；日志、通信、战术工厂、工具类和周期计数由PlannerContext持有
+// player_plan使用默认上下文上的实例，team_plan每个句柄有自己的上下文和实例
+struct PlannerState {
+    PlannerContext* context = nullptr;
+    const WorldModel* model = nullptr;                  // planner_create绑定的世界模型
+    WorldChangeDetector change_detector;
+    BehaviorTree<PlanContext> decision_tree;
+    TaskHorizonExecutor horizon_executors[MAX_ROBOTS];  // 每个机器人的多步任务执行器
+    int frame_cycle = -1;                               // 最近一次做过帧级共享计算的周期
+    JobGraph frame_graph;                               // 帧级共享计算
+    const WorldModel* frame_model = nullptr;            // 帧级作业本帧使用的世界模型
+    WorldSnapshot frame_snapshot;                       // 本帧机器人集合和状态的快照，由snapshot_sets作业填写
+    std::unique_ptr<JobPool> job_pool;                  // 为空时帧级作业串行执行
+    std::unique_ptr<BackgroundPlanner<SupportMap>> background;  // 跨帧细化的接应点热图
+    bool use_background = false;                        // 是否启动后台线程，只有planner_create的句柄启用
+    bool ready = false;                                 // 战术已注册、行为树已构建
+};
+
+// player_plan使用的实例，运行在由各单例组成的默认上下文上
+static PlannerState& defaultPlanner() {
+    static PlannerState planner;
+    planner.context = &PlannerContext::getDefault();
+    return planner;
+}
 
 // 初始化函数
-void initialize(const WorldModel* model, int robot_id) {
-    // 初始化工具类
-    ball_tools = new BallTools(model);
-    our_players = new Players(model);
-    opp_players = new OppPlayers(model);
-    opp_goalie = new OppGoalie(model);
+void initialize(PlannerState& planner, const WorldModel* model, int robot_id) {
+    PlannerContext& context = *planner.context;
     
-    // 初始化日志
-    Logger::getInstance().setLogLevel(LogLevel::INFO);
-    Logger::getInstance().setDebugOutput(true);
+    // 初始化工具类、日志和通信
+    context.initialize(model, robot_id);
     
-    // 初始化通信
-    Communication::getInstance().initialize(robot_id);
-    
-    // 初始化战术
-    tactic_factory = &TacticFactory::getInstance();
+    // 战术注册到本上下文的战术工厂，使用本上下文的队伍状态、定位球方案、日志和通信
+    TacticFactory& factory = context.getTacticFactory();
+    TacticEnv env = context.getTacticEnv();
     
     // 注册进攻战术
-    tactic_factory->registerTactic(std::make_shared<DirectAttackTactic>(model));
-    tactic_factory->registerTactic(std::make_shared<PassAndShootTactic>(model));
-    tactic_factory->registerTactic(std::make_shared<WingAttackTactic>(model));
+    factory.registerTactic(std::make_shared<DirectAttackTactic>(model, env));
+    factory.registerTactic(std::make_shared<PassAndShootTactic>(model, env));
+    factory.registerTactic(std::make_shared<WingAttackTactic>(model, env));
     
     // 注册防守战术
-    tactic_factory->registerTactic(std::make_shared<ManMarkingTactic>(model));
-    tactic_factory->registerTactic(std::make_shared<ZoneDefenseTactic>(model));
-    tactic_factory->registerTactic(std::make_shared<RetreatDefenseTactic>(model));
+    factory.registerTactic(std::make_shared<ManMarkingTactic>(model, env));
+    factory.registerTactic(std::make_shared<ZoneDefenseTactic>(model, env));
+    factory.registerTactic(std::make_shared<RetreatDefenseTactic>(model, env));
     
     // 注册特殊战术
-    tactic_factory->registerTactic(std::make_shared<KickoffTactic>(model));
-    tactic_factory->registerTactic(std::make_shared<FreeKickTactic>(model));
-    tactic_factory->registerTactic(std::make_shared<CornerKickTactic>(model));
+    factory.registerTactic(std::make_shared<KickoffTactic>(model, env));
+    factory.registerTactic(std::make_shared<FreeKickTactic>(model, env));
+    factory.registerTactic(std::make_shared<CornerKickTactic>(model, env));
     
     // 注册转换战术
-    tactic_factory->registerTactic(std::make_shared<CounterAttackTactic>(model));
-    tactic_factory->registerTactic(std::make_shared<QuickDefenseTactic>(model));
+    factory.registerTactic(std::make_shared<CounterAttackTactic>(model, env));
+    factory.registerTactic(std::make_shared<QuickDefenseTactic>(model, env));
+    
+    // 启动后台接应点计算，每帧在帧级作业中交给它最新快照；
+    // player_plan的默认规划器不启动线程，旧宿主不调用任何新接口也能直接FreeLibrary
+    if (planner.use_background) {
+        planner.background.reset(new BackgroundPlanner<SupportMap>(
+            std::unique_ptr<BackgroundTask<SupportMap>>(new SupportMapTask())));
+        planner.background->start();
+    }
     
     // 标记初始化完成
-    initialized = true;
+    planner.ready = true;
     
-    debug_output("Robot 2 initialized, ID: " + std::to_string(robot_id));
+    debug_output("Robot 2 initialized, ID: " + std::to_string(robot_id) + ", context " + context.getName());
 }
 
 // 清理函数
-void cleanup() {
-    if (ball_tools) delete ball_tools;
-    if (our_players) delete our_players;
-    if (opp_players) delete opp_players;
-    if (opp_goalie) delete opp_goalie;
+void cleanup(PlannerState& planner) {
+    // 停止后台线程，注销战术（再次初始化时重新注册），释放工具类并关闭通信
+    planner.background.reset();
+    planner.context->getTacticFactory().clearTactics();
+    planner.context->cleanup();
+    planner.ready = false;
+    
+    debug_output("Robot 2 resources cleaned up");
+}
+
+// ===== 决策行为树 =====
+// 决策流程在初始化时构建为扁平行为树，每个分支对应下面的一个条件/动作节点
+
+// 这些事件发生时放弃正在执行的多步任务并重新规划
+static const unsigned int HORIZON_ABORT_EVENTS = EVENT_REFEREE_COMMAND | EVENT_ROBOT_SET_CHANGE;
+
+// 比赛是否处于停止状态
+static bool isGameStopped(PlanContext& ctx) {
+    return ctx.play_mode == PlayMode::Stop || ctx.play_mode == PlayMode::Halt;
+}
+
+// 停在原地
+static BTStatus holdPosition(PlanContext& ctx) {
+    ctx.plan.task.target_pos = ctx.planner->context->our_players->getPosition(ctx.robot_id);
+    ctx.plan.task.orientate = ctx.planner->context->our_players->getOrientation(ctx.robot_id);
+    debug_output("Game stopped, robot " + std::to_string(ctx.robot_id) + " holding position");
+    return BTStatus::SUCCESS;
+}
+
+// 交换球员状态信息，并检查是否收到了传球意图
+static bool hasPassIntention(PlanContext& ctx) {
+    bool has_ball = ctx.planner->context->our_players->canHoldBall(ctx.robot_id);
+    ctx.planner->context->getCommunication().broadcastBallPossession(has_ball, ctx.ball_pos);
     
-    // 清理通信
-    Communication::getInstance().cleanup();
+    ctx.pass_msg = ctx.planner->context->getCommunication().receiveMessage(MessageType::PASS_INTENTION);
+    return ctx.pass_msg.receiver_id == ctx.robot_id;
+}
+
+// 移动到传球接应位置，并给出"接球-转身-射门"的多步计划
+static BTStatus moveToReception(PlanContext& ctx) {
+    debug_output("Received pass intention, moving to reception position, robot " + std::to_string(ctx.robot_id));
+    ctx.plan.task = ctx.planner->context->our_players->createMoveTask(ctx.robot_id, ctx.pass_msg.position);
     
-    // 重置指针
-    ball_tools = nullptr;
-    our_players = nullptr;
-    opp_players = nullptr;
-    opp_goalie = nullptr;
+    point2f reception = ctx.pass_msg.position;
+    point2f goal(FIELD_LENGTH_H, 0);
+    double face_ball = atan2(ctx.ball_pos.y - reception.y, ctx.ball_pos.x - reception.x);
+    double face_goal = atan2(goal.y - reception.y, goal.x - reception.x);
     
-    debug_output("Robot 2 resources cleaned up");
+    // 1. 在接应点面向球等待，开启吸球，直到球进入控球范围
+    TaskStep receive = TaskHorizonExecutor::makeStep(reception, face_ball, STEP_BALL_CONTROL, 12, 180);
+    receive.needCb = true;
+    TaskHorizonExecutor::appendStep(ctx.plan, receive);
+    
+    // 2. 带球转向球门
+    TaskStep turn = TaskHorizonExecutor::makeStep(reception, face_goal, STEP_FACING, 0.1, 60);
+    turn.needCb = true;
+    TaskHorizonExecutor::appendStep(ctx.plan, turn);
+    
+    // 3. 射门，直到球被踢出
+    TaskStep shoot = TaskHorizonExecutor::makeStep(reception, face_goal, STEP_KICKED, 100, 30);
+    shoot.needKick = true;
+    shoot.kickPower = 8.0;
+    TaskHorizonExecutor::appendStep(ctx.plan, shoot);
+    return BTStatus::SUCCESS;
+}
+
+// 存在高评分的特殊情况战术
+static bool specialTacticReady(PlanContext& ctx) {
+    ctx.tactic = ctx.planner->context->getTacticFactory().selectBestTactic(TacticType::SPECIAL_SITUATION);
+    return ctx.tactic && ctx.planner->context->getTacticFactory().getBestScore(TacticType::SPECIAL_SITUATION) > 0.5;
+}
+
+// 存在高评分的转换战术
+static bool transitionTacticReady(PlanContext& ctx) {
+    ctx.tactic = ctx.planner->context->getTacticFactory().selectBestTactic(TacticType::TRANSITION);
+    return ctx.tactic && ctx.planner->context->getTacticFactory().getBestScore(TacticType::TRANSITION) > 0.7;
+}
+
+// 根据球所在半场选择进攻或防守战术
+static bool phaseTacticReady(PlanContext& ctx) {
+    TacticType tactic_type;
+    if (ctx.planner->context->ball_tools->isInOurHalf()) {
+        // 球在我方半场，更倾向于防守
+        tactic_type = TacticType::DEFENSE;
+        debug_output("Ball in our half, switching to defense, robot " + std::to_string(ctx.robot_id));
+    } else {
+        // 球在对方半场，更倾向于进攻
+        tactic_type = TacticType::ATTACK;
+        debug_output("Ball in opponent half, switching to attack, robot " + std::to_string(ctx.robot_id));
+    }
+    
+    ctx.tactic = ctx.planner->context->getTacticFactory().selectBestTactic(tactic_type);
+    if (!ctx.tactic) {
+        debug_output("No suitable tactic found, using default behavior, robot " + std::to_string(ctx.robot_id));
+    }
+    return ctx.tactic != nullptr;
+}
+
+// 执行条件节点选出的战术
+static BTStatus executeTactic(PlanContext& ctx) {
+    debug_output("Executing tactic: " + ctx.tactic->getName() + ", robot " + std::to_string(ctx.robot_id));
+    ctx.plan.task = ctx.tactic->execute(ctx.robot_id);
+    return BTStatus::SUCCESS;
+}
+
+// 是否是最接近球的球员
+static bool isClosestToBall(PlanContext& ctx) {
+    return ctx.robot_id == ctx.planner->context->our_players->getClosestPlayerToBall();
+}
+
+// 是否已经持球
+static bool holdsBall(PlanContext& ctx) {
+    return ctx.planner->context->our_players->canHoldBall(ctx.robot_id);
+}
+
+// 是否接近对方球门
+static bool isNearGoal(PlanContext& ctx) {
+    point2f goal_pos(FIELD_LENGTH_H, 0);
+    return (ctx.player_pos - goal_pos).length() < 200;
+}
+
+// 射门
+static BTStatus shootAtGoal(PlanContext& ctx) {
+    ctx.plan.task = ctx.planner->context->our_players->createShootTask(ctx.robot_id);
+    debug_output("Robot " + std::to_string(ctx.robot_id) + " shooting at goal");
+    return BTStatus::SUCCESS;
+}
+
+// 寻找在对方半场的传球目标
+static bool findPassTarget(PlanContext& ctx) {
+    ctx.pass_target = -1;
+    for (int id : ctx.planner->context->our_players->getPlayerIds() - RobotSet::single(ctx.robot_id)) {
+        if (ctx.planner->context->our_players->isInOpponentHalf(id)) {
+            ctx.pass_target = id;
+            break;
+        }
+    }
+    return ctx.pass_target >= 0;
+}
+
+// 传球
+static BTStatus passToTarget(PlanContext& ctx) {
+    ctx.plan.task = ctx.planner->context->our_players->createPassTask(ctx.robot_id, ctx.pass_target);
+    debug_output("Robot " + std::to_string(ctx.robot_id) + " passing to robot " + std::to_string(ctx.pass_target));
+    return BTStatus::SUCCESS;
+}
+
+// 没有传球目标，带球前进
+static BTStatus dribbleForward(PlanContext& ctx) {
+    point2f target = ctx.player_pos;
+    target.x += 100;  // 向前方移动100厘米
+    
+    ctx.plan.task = ctx.planner->context->our_players->createDribbleTask(ctx.robot_id, target);
+    debug_output("Robot " + std::to_string(ctx.robot_id) + " dribbling forward");
+    return BTStatus::SUCCESS;
+}
+
+// 未持球，移动到球的位置
+static BTStatus moveToBall(PlanContext& ctx) {
+    ctx.plan.task = ctx.planner->context->our_players->createMoveTask(ctx.robot_id, ctx.ball_pos);
+    debug_output("Robot " + std::to_string(ctx.robot_id) + " moving to ball");
+    return BTStatus::SUCCESS;
+}
+
+// 不是最接近球的球员，寻找战术位置
+static BTStatus takeStrategicPosition(PlanContext& ctx) {
+    point2f strategic_pos;
+    
+    // 如果球在对方半场，找进攻位置：优先使用后台热图给出的接应点，按车号排序每人一个
+    if (!ctx.planner->context->ball_tools->isInOurHalf()) {
+        strategic_pos = point2f(ctx.ball_pos.x + 50, ctx.ball_pos.y * 0.7);
+        if (ctx.has_support) {
+            RobotSet supporters = ctx.planner->context->our_players->getPlayerIds() -
+                                  RobotSet::single(ctx.planner->context->our_players->getClosestPlayerToBall()) -
+                                  RobotSet::single(ctx.model->get_our_goalie());
+            int rank = 0;
+            for (int id : supporters) {
+                if (id < ctx.robot_id) rank++;
+            }
+            if (rank < ctx.support.value.spot_count) {
+                const SupportSpot& spot = ctx.support.value.spots[rank];
+                strategic_pos = point2f(spot.x, spot.y);
+            }
+        }
+        
+        debug_output("Robot " + std::to_string(ctx.robot_id) + " taking offensive position");
+    } else {
+        // 球在我方半场，找防守位置
+        strategic_pos = point2f(-FIELD_LENGTH_H/2 + 100, ctx.ball_pos.y * 0.5);
+        debug_output("Robot " + std::to_string(ctx.robot_id) + " taking defensive position");
+    }
+    
+    ctx.plan.task = ctx.planner->context->our_players->createMoveTask(ctx.robot_id, strategic_pos);
+    return BTStatus::SUCCESS;
+}
+
+// 构建决策行为树，新增行为只需在对应位置插入节点
+static BehaviorTree<PlanContext> buildDecisionTree() {
+    BehaviorTreeBuilder<PlanContext> builder;
+    builder.selector("root")
+        .sequence("stopped")
+            .condition("is_game_stopped", isGameStopped)
+            .action("hold_position", holdPosition)
+        .end()
+        .sequence("pass_reception")
+            .condition("has_pass_intention", hasPassIntention)
+            .action("move_to_reception", moveToReception)
+        .end()
+        .sequence("special_situation")
+            .condition("special_tactic_ready", specialTacticReady)
+            .action("execute_special", executeTactic)
+        .end()
+        .sequence("transition")
+            .condition("transition_tactic_ready", transitionTacticReady)
+            .action("execute_transition", executeTactic)
+        .end()
+        .sequence("phase_tactic")
+            .condition("phase_tactic_ready", phaseTacticReady)
+            .action("execute_phase", executeTactic)
+        .end()
+        .sequence("chase_ball")
+            .condition("is_closest_to_ball", isClosestToBall)
+            .selector("ball_play")
+                .sequence("on_ball")
+                    .condition("holds_ball", holdsBall)
+                    .selector("on_ball_choice")
+                        .sequence("shoot")
+                            .condition("is_near_goal", isNearGoal)
+                            .action("shoot_at_goal", shootAtGoal)
+                        .end()
+                        .sequence("pass")
+                            .condition("find_pass_target", findPassTarget)
+                            .action("pass_to_target", passToTarget)
+                        .end()
+                        .action("dribble_forward", dribbleForward)
+                    .end()
+                .end()
+                .action("move_to_ball", moveToBall)
+            .end()
+        .end()
+        .action("take_strategic_position", takeStrategicPosition)
+    .end();
+    return builder.build();
 }
 
-// 获取游戏状态的辅助函数
-int getPlayMode(const WorldModel* model) {
-    const GameState* game_state = model->game_states();
-    if (!game_state) return PM_NORMAL; // 默认为正常比赛状态
+// 帧级共享计算：每个周期只做一次，本帧所有机器人共用结果
+static void beginFrame(PlannerState& planner, const WorldModel* model) {
+    int cycle = model->get_cycle();
+    if (cycle == planner.frame_cycle) {
+        return;
+    }
+    planner.frame_cycle = cycle;
+    planner.frame_model = model;
+    planner.frame_graph.run(planner.job_pool.get());
+}
+
+// 帧级作业图：彼此独立的共享计算在有线程池时并行执行，新的帧级计算在这里声明依赖后加入；
+// 逐个机器人的规划仍在team_plan中串行执行，线程池只并行这些帧级作业
+static void buildFrameGraph(PlannerState& planner) {
+    PlannerState* p = &planner;
     
-    // 检查各种状态并返回对应的PlayMode
-    if (game_state->gameOff()) return PM_STOP;
+    // 新的一帧：把本帧的机器人集合和状态复制到帧快照，只有后台交接读取它，
+    // 其余作业直接读frame_model，互不依赖
+    JobGraph::JobId sets = planner.frame_graph.addJob("snapshot_sets", [p] {
+        fill_world_snapshot(p->frame_model, p->frame_snapshot);
+    });
     
-    if (game_state->ourKickoff()) return PM_OurKickOff;
-    if (game_state->theirKickoff()) return PM_OppKickOff;
+    // 检测世界状态变化，使受影响的战术评估失效
+    planner.frame_graph.addJob("world_events", [p] {
+        if (p->change_detector.update(p->frame_model)) {
+            p->context->getTacticFactory().invalidate(p->change_detector.events());
+        }
+    });
     
-    if (game_state->ourDirectKick() || game_state->ourIndirectKick()) return PM_OurFreeKick;
-    if (game_state->theirDirectKick() || game_state->theirIndirectKick()) return PM_OppFreeKick;
+    // 停止阶段分帧预计算定位球方案（每帧只推进一次）
+    planner.frame_graph.addJob("set_piece", [p] {
+        p->context->getSetPiecePlanner().update(p->frame_model);
+    });
     
-    if (game_state->ourPenaltyKick()) return PM_OurPenaltyKick;
-    if (game_state->theirPenaltyKick()) return PM_OppPenaltyKick;
+    // 增量更新传球网络，持球者搜索传球链时直接使用
+    planner.frame_graph.addJob("pass_network", [p] {
+        p->context->pass_network->update();
+    });
     
-    // 更多状态的映射可以在这里添加
+    // 根据上一帧发布的任务批量判断全队到点情况（每帧只计算一次）
+    planner.frame_graph.addJob("arrivals", [p] {
+        p->context->getTaskBoard().update_arrivals(p->frame_model);
+    });
     
-    return PM_NORMAL; // 默认为正常比赛状态
+    // 把本帧快照交给后台规划器，不等待它的计算
+    planner.frame_graph.addJob("background_handoff", [p] {
+        if (p->background) {
+            p->background->submit(p->frame_snapshot);
+        }
+    }, {sets});
 }
 
-// 导出函数（主函数）供调用
-extern "C" __declspec(dllexport) PlayerTask player_plan(const WorldModel* model, int robot_id) {
-    PlayerTask task;
+// 为一个机器人规划本帧任务（未做规则投影）
+static PlayerTask planRobot(PlannerState& planner, const WorldModel* model, int robot_id) {
+    PlanContext ctx;
+    ctx.planner = &planner;
+    ctx.model = model;
+    ctx.robot_id = robot_id;
+    ctx.tactic = nullptr;
+    ctx.has_support = false;
     
     // 获取当前周期并更新周期计数
-    cycle_counter++;
+    planner.context->nextCycle();
     
     // 记录周期开始
-    debug_output("===== CYCLE " + std::to_string(cycle_counter) + " START =====");
+    debug_output("===== CYCLE " + std::to_string(planner.context->getCycleCounter()) + " START =====");
     
-    // 初始化工具类（如果尚未初始化）
-    if (!initialized) {
-        initialize(model, robot_id);
+    // 初始化工具类和决策行为树（如果尚未初始化）
+    if (!planner.ready) {
+        initialize(planner, model, robot_id);
+        planner.decision_tree = buildDecisionTree();
+        if (planner.frame_graph.size() == 0) {
+            buildFrameGraph(planner);
+        }
     }
     
     try {
-        // 获取当前比赛状态
-        int play_mode = getPlayMode(model);
-        
-        // 特殊情况处理：如果处于停止状态，停在原地
-        if (play_mode == PM_STOP) {
-            task.target_pos = our_players->getPosition(robot_id);
-            task.orientate = our_players->getOrientation(robot_id);
-            debug_output("Game stopped, robot " + std::to_string(robot_id) + " holding position");
-            return task;
-        }
-        
-        // 正常比赛逻辑
-        point2f ball_pos = ball_tools->getPosition();
-        point2f player_pos = our_players->getPosition(robot_id);
-        
-        // 交换球员状态信息
-        bool has_ball = our_players->canHoldBall(robot_id);
-        Communication::getInstance().broadcastBallPossession(has_ball, ball_pos);
-        
-        // 检查是否收到了传球意图
-        Message pass_msg = Communication::getInstance().receiveMessage(MessageType::PASS_INTENTION);
-        if (pass_msg.receiver_id == robot_id) {
-            // 收到传球意图，移动到传球接应位置
-            debug_output("Received pass intention, moving to reception position, robot " + std::to_string(robot_id));
-            task = our_players->createMoveTask(robot_id, pass_msg.position);
-            debug_output("===== CYCLE " + std::to_string(cycle_counter) + " END =====");
-            return task;
-        }
-        
-        // 检查特殊情况
-        TacticType special_tactic_type = TacticType::SPECIAL_SITUATION;
-        std::shared_ptr<Tactic> special_tactic = tactic_factory->selectBestTactic(special_tactic_type);
-        
-        if (special_tactic && special_tactic->evaluate().score > 0.5) {
-            // 存在高评分的特殊情况战术，执行它
-            debug_output("Executing special tactic: " + special_tactic->getName() + ", robot " + std::to_string(robot_id));
-            task = special_tactic->execute(robot_id);
-            debug_output("===== CYCLE " + std::to_string(cycle_counter) + " END =====");
-            return task;
-        }
+        beginFrame(planner, model);
         
-        // 检查转换战术
-        TacticType transition_tactic_type = TacticType::TRANSITION;
-        std::shared_ptr<Tactic> transition_tactic = tactic_factory->selectBestTactic(transition_tactic_type);
+        // 准备行为树上下文
+        ctx.play_mode = model->get_play_mode();
+        ctx.ball_pos = planner.context->ball_tools->getPosition();
+        ctx.player_pos = planner.context->our_players->getPosition(robot_id);
+        ctx.has_support = planner.background &&
+                          planner.background->latest(model->get_cycle(), SUPPORT_MAX_AGE, ctx.support);
         
-        if (transition_tactic && transition_tactic->evaluate().score > 0.7) {
-            // 存在高评分的转换战术，执行它
-            debug_output("Executing transition tactic: " + transition_tactic->getName() + ", robot " + std::to_string(robot_id));
-            task = transition_tactic->execute(robot_id);
-            debug_output("===== CYCLE " + std::to_string(cycle_counter) + " END =====");
-            return task;
+        // 有正在执行的多步任务且没有发生需要重新规划的变化时，只推进计划
+        TaskHorizonExecutor& horizon = planner.horizon_executors[robot_id];
+        if (horizon.isActive() && ((planner.change_detector.events() & HORIZON_ABORT_EVENTS) ||
+                                   planner.change_detector.getPossession() == Possession::THEIRS)) {
+            horizon.cancel();
         }
         
-        // 决定是进攻还是防守
-        TacticType tactic_type;
-        
-        // 简单的进攻/防守判断逻辑
-        if (ball_tools->isInOurHalf()) {
-            // 球在我方半场，更倾向于防守
-            tactic_type = TacticType::DEFENSE;
-            debug_output("Ball in our half, switching to defense, robot " + std::to_string(robot_id));
-        } else {
-            // 球在对方半场，更倾向于进攻
-            tactic_type = TacticType::ATTACK;
-            debug_output("Ball in opponent half, switching to attack, robot " + std::to_string(robot_id));
+        if (!horizon.advance(model, robot_id, ctx.plan.task)) {
+            // 执行决策行为树
+            planner.decision_tree.tick(ctx);
+            
+            // 新的多步计划交给执行器，本帧输出第一步
+            if (ctx.plan.horizon_size > 0) {
+                horizon.start(ctx.plan, model->get_cycle());
+                horizon.advance(model, robot_id, ctx.plan.task);
+            }
         }
         
-        // 选择最佳战术
-        std::shared_ptr<Tactic> best_tactic = tactic_factory->selectBestTactic(tactic_type);
-        
-        if (best_tactic) {
-            // 执行选择的战术
-            debug_output("Executing tactic: " + best_tactic->getName() + ", robot " + std::to_string(robot_id));
-            task = best_tactic->execute(robot_id);
-        } else {
-            // 如果没有找到合适的战术，执行默认行为
-            debug_output("No suitable tactic found, using default behavior, robot " + std::to_string(robot_id));
-            
-            // 如果是最接近球的球员，去抢球
-            if (robot_id == our_players->getClosestPlayerToBall()) {
-                if (our_players->canHoldBall(robot_id)) {
-                    // 已经持球，尝试射门或传球
-                    point2f goal_pos(FIELD_LENGTH_H, 0);
-                    double dist_to_goal = (player_pos - goal_pos).length();
-                    
-                    if (dist_to_goal < 200) {
-                        // 接近球门，尝试射门
-                        task = our_players->createShootTask(robot_id);
-                        debug_output("Robot " + std::to_string(robot_id) + " shooting at goal");
-                    } else {
-                        // 寻找可能的传球目标
-                        std::vector<int> teammates = our_players->getPlayerIds();
-                        int pass_target = -1;
-                        
-                        for (int id : teammates) {
-                            if (id != robot_id && our_players->isInOpponentHalf(id)) {
-                                pass_target = id;
-                                break;
-                            }
-                        }
-                        
-                        if (pass_target >= 0) {
-                            // 有传球目标，执行传球
-                            task = our_players->createPassTask(robot_id, pass_target);
-                            debug_output("Robot " + std::to_string(robot_id) + " passing to robot " + std::to_string(pass_target));
-                        } else {
-                            // 没有传球目标，带球前进
-                            point2f target = player_pos;
-                            target.x += 100;  // 向前方移动100厘米
-                            
-                            // 确保目标在场地范围内
-                            if (target.x > FIELD_LENGTH_H - 30.0) {
-                                target.x = FIELD_LENGTH_H - 30.0;
-                            }
-                            
-                            task = our_players->createDribbleTask(robot_id, target);
-                            debug_output("Robot " + std::to_string(robot_id) + " dribbling forward");
-                        }
-                    }
-                } else {
-                    // 未持球，移动到球的位置
-                    task = our_players->createMoveTask(robot_id, ball_pos);
-                    debug_output("Robot " + std::to_string(robot_id) + " moving to ball");
-                }
-            } else {
-                // 不是最接近球的球员，寻找战术位置
-                point2f strategic_pos;
-                
-                // 如果球在对方半场，找进攻位置
-                if (!ball_tools->isInOurHalf()) {
-                    strategic_pos = point2f(ball_pos.x + 50, ball_pos.y * 0.7);
-                    
-                    // 确保位置在场地范围内
-                    if (strategic_pos.x > FIELD_LENGTH_H - 30.0) {
-                        strategic_pos.x = FIELD_LENGTH_H - 30.0;
-                    }
-                    
-                    debug_output("Robot " + std::to_string(robot_id) + " taking offensive position");
-                } else {
-                    // 球在我方半场，找防守位置
-                    strategic_pos = point2f(-FIELD_LENGTH_H/2 + 100, ball_pos.y * 0.5);
-                    debug_output("Robot " + std::to_string(robot_id) + " taking defensive position");
-                }
-                
-                // 确保位置在场地范围内
-                if (strategic_pos.y < -FIELD_WIDTH_H + 30.0) {
-                    strategic_pos.y = -FIELD_WIDTH_H + 30.0;
-                } else if (strategic_pos.y > FIELD_WIDTH_H - 30.0) {
-                    strategic_pos.y = FIELD_WIDTH_H - 30.0;
-                }
-                
-                task = our_players->createMoveTask(robot_id, strategic_pos);
+        // 定期输出各节点的耗时统计
+        if (planner.context->getCycleCounter() % 600 == 0) {
+            planner.context->getLogger().debug("Decision tree timing:\n" + planner.decision_tree.report(), robot_id);
+            planner.context->getLogger().debug("Frame job timing:\n" + planner.frame_graph.report(), robot_id);
+            if (planner.background) {
+                planner.context->getLogger().debug("Background support maps published: " +
+                                                   std::to_string(planner.background->publishedCount()), robot_id);
             }
         }
     } catch (const std::exception& e) {
@@ -304,16 +498,140 @@ extern "C" __declspec(dllexport) PlayerTask player_plan(const WorldModel* model,
         debug_output("Exception in player_plan: " + std::string(e.what()) + ", robot " + std::to_string(robot_id));
         
         // 异常情况下的默认行为：保持在当前位置
-        task.target_pos = our_players->getPosition(robot_id);
-        task.orientate = our_players->getOrientation(robot_id);
+        ctx.plan.task.target_pos = planner.context->our_players->getPosition(robot_id);
+        ctx.plan.task.orientate = planner.context->our_players->getOrientation(robot_id);
+    }
+    return ctx.plan.task;
+}
+
+// 本帧定位球的主罚者，规则投影据此让它不受中圈和点球站位线限制：
+// 开球有就绪方案时取方案的主罚球员，否则与开球战术、追球行为一样取最接近球的球员
+static int restartKicker(PlannerState& planner, const WorldModel* model) {
+    PlayMode mode = model->get_play_mode();
+    if (mode != PlayMode::OurKickOff && mode != PlayMode::OurPenaltyKick) {
+        return -1;
+    }
+    if (mode == PlayMode::OurKickOff) {
+        const SetPiecePlan* plan = planner.context->getSetPiecePlanner().getReadyPlan(SetPieceKind::KICKOFF);
+        if (plan) {
+            return plan->kicker_id;
+        }
     }
+    return planner.context->our_players->getClosestPlayerToBall();
+}
+
+// 发布已投影的任务：队友可以无锁读取当前目标，输出阶段汇总全队任务，最后一个机器人完成后整队一次发出
+static void publishTask(PlannerState& planner, const WorldModel* model, int robot_id, const PlayerTask& task) {
+    planner.context->getTaskBoard().set_task(robot_id, task, model->get_cycle());
+    planner.context->getRadioOutput().submit(model, robot_id, task);
     
     // 记录周期结束
-    debug_output("===== CYCLE " + std::to_string(cycle_counter) + " END =====");
+    debug_output("===== CYCLE " + std::to_string(planner.context->getCycleCounter()) + " END =====");
+}
+
+// 导出函数（主函数）供调用
+extern "C" __declspec(dllexport) PlayerTask player_plan(const WorldModel* model, int robot_id) {
+    // 车号用作每车状态（多步任务执行器、任务公告板等）的下标，也用来读宿主的球员数据，超出宿主车号范围的不规划
+    if (robot_id < 0 || robot_id >= HOST_EXIST_LEN) {
+        debug_output("player_plan: invalid robot id " + std::to_string(robot_id));
+        return PlayerTask();
+    }
+    
+    PlannerState& planner = defaultPlanner();
+    PlayerTask task = planRobot(planner, model, robot_id);
+    
+    // 场地边界、禁区和避让圆等规则约束统一在输出前投影，各行为不再单独检查
+    planner.context->getRuleProjection().projectTask(model, robot_id, task, restartKicker(planner, model));
     
+    publishTask(planner, model, robot_id, task);
     return task;
 }
 
+// 释放player_plan所用默认规划器的工具类和通信，之后再调用player_plan会重新初始化。
+// 默认规划器不启动线程，FreeLibrary之前不必调用；team_plan的句柄带后台线程，须由planner_destroy释放
+extern "C" __declspec(dllexport) void planner_shutdown() {
+    PlannerState& planner = defaultPlanner();
+    if (planner.ready) {
+        cleanup(planner);
+    }
+}
+
+// ===== 批量C接口 =====
+// 宿主每帧调用一次team_plan，帧级计算和规则投影对全队只做一次；
+// 每个句柄拥有独立的PlannerContext，同一进程内的多个句柄互不共享日志、通信和队伍状态
+
+struct PlannerHandleImpl {
+    PlannerContext context;
+    PlannerState state;
+
+    explicit PlannerHandleImpl(const std::string& name) : context(name) {
+        state.context = &context;
+    }
+};
+
+static std::atomic<int> planner_handle_count(0);
+
+extern "C" __declspec(dllexport) PlannerHandle planner_create(const WorldModel* model) {
+    if (!model) {
+        return nullptr;
+    }
+    PlannerHandleImpl* handle = new PlannerHandleImpl("planner_" + std::to_string(planner_handle_count++));
+    handle->state.model = model;
+    handle->state.use_background = true;
+    return handle;
+}
+
+extern "C" __declspec(dllexport) void planner_destroy(PlannerHandle handle) {
+    if (!handle) {
+        return;
+    }
+    if (handle->state.ready) {
+        cleanup(handle->state);
+    }
+    delete handle;
+}
+
+extern "C" __declspec(dllexport) int planner_set_workers(PlannerHandle handle, int workers) {
+    if (!handle || workers < 0) {
+        return -1;
+    }
+    // 0个工作线程时帧级作业按声明顺序串行执行，结果可复现
+    handle->state.job_pool.reset(workers > 0 ? new JobPool(workers) : nullptr);
+    return workers;
+}
+
+extern "C" __declspec(dllexport) int team_plan(PlannerHandle handle, PlayerTask* tasks, int capacity) {
+    if (!handle || !tasks) {
+        return -1;
+    }
+    PlannerState& planner = handle->state;
+    // 规划读取planner_create绑定的世界模型
+    const WorldModel* model = planner.model;
+    
+    // 除守门员外的场上机器人，守门员由goalie_plan规划
+    RobotSet robots = model->get_our_field_set();
+    int ids[MAX_TEAM_ROBOTS];
+    PlayerTask batch[MAX_TEAM_ROBOTS];
+    int n = 0;
+    for (int id : robots) {
+        if (id >= capacity) {
+            break;
+        }
+        ids[n] = id;
+        batch[n] = planRobot(planner, model, id);
+        n++;
+    }
+    
+    // 全队目标点一次批量投影
+    planner.context->getRuleProjection().projectTasks(model, ids, batch, n, restartKicker(planner, model));
+    
+    for (int i = 0; i < n; i++) {
+        tasks[ids[i]] = batch[i];
+        publishTask(planner, model, ids[i], batch[i]);
+    }
+    return n;
+}
+
 
 
 
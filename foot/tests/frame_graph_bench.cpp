@@ -0,0 +1,198 @@
+// 帧级作业图串行执行与线程池执行的耗时对比
+// 构建（在foot目录下）：
+//   g++ -std=c++17 -O2 -c -include iostream "-DEPSILON=(1.0E-10)" utils/maths.cpp -o maths.o
+//   g++ -std=c++17 -O2 -pthread [-DROBOT_TEAM_SIZE=11] tests/frame_graph_bench.cpp maths.o -o frame_graph_bench
+// 按robot2的buildFrameGraph搭同样的作业和依赖：快照、世界事件、定位球预计算、传球网络、
+// 到点判断和后台交接。战术工厂依赖宿主的工具类，world_events只做变化检测不做失效。
+// 同一组世界帧依次用串行和1~3个工作线程的线程池执行，比较每帧run()的耗时
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+// utils/vector.h先包含util.h再定义EPSILON，单独编译时需要提前定义（与vector.h中的定义相同）
+#define EPSILON (1.0E-10)
+// 测试用的宿主按完整车号范围0~15开存在标识和球员数组
+#define ROBOT_HOST_EXIST_LEN 16
+#include "../utils/task_board.h"
+#include "../utils/world_snapshot.h"
+#include "../my_utils/world_events.h"
+#include "../my_utils/set_piece_planner.h"
+#include "../my_utils/pass_network.h"
+#include "../my_utils/support_map.h"
+#include "../my_utils/background_planner.h"
+#include "../my_utils/job_graph.h"
+
+// ---------------- 测试用的宿主世界模型 ----------------
+
+static point2f our_pos[MAX_TEAM_ROBOTS], our_vel[MAX_TEAM_ROBOTS];
+static float our_dir[MAX_TEAM_ROBOTS];
+static point2f opp_pos[MAX_TEAM_ROBOTS];
+static PlayerVision opp_vision[MAX_TEAM_ROBOTS];
+
+FilteredObject::FilteredObject() {}
+FilteredObject::~FilteredObject() {}
+Ball::Ball() : lost_frame(0), proc_frame(0), cur_cycle(0) {}
+Ball::~Ball() {}
+void Ball::set_ball_vision(const point2f pos, bool is_lost) {
+    log.getLogger(cur_cycle).pos = pos;
+    lost_frame = is_lost ? 1 : 0;
+}
+
+WorldModel::WorldModel() : our(NULL), opp(NULL), kick(NULL), sim_kick(NULL), match_ball(NULL),
+    our_goalie(0), opp_goalie(0), current_cycle(0), game_state(NULL), is_simulation(true) {}
+WorldModel::~WorldModel() {}
+void WorldModel::set_game_state(GameState* state) { game_state = state; }
+const GameState* WorldModel::game_states() const { return game_state; }
+const point2f& WorldModel::get_our_player_pos(int id) const { return our_pos[id]; }
+const point2f& WorldModel::get_our_player_v(int id) const { return our_vel[id]; }
+float WorldModel::get_our_player_dir(int id) const { return our_dir[id]; }
+const point2f& WorldModel::get_opp_player_pos(int id) const { return opp_pos[id]; }
+const PlayerVision& WorldModel::get_opp_player(int id) const { return opp_vision[id]; }
+float WorldModel::get_opp_player_dir(int) const { return 0.0f; }
+
+// ---------------- 基准 ----------------
+
+static const int FRAMES = 20000;
+// 每PHASE_FRAMES帧中前一部分为比赛进行，后一部分为停止（定位球预计算）
+static const int PHASE_FRAMES = 1000;
+static const int STOP_FRAMES = 300;
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+static float randomCoord(double half) {
+    return static_cast<float>((std::rand() / (double)RAND_MAX * 2 - 1) * half);
+}
+
+static float clampTo(float v, double half) {
+    return std::min(std::max(v, -float(half)), float(half));
+}
+
+static void moveRobots(RobotSet set, point2f* pos, point2f* vel, float step) {
+    for (int id : set) {
+        point2f d(randomCoord(step), randomCoord(step));
+        pos[id] = point2f(clampTo(pos[id].x + d.x, FIELD_LENGTH_H), clampTo(pos[id].y + d.y, FIELD_WIDTH_H));
+        if (vel) vel[id] = d * 60.0f;
+    }
+}
+
+static void report(const char* name, std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v) sum += x;
+    std::printf("%-22s: mean %8.0f ns  p99 %8.0f ns  max %8.0f ns\n", name,
+                sum / v.size(), v[v.size() * 99 / 100], v.back());
+}
+
+// 一个规划器实例的帧级状态，对应robot2的PlannerState中帧级作业用到的部分
+struct FrameState {
+    const WorldModel* model;
+    WorldChangeDetector change_detector;
+    SetPiecePlanner set_piece_planner;
+    PassNetwork pass_network;
+    TeamTaskBoard board;
+    WorldSnapshot snapshot;
+    BackgroundPlanner<SupportMap> background;
+    JobGraph graph;
+    long long checksum;
+
+    explicit FrameState(const WorldModel* m) :
+        model(m), pass_network(m),
+        background(std::unique_ptr<BackgroundTask<SupportMap>>(new SupportMapTask())),
+        checksum(0) {
+        FrameState* p = this;
+        // 与robot2的buildFrameGraph相同的作业和依赖：只有后台交接依赖快照
+        JobGraph::JobId sets = p->graph.addJob("snapshot_sets", [p] {
+            fill_world_snapshot(p->model, p->snapshot);
+        });
+        p->graph.addJob("world_events", [p] {
+            p->change_detector.update(p->model);
+            p->checksum += p->change_detector.events() & 0xff;
+        });
+        p->graph.addJob("set_piece", [p] {
+            p->set_piece_planner.update(p->model);
+        });
+        p->graph.addJob("pass_network", [p] {
+            p->pass_network.update();
+        });
+        p->graph.addJob("arrivals", [p] {
+            p->board.update_arrivals(p->model);
+        });
+        p->graph.addJob("background_handoff", [p] {
+            p->background.submit(p->snapshot);
+        }, {sets});
+        background.start();
+    }
+};
+
+// 用同一个随机种子重放同一组世界帧，pool为空时串行执行
+static std::vector<double> runFrames(JobPool* pool) {
+    std::srand(1);
+    bool our_flags[MAX_TEAM_ROBOTS] = {false};
+    bool opp_flags[MAX_TEAM_ROBOTS] = {false};
+    for (int k = 0; k < TEAM_SIZE; k++) {
+        int id = (k * 2) % MAX_TEAM_ROBOTS + (k * 2 >= MAX_TEAM_ROBOTS ? 1 : 0);
+        our_flags[id] = opp_flags[id] = true;
+        our_pos[id] = point2f(randomCoord(FIELD_LENGTH_H), randomCoord(FIELD_WIDTH_H));
+        opp_pos[id] = point2f(randomCoord(FIELD_LENGTH_H), randomCoord(FIELD_WIDTH_H));
+    }
+
+    Ball ball;
+    GameState game_state;
+    game_state.init(TEAM_BLUE);
+    WorldModel model;
+    model.set_our_exist_id(our_flags);
+    model.set_opp_exist_id(opp_flags);
+    model.set_our_goalie(0);
+    model.set_opp_goalie(0);
+    model.set_ball(&ball);
+    model.set_game_state(&game_state);
+    FrameState state(&model);
+
+    std::vector<double> ns;
+    ns.reserve(FRAMES);
+    point2f ball_pos(-100, 50);
+    for (int f = 0; f < FRAMES; f++) {
+        bool stopped = f % PHASE_FRAMES >= PHASE_FRAMES - STOP_FRAMES;
+        if (f % PHASE_FRAMES == 0) {
+            game_state.transition(COMM_START, false, f / 60.0);
+        } else if (f % PHASE_FRAMES == PHASE_FRAMES - STOP_FRAMES) {
+            game_state.transition(COMM_STOP, false, f / 60.0);
+        }
+        if (!stopped) {
+            ball_pos = point2f(clampTo(ball_pos.x + randomCoord(5), FIELD_LENGTH_H - 20),
+                               clampTo(ball_pos.y + randomCoord(5), FIELD_WIDTH_H - 20));
+        }
+        moveRobots(model.get_our_set(), our_pos, our_vel, stopped ? 1.0f : 5.0f);
+        moveRobots(model.get_opp_set(), opp_pos, NULL, stopped ? 1.0f : 5.0f);
+        ball.set_cycle(f);
+        ball.set_ball_vision(ball_pos, false);
+        model.set_cycle(f);
+
+        Clock::time_point t = Clock::now();
+        state.graph.run(pool);
+        ns.push_back(elapsedNs(t));
+    }
+    if (!pool) {
+        // 串行时各作业的耗时之和就是整帧耗时，线程池最多省到其中最长的一条依赖链
+        std::printf("%s", state.graph.report().c_str());
+    }
+    return ns;
+}
+
+int main() {
+    std::printf("robots per team       : %d, hardware threads %u\n", TEAM_SIZE, std::thread::hardware_concurrency());
+    report("inline", runFrames(nullptr));
+    for (int workers = 1; workers <= 3; workers++) {
+        JobPool pool(workers);
+        char name[32];
+        std::snprintf(name, sizeof(name), "pool, %d worker(s)", workers);
+        report(name, runFrames(&pool));
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+// 传球网络每帧开销的基准：帧级作业中的增量更新和持球者的传球链搜索
+// 构建（在foot目录下）：
+//   g++ -std=c++17 -O2 -c -include iostream "-DEPSILON=(1.0E-10)" utils/maths.cpp -o maths.o
+//   g++ -std=c++17 -O2 [-DROBOT_TEAM_SIZE=11] tests/pass_network_bench.cpp maths.o -o pass_network_bench
+// 三种帧：静止（只有微小抖动）、一半球员移动、全部重建（场上集合变化）
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+// utils/vector.h先包含util.h再定义EPSILON，单独编译时需要提前定义（与vector.h中的定义相同）
+#define EPSILON (1.0E-10)
+// 测试用的宿主按完整车号范围0~15开存在标识和球员数组
+#define ROBOT_HOST_EXIST_LEN 16
+#include "../my_utils/pass_network.h"
+
+// ---------------- 测试用的宿主世界模型 ----------------
+
+static point2f our_pos[MAX_TEAM_ROBOTS];
+static point2f opp_pos[MAX_TEAM_ROBOTS];
+
+WorldModel::WorldModel() : our(NULL), opp(NULL), kick(NULL), sim_kick(NULL), match_ball(NULL),
+    our_goalie(0), opp_goalie(0), current_cycle(0), game_state(NULL), is_simulation(true) {}
+WorldModel::~WorldModel() {}
+const point2f& WorldModel::get_our_player_pos(int id) const { return our_pos[id]; }
+const point2f& WorldModel::get_opp_player_pos(int id) const { return opp_pos[id]; }
+
+// ---------------- 基准 ----------------
+
+static const int FRAMES = 20000;
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+static float randomCoord(double half) {
+    return static_cast<float>((std::rand() / (double)RAND_MAX * 2 - 1) * half);
+}
+
+static void jitter(point2f* pos, RobotSet set, float amount) {
+    for (int id : set) {
+        pos[id].x += randomCoord(amount);
+        pos[id].y += randomCoord(amount);
+    }
+}
+
+struct Stage {
+    const char* name;
+    std::vector<double> us;
+};
+
+static void report(const Stage& stage) {
+    std::vector<double> v = stage.us;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v) sum += x;
+    std::printf("%-24s: mean %7.2f us  p99 %7.2f us  max %7.2f us\n", stage.name,
+                sum / v.size(), v[v.size() * 99 / 100], v.back());
+}
+
+int main() {
+    std::srand(1);
+    bool our_flags[MAX_TEAM_ROBOTS] = {false};
+    bool opp_flags[MAX_TEAM_ROBOTS] = {false};
+    // 双方各TEAM_SIZE人，车号从0开始隔一个取，检查节点数按场上人数而不是车号空间
+    for (int k = 0; k < TEAM_SIZE; k++) {
+        int id = (k * 2) % MAX_TEAM_ROBOTS + (k * 2 >= MAX_TEAM_ROBOTS ? 1 : 0);
+        our_flags[id] = opp_flags[id] = true;
+        our_pos[id] = point2f(randomCoord(FIELD_LENGTH_H), randomCoord(FIELD_WIDTH_H));
+        opp_pos[id] = point2f(randomCoord(FIELD_LENGTH_H), randomCoord(FIELD_WIDTH_H));
+    }
+
+    WorldModel model;
+    model.set_our_exist_id(our_flags);
+    model.set_opp_exist_id(opp_flags);
+    model.set_our_goalie(0);
+    RobotSet field = model.get_our_field_set();
+    int holder = *field.begin();
+    int substitute = holder;
+    for (int id : field) substitute = id;
+
+    PassNetwork network(&model);
+    Stage quiet = {"update (quiet frame)", {}};
+    Stage moving = {"update (half moving)", {}};
+    Stage rebuild = {"update (set changed)", {}};
+    Stage search = {"search (holder)", {}};
+    int chains = 0;
+    long long edges = 0;
+
+    for (int f = 0; f < FRAMES; f++) {
+        int kind = f % 10;
+        if (kind == 0) {
+            // 我方一名球员下场或上场，场上集合变化，节点全部重建
+            our_flags[substitute] = !our_flags[substitute];
+        } else if (kind < 5) {
+            jitter(our_pos, model.get_our_set(), 2.0f);
+            jitter(opp_pos, model.get_opp_set(), 2.0f);
+        } else {
+            jitter(our_pos, model.get_our_set(), 20.0f);
+            jitter(opp_pos, model.get_opp_set(), 20.0f);
+        }
+        model.set_cycle(f);
+
+        Clock::time_point t = Clock::now();
+        network.update();
+        double us = elapsedUs(t);
+        (kind == 0 ? rebuild : kind < 5 ? quiet : moving).us.push_back(us);
+        edges += network.edgesUpdated();
+
+        if (model.get_our_set().contains(holder)) {
+            PassChain chain;
+            t = Clock::now();
+            chains += network.search(holder, our_pos[holder], 2, chain) ? 1 : 0;
+            search.us.push_back(elapsedUs(t));
+        }
+    }
+
+    std::printf("robots per team         : %d, nodes %d, sizeof(PassNetwork) %zu bytes\n",
+                TEAM_SIZE, PassNetwork::MAX_NODES, sizeof(PassNetwork));
+    report(quiet);
+    report(moving);
+    report(rebuild);
+    report(search);
+    std::printf("edges updated per frame : %.1f\n", (double)edges / FRAMES);
+    std::printf("chains found            : %d\n", chains);
+    return 0;
+}
@@ -0,0 +1,130 @@
+// 无线指令输出阶段的帧收集测试
+// 构建：g++ -std=c++17 -O2 tests/radio_output_test.cpp -o radio_output_test（在foot目录下）
+// WorldModel的非内联成员由宿主程序实现，这里给出测试用的最小实现
+#include <cstdio>
+#include <iostream>
+#include <vector>
+// utils/vector.h先包含util.h再定义EPSILON，单独编译时需要提前定义（与vector.h中的定义相同）
+#define EPSILON (1.0E-10)
+// 测试用的宿主按完整车号范围0~15开存在标识和球员数组
+#define ROBOT_HOST_EXIST_LEN 16
+#include "../my_utils/radio_output.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+// ---------------- 测试用的宿主世界模型 ----------------
+
+static point2f positions[MAX_TEAM_ROBOTS];
+
+WorldModel::WorldModel() : our(NULL), opp(NULL), kick(NULL), sim_kick(NULL), match_ball(NULL),
+    our_goalie(0), opp_goalie(0), current_cycle(0), game_state(NULL), is_simulation(true) {}
+WorldModel::~WorldModel() {}
+const point2f& WorldModel::get_our_player_pos(int id) const { return positions[id]; }
+float WorldModel::get_our_player_dir(int) const { return 0.0f; }
+
+// ---------------- 测试 ----------------
+
+// 记录发出的数据包
+class RecordingTransport : public RadioTransport {
+public:
+    bool send(const unsigned char* data, int size) override {
+        packets.push_back(std::vector<unsigned char>(data, data + size));
+        return true;
+    }
+    std::vector<std::vector<unsigned char> > packets;
+};
+
+static PlayerTask taskTo(float x, float y) {
+    PlayerTask t;
+    t.target_pos = point2f(x, y);
+    return t;
+}
+
+int main() {
+    bool our_flags[MAX_TEAM_ROBOTS] = {false};
+    bool opp_flags[MAX_TEAM_ROBOTS] = {false};
+    // 守门员0号加三名场上球员，车号不连续
+    const int field[] = {2, 5, 11};
+    our_flags[0] = true;
+    for (int id : field) our_flags[id] = true;
+
+    WorldModel model;
+    model.set_our_exist_id(our_flags);
+    model.set_opp_exist_id(opp_flags);
+    model.set_our_goalie(0);
+
+    RecordingTransport transport;
+    RadioOutput output;
+    output.setTransport(&transport);
+    TaskPacketDecoder decoder;
+    PlayerTask decoded[MAX_ROBOTS];
+    bool updated[MAX_ROBOTS];
+
+    // 1. 守门员不提交：最后一名场上球员提交时整帧立即发出，complete为true
+    model.set_cycle(1);
+    CHECK(!output.submit(&model, field[0], taskTo(100, 0)));
+    CHECK(!output.submit(&model, field[1], taskTo(0, 100)));
+    CHECK(transport.packets.empty());
+    CHECK(output.submit(&model, field[2], taskTo(-100, 0)));
+    CHECK(transport.packets.size() == 1);
+    RadioFrameStats s = output.lastFrame();
+    CHECK(s.cycle == 1);
+    CHECK(s.complete);
+    CHECK(s.sent);
+    CHECK(s.robots == 3);
+    CHECK(output.framesSent() == 1);
+    if (transport.packets.size() != 1) {
+        std::printf("radio_output_test: frame never flushed, stopping\n");
+        return 1;
+    }
+    CHECK(decoder.decode(transport.packets[0].data(), (int)transport.packets[0].size(), decoded, updated));
+    for (int id : field) CHECK(updated[id]);
+    CHECK(!updated[0]);
+    CHECK(decoded[field[1]].target_pos.y == 100);
+
+    // 2. 守门员也提交时同样在场上球员到齐后发出，数据包里包含守门员
+    model.set_cycle(2);
+    CHECK(!output.submit(&model, 0, taskTo(-290, 0)));
+    CHECK(!output.submit(&model, field[0], taskTo(110, 0)));
+    CHECK(!output.submit(&model, field[1], taskTo(0, 110)));
+    CHECK(output.submit(&model, field[2], taskTo(-110, 0)));
+    s = output.lastFrame();
+    CHECK(s.complete && s.robots == 4);
+    CHECK(decoder.decode(transport.packets.back().data(), (int)transport.packets.back().size(), decoded, updated));
+    CHECK(updated[0]);
+    CHECK(decoded[0].target_pos.x == -290);
+
+    // 3. 有球员没有提交：下一帧的第一个任务到来时补发上一帧，complete为false
+    model.set_cycle(3);
+    CHECK(!output.submit(&model, field[0], taskTo(120, 0)));
+    CHECK(!output.submit(&model, field[1], taskTo(0, 120)));
+    CHECK(transport.packets.size() == 2);
+    model.set_cycle(4);
+    CHECK(!output.submit(&model, field[0], taskTo(130, 0)));
+    CHECK(transport.packets.size() == 3);
+    s = output.lastFrame();
+    CHECK(s.cycle == 3);
+    CHECK(!s.complete);
+    CHECK(s.robots == 2);
+
+    // 4. 本帧发出后迟到的任务计入lateTasks
+    CHECK(!output.submit(&model, field[1], taskTo(0, 130)));
+    CHECK(output.submit(&model, field[2], taskTo(-130, 0)));
+    CHECK(output.lastFrame().complete);
+    CHECK(!output.submit(&model, field[2], taskTo(-131, 0)));
+    CHECK(output.lateTasks() == 1);
+
+    if (failures) {
+        std::printf("radio_output_test: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("radio_output_test: all passed\n");
+    return 0;
+}
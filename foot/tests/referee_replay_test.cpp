@@ -0,0 +1,125 @@
+// 网络裁判盒接收器测试（Linux）：FakeReferee经本机组播回放一段指令/阶段序列，检查排队的事件和去重
+// 构建：g++ -std=c++17 -O2 tests/referee_replay_test.cpp -o referee_replay_test（在foot目录下）
+#include <cstdio>
+#include <cmath>
+#include <iostream>
+#include <chrono>
+#include <thread>
+// utils/vector.h先包含util.h再定义EPSILON，单独编译时需要提前定义（与vector.h中的定义相同）
+#define EPSILON (1.0E-10)
+#include "../my_utils/referee_receiver.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static const char* GROUP = "224.5.23.1";
+static const int PORT = 41003;          // 避开真实裁判盒的10003，测试可以和比赛软件同时运行
+
+// 接收直到累计收到packets个包（最多等500ms），返回本次入队的事件数
+static int receive(RefereeReceiver& receiver, long long packets) {
+    int queued = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (receiver.packetCount() < packets && std::chrono::steady_clock::now() < deadline) {
+        queued += receiver.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return queued;
+}
+
+// 取出下一条事件并检查指令字符和原始命令
+static void expectEvent(RefereeReceiver& receiver, char command, int raw_command, int stage) {
+    RefereeEvent e;
+    CHECK(receiver.pop(e));
+    CHECK(e.command == command);
+    CHECK(e.raw_command == raw_command);
+    CHECK(e.stage == stage);
+}
+
+static void testReplay(const char* iface) {
+    RefereeReceiver receiver;
+    FakeReferee referee;
+    if (iface) {
+        CHECK(receiver.open(GROUP, PORT, iface));
+        CHECK(referee.open(GROUP, PORT, iface));
+    } else {
+        // 两端都用默认网卡参数
+        CHECK(receiver.open(GROUP, PORT));
+        CHECK(referee.open(GROUP, PORT));
+    }
+    long long sent = 0;
+    RefereeEvent e;
+
+    // 赛前阶段没有对应的串口字符，只有HALT入队
+    referee.setStage(REF_STAGE_NORMAL_FIRST_HALF_PRE, 300000000LL);
+    CHECK(referee.sendCommand(REF_HALT)); sent++;
+    CHECK(receive(receiver, sent) == 1);
+    expectEvent(receiver, COMM_HALT, REF_HALT, REF_STAGE_NORMAL_FIRST_HALF_PRE);
+
+    // 裁判盒周期性重发的相同状态不产生事件
+    for (int i = 0; i < 3; i++) {
+        CHECK(referee.sendState()); sent++;
+    }
+    CHECK(receive(receiver, sent) == 0);
+    CHECK(!receiver.pop(e));
+
+    CHECK(referee.sendCommand(REF_STOP)); sent++;
+    CHECK(receive(receiver, sent) == 1);
+    expectEvent(receiver, COMM_STOP, REF_STOP, REF_STAGE_NORMAL_FIRST_HALF_PRE);
+
+    // 阶段变化先于同一包中的指令入队
+    referee.setStage(REF_STAGE_NORMAL_FIRST_HALF, 299000000LL);
+    CHECK(referee.sendCommand(REF_PREPARE_KICKOFF_BLUE)); sent++;
+    CHECK(referee.sendState()); sent++;
+    CHECK(referee.sendCommand(REF_NORMAL_START)); sent++;
+    CHECK(receive(receiver, sent) == 3);
+    expectEvent(receiver, COMM_FIRST_HALF, -1, REF_STAGE_NORMAL_FIRST_HALF);
+    expectEvent(receiver, COMM_KICKOFF_BLUE, REF_PREPARE_KICKOFF_BLUE, REF_STAGE_NORMAL_FIRST_HALF);
+    expectEvent(receiver, COMM_READY, REF_NORMAL_START, REF_STAGE_NORMAL_FIRST_HALF);
+
+    // 摆球按STOP处理，保留原始命令和指定位置(mm转为cm)
+    point2f spot(120.0f, -35.5f);
+    CHECK(referee.sendCommand(REF_BALL_PLACEMENT_YELLOW, &spot)); sent++;
+    CHECK(receive(receiver, sent) == 1);
+    CHECK(receiver.pop(e));
+    CHECK(e.command == COMM_STOP && e.raw_command == REF_BALL_PLACEMENT_YELLOW);
+    CHECK(e.has_designated_position);
+    CHECK(std::fabs(e.designated_position.x - 120.0f) < 0.01f && std::fabs(e.designated_position.y + 35.5f) < 0.01f);
+
+    // 连续两条相同的指令计数不同，两条都入队
+    CHECK(referee.sendCommand(REF_STOP)); sent++;
+    CHECK(referee.sendCommand(REF_STOP)); sent++;
+    CHECK(receive(receiver, sent) == 2);
+    expectEvent(receiver, COMM_STOP, REF_STOP, REF_STAGE_NORMAL_FIRST_HALF);
+    expectEvent(receiver, COMM_STOP, REF_STOP, REF_STAGE_NORMAL_FIRST_HALF);
+
+    // 只有阶段变化、指令计数不变时只入队阶段事件
+    referee.setStage(REF_STAGE_NORMAL_HALF_TIME, 0);
+    CHECK(referee.sendState()); sent++;
+    CHECK(referee.sendState()); sent++;
+    CHECK(receive(receiver, sent) == 1);
+    CHECK(receiver.pop(e));
+    CHECK(e.command == COMM_HALF_TIME && e.raw_command == -1);
+    CHECK(!receiver.pop(e));
+
+    CHECK(receiver.packetCount() == sent);
+    CHECK(receiver.errorCount() == 0);
+    CHECK(receiver.droppedCount() == 0);
+}
+
+int main() {
+    testReplay(nullptr);
+    testReplay("127.0.0.1");
+
+    if (failures) {
+        std::printf("referee_replay_test: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("referee_replay_test: all passed\n");
+    return 0;
+}
@@ -0,0 +1,148 @@
+// 实时循环的时延测量（Linux）
+// 构建：g++ -std=c++17 -O2 -pthread tests/rt_loop_latency.cpp -o rt_loop_latency（在foot目录下）
+// 1. 定时器模式：按帧周期运行，规划回调模拟固定的计算量，输出唤醒抖动和帧开始到任务发出时延的p50/p99
+// 2. 视觉fd模式：不设滤波回调，由另一个线程按帧周期发数据报，检查循环读空了fd，没有空转
+// 可选参数：帧数 帧周期(us) 规划耗时(us)，默认3000帧、1000us、200us
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <sys/socket.h>
+#include "../my_utils/rt_loop.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+// 忙等指定时间，模拟规划计算
+static void busyWait(long long ns) {
+    long long end = RtLoop::nowNs() + ns;
+    while (RtLoop::nowNs() < end) {}
+}
+
+static void measureTimerLoop(int frames, long long period_ns, long long work_ns) {
+    RtLoopConfig config;
+    config.frame_period_ns = period_ns;
+    config.report_frames = frames;
+
+    RtLoopReport wakeup = RtLoopReport(), latency = RtLoopReport();
+    std::atomic<int> reports(0);
+    std::atomic<long long> planned(0);
+    RtLoop loop(config);
+    loop.setReporter([&](const RtLoopReport& r) {
+        if (r.name[0] == 'w') wakeup = r; else latency = r;
+        reports++;
+    });
+    CHECK(loop.start(nullptr, [&](long long) {
+        busyWait(work_ns);
+        planned++;
+    }));
+    // 两个线程各报告一次后停止；帧周期的若干倍后仍未报告视为失败
+    long long deadline = RtLoop::nowNs() + (frames + 200) * period_ns * 2;
+    while (reports.load() < 2 && RtLoop::nowNs() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    loop.stop();
+
+    CHECK(reports.load() == 2);
+    CHECK(planned.load() >= frames);
+    std::printf("timer loop: %d frames, period %lldus, planner work %lldus\n",
+                frames, period_ns / 1000, work_ns / 1000);
+    std::printf("  wakeup : mean %.1fus p50 %.1fus p99 %.1fus max %.1fus overruns %lld\n",
+                wakeup.mean_us, wakeup.p50_us, wakeup.p99_us, wakeup.max_us, wakeup.overruns);
+    std::printf("  latency: mean %.1fus p50 %.1fus p99 %.1fus max %.1fus skipped %lld\n",
+                latency.mean_us, latency.p50_us, latency.p99_us, latency.max_us, latency.overruns);
+}
+
+static void checkVisionDrain(int datagrams, long long period_ns) {
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) == 0);
+
+    RtLoopConfig config;
+    config.frame_period_ns = period_ns;
+    config.vision_fd = fds[0];
+    config.report_frames = 0;
+
+    std::atomic<long long> planned(0);
+    RtLoop loop(config);
+    CHECK(loop.start(nullptr, [&](long long) { planned++; }));
+
+    char packet[256] = {0};
+    for (int i = 0; i < datagrams; i++) {
+        CHECK(send(fds[1], packet, sizeof(packet), 0) == (ssize_t)sizeof(packet));
+        std::this_thread::sleep_for(std::chrono::nanoseconds(period_ns));
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(period_ns * 5));
+    loop.stop();
+    close(fds[0]);
+    close(fds[1]);
+
+    // 每个数据报至多触发一帧；不读空fd时水平触发的epoll会让帧数远超数据报数
+    std::printf("vision loop: %d datagrams, %lld frames planned\n", datagrams, planned.load());
+    CHECK(planned.load() > 0);
+    CHECK(planned.load() <= datagrams);
+}
+
+// 滤波回调读空fd后，滤波期间才到达的数据报（另一个摄像头的包）不能被循环丢弃
+static void checkLateDatagrams(int datagrams, long long period_ns) {
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) == 0);
+
+    RtLoopConfig config;
+    config.frame_period_ns = period_ns;
+    config.vision_fd = fds[0];
+    config.report_frames = 0;
+
+    std::atomic<int> received(0);
+    RtLoop loop(config);
+    CHECK(loop.start([&](long long) {
+        char buf[256];
+        int first_camera = 0;
+        ssize_t r;
+        while ((r = recv(fds[0], buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+            received++;
+            if (buf[0] == 'A') first_camera++;
+        }
+        // 读完之后第二个摄像头的包才到达
+        for (int i = 0; i < first_camera; i++) {
+            char late = 'B';
+            CHECK(send(fds[1], &late, 1, 0) == 1);
+        }
+    }, [](long long) {}));
+
+    for (int i = 0; i < datagrams; i++) {
+        char early = 'A';
+        CHECK(send(fds[1], &early, 1, 0) == 1);
+        std::this_thread::sleep_for(std::chrono::nanoseconds(period_ns));
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(period_ns * 5));
+    loop.stop();
+    close(fds[0]);
+    close(fds[1]);
+
+    std::printf("late datagrams: %d sent, %d received by the filter\n", 2 * datagrams, received.load());
+    CHECK(received.load() == 2 * datagrams);
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 3000;
+    long long period_ns = (argc > 2 ? std::atoll(argv[2]) : 1000) * 1000;
+    long long work_ns = (argc > 3 ? std::atoll(argv[3]) : 200) * 1000;
+
+    measureTimerLoop(frames, period_ns, work_ns);
+    checkVisionDrain(200, 2000000);
+    checkLateDatagrams(200, 2000000);
+
+    if (failures) {
+        std::printf("rt_loop_latency: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("rt_loop_latency: all passed\n");
+    return 0;
+}
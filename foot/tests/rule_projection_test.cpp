@@ -0,0 +1,151 @@
+// 规则投影的测试：定位球主罚者豁免和各场地的禁区
+// 构建：g++ -std=c++17 -O2 [-DFIELD_PROFILE=DivisionA] tests/rule_projection_test.cpp -o rule_projection_test（在foot目录下）
+// WorldModel、Ball等的非内联成员由宿主程序实现，这里给出测试用的最小实现
+#include <cstdio>
+#include <cmath>
+#include <iostream>
+// utils/vector.h先包含util.h再定义EPSILON，单独编译时需要提前定义（与vector.h中的定义相同）
+#define EPSILON (1.0E-10)
+#include "../my_utils/rule_projection.h"
+#include "../utils/ball.h"
+#include "../utils/game_state.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+// ---------------- 测试用的宿主世界模型 ----------------
+
+FilteredObject::FilteredObject() {}
+FilteredObject::~FilteredObject() {}
+Ball::Ball() : lost_frame(0), proc_frame(0), cur_cycle(0) {}
+Ball::~Ball() {}
+void Ball::set_ball_vision(const point2f pos, bool is_lost) {
+    log.getLogger(cur_cycle).pos = pos;
+    lost_frame = is_lost ? 1 : 0;
+}
+
+WorldModel::WorldModel() : our(NULL), opp(NULL), kick(NULL), sim_kick(NULL), match_ball(NULL),
+    our_goalie(0), opp_goalie(0), current_cycle(0), game_state(NULL), is_simulation(true) {}
+WorldModel::~WorldModel() {}
+void WorldModel::set_game_state(GameState* state) { game_state = state; }
+const GameState* WorldModel::game_states() const { return game_state; }
+
+// ---------------- 测试 ----------------
+
+static PlayerTask taskTo(float x, float y) {
+    PlayerTask t;
+    t.target_pos = point2f(x, y);
+    return t;
+}
+
+static bool near(const point2f& p, float x, float y) {
+    return std::fabs(p.x - x) < 1e-3f && std::fabs(p.y - y) < 1e-3f;
+}
+
+int main() {
+    bool our_flags[MAX_TEAM_ROBOTS] = {false};
+    bool opp_flags[MAX_TEAM_ROBOTS] = {false};
+    our_flags[0] = our_flags[2] = our_flags[5] = true;
+
+    Ball ball;
+    GameState game_state;
+    game_state.init(TEAM_BLUE);
+    WorldModel model;
+    model.set_our_exist_id(our_flags);
+    model.set_opp_exist_id(opp_flags);
+    model.set_our_goalie(0);
+    model.set_ball(&ball);
+    model.set_game_state(&game_state);
+
+    RuleProjection projection;
+    const int ids[] = {2, 5};
+    const float circle_edge = float(CENTER_CIRCLE_RADIUS + MAX_ROBOT_SIZE);
+
+    // 我方开球准备阶段：主罚者还没接近球（needKick未置位），目标仍应留在中点的球上
+    ball.set_ball_vision(point2f(0, 0), false);
+    game_state.transition(COMM_STOP, false, 0.5);
+    game_state.transition(COMM_KICKOFF_BLUE, false, 1.0);
+    model.set_cycle(1);
+    CHECK(model.get_play_mode() == PlayMode::OurKickOff);
+    {
+        PlayerTask tasks[] = {taskTo(0, 0), taskTo(0, 0)};
+        projection.projectTasks(&model, ids, tasks, 2, 2);
+        CHECK(!tasks[0].needKick);
+        CHECK(near(tasks[0].target_pos, 0, 0));
+        // 其他球员推出中圈并留在本方半场
+        CHECK(tasks[1].target_pos.x <= -MAX_ROBOT_SIZE + 1e-3f);
+        CHECK(std::fabs(point2f(tasks[1].target_pos).length() - circle_edge) < 1e-2f);
+    }
+
+    // 单个任务的接口同样按角色豁免
+    model.set_cycle(2);
+    {
+        PlayerTask task = taskTo(0, 0);
+        projection.projectTask(&model, 2, task, 2);
+        CHECK(near(task.target_pos, 0, 0));
+        projection.projectTask(&model, 5, task, 2);
+        CHECK(!near(task.target_pos, 0, 0));
+    }
+
+    // 没有主罚者时needKick也不再豁免
+    model.set_cycle(3);
+    {
+        PlayerTask task = taskTo(0, 0);
+        task.needKick = true;
+        projection.projectTask(&model, 2, task, -1);
+        CHECK(!near(task.target_pos, 0, 0));
+    }
+
+    // 我方点球：主罚者可以走到罚球点，其他球员留在球后方PENALTY_MARK_BEHIND处
+    const float mark_x = float(Field::LENGTH_H - Field::DEFENSE_DEPTH - 100);
+    ball.set_ball_vision(point2f(mark_x, 0), false);
+    game_state.transition(COMM_STOP, false, 2.0);
+    game_state.transition(COMM_PENALTY_BLUE, false, 3.0);
+    model.set_cycle(4);
+    CHECK(model.get_play_mode() == PlayMode::OurPenaltyKick);
+    {
+        PlayerTask tasks[] = {taskTo(mark_x - 5, 0), taskTo(mark_x - 5, 30)};
+        projection.projectTasks(&model, ids, tasks, 2, 2);
+        CHECK(near(tasks[0].target_pos, mark_x - 5, 0));
+        CHECK(near(tasks[1].target_pos, mark_x - float(RuleProjection::PENALTY_MARK_BEHIND), 30));
+    }
+
+    // 对方开球：传入的车号不在豁免范围内，所有球员都留在中圈外
+    ball.set_ball_vision(point2f(0, 0), false);
+    game_state.transition(COMM_STOP, false, 4.0);
+    game_state.transition(COMM_KICKOFF_YELLOW, false, 5.0);
+    model.set_cycle(5);
+    CHECK(model.get_play_mode() == PlayMode::OppKickOff);
+    {
+        PlayerTask task = taskTo(-10, 0);
+        projection.projectTask(&model, 2, task, 2);
+        CHECK(near(task.target_pos, -circle_edge, 0));
+    }
+
+    // 禁区：场上球员的目标推出禁区，守门员不受限
+    ball.set_ball_vision(point2f(0, 0), false);
+    game_state.transition(COMM_START, false, 6.0);
+    model.set_cycle(6);
+    {
+        const int all_ids[] = {0, 2, 5};
+        const float gx = float(-Field::LENGTH_H);
+        PlayerTask tasks[] = {taskTo(gx + 10, 5), taskTo(gx + 10, 5), taskTo(gx + 20, float(Field::DEFENSE_WIDTH_H))};
+        projection.projectTasks(&model, all_ids, tasks, 3, -1);
+        CHECK(near(tasks[0].target_pos, gx + 10, 5));
+        for (int i = 1; i < 3; i++) {
+            CHECK(!Field::in_our_defense(tasks[i].target_pos.x, tasks[i].target_pos.y, MAX_ROBOT_SIZE));
+            CHECK(Field::in_our_defense(tasks[i].target_pos.x, tasks[i].target_pos.y, MAX_ROBOT_SIZE + PENALTY_BUFF + 1));
+        }
+    }
+
+    if (failures == 0) {
+        std::printf("rule_projection_test: all passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
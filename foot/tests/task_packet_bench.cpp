@@ -0,0 +1,76 @@
+// 无线任务包的包长和编解码吞吐量基准
+// 构建：g++ -std=c++17 -O2 tests/task_packet_bench.cpp -o task_packet_bench（在foot目录下）
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <chrono>
+// utils/vector.h先包含util.h再定义EPSILON，单独编译时需要提前定义（与vector.h中的定义相同）
+#define EPSILON (1.0E-10)
+#include "../utils/task_packet.h"
+
+static const int FRAMES = 200000;
+
+// 模拟比赛中的任务变化：目标点和朝向经常变化，运动参数和踢球参数偶尔变化
+static void step(PlayerTask& t, bool full) {
+    if (full || std::rand() % 3 == 0) {
+        t.target_pos = point2f(std::rand() % 600 - 300, std::rand() % 400 - 200);
+        t.orientate = (std::rand() % 6283 - 3141) / 1000.0;
+    }
+    if (full || std::rand() % 10 == 0) {
+        t.global_vel = point2f(std::rand() % 400 - 200, std::rand() % 400 - 200);
+    }
+    if (full || std::rand() % 50 == 0) {
+        t.maxAcceleration = std::rand() % 600;
+        t.maxDeceleration = std::rand() % 600;
+        t.needKick = std::rand() % 2;
+        t.kickPower = (std::rand() % 250) * KICK_POWER_STEP;
+    }
+}
+
+int main() {
+    std::srand(1);
+    PlayerTask tasks[MAX_ROBOTS];
+    PlayerTask received[MAX_ROBOTS];
+    bool active[MAX_ROBOTS];
+    bool updated[MAX_ROBOTS];
+    for (int i = 0; i < MAX_ROBOTS; i++) {
+        active[i] = i < TEAM_SIZE;
+        step(tasks[i], true);
+    }
+
+    // 预先生成所有帧的数据包，编码和解码分开计时
+    static unsigned char packets[FRAMES][TASK_PACKET_MAX_SIZE];
+    static int lengths[FRAMES];
+    TaskPacketEncoder encoder(60);
+    long long total_bytes = 0, key_bytes = 0, key_frames = 0;
+    double encode_s = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < TEAM_SIZE; i++) step(tasks[i], false);
+        auto t0 = std::chrono::steady_clock::now();
+        lengths[f] = encoder.encode(tasks, active, MAX_ROBOTS, packets[f], TASK_PACKET_MAX_SIZE);
+        encode_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        total_bytes += lengths[f];
+        if (packets[f][1] & TASK_PACKET_KEYFRAME) {
+            key_bytes += lengths[f];
+            key_frames++;
+        }
+    }
+
+    TaskPacketDecoder decoder;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        decoder.decode(packets[f], lengths[f], received, updated);
+    }
+    double decode_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    long long raw = (long long)sizeof(PlayerTask) * TEAM_SIZE;
+    std::printf("robots per frame      : %d\n", TEAM_SIZE);
+    std::printf("raw PlayerTask bytes  : %lld\n", raw);
+    std::printf("keyframe bytes (avg)  : %.1f\n", key_frames ? (double)key_bytes / key_frames : 0.0);
+    std::printf("delta frame bytes(avg): %.1f\n", (double)(total_bytes - key_bytes) / (FRAMES - key_frames));
+    std::printf("overall bytes (avg)   : %.1f (%.1fx smaller than raw)\n",
+                (double)total_bytes / FRAMES, raw / ((double)total_bytes / FRAMES));
+    std::printf("encode                : %.0f ns/frame\n", encode_s * 1e9 / FRAMES);
+    std::printf("decode                : %.0f ns/frame\n", decode_s * 1e9 / FRAMES);
+    return 0;
+}
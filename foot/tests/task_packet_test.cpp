@@ -0,0 +1,180 @@
+// 无线任务包编解码测试
+// 构建：g++ -std=c++17 -Wall -Wextra -O2 tests/task_packet_test.cpp -o task_packet_test（在foot目录下）
+#include <cstdio>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+// utils/vector.h先包含util.h再定义EPSILON，单独编译时需要提前定义（与vector.h中的定义相同）
+#define EPSILON (1.0E-10)
+#include "../utils/task_packet.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+// 随机任务，每帧只改动少数机器人的少数字段，接近实际比赛中的变化
+static void randomize(PlayerTask& t, bool full) {
+    if (full || std::rand() % 4 == 0) {
+        t.target_pos = point2f(std::rand() % 600 - 300, std::rand() % 400 - 200);
+        t.orientate = (std::rand() % 6283 - 3141) / 1000.0;
+    }
+    if (full || std::rand() % 8 == 0) {
+        t.global_vel = point2f(std::rand() % 400 - 200, std::rand() % 400 - 200);
+        t.rot_vel = (std::rand() % 2000 - 1000) / 1000.0;
+    }
+    if (full || std::rand() % 20 == 0) {
+        t.flag = std::rand() % 4;
+        t.role = (RobotRole)(std::rand() % 7);
+        t.rot_dir = std::rand() % 3 - 1;
+        t.maxAcceleration = std::rand() % 600;
+        t.maxDeceleration = std::rand() % 600;
+        t.needKick = std::rand() % 2;
+        t.isPass = std::rand() % 2;
+        t.needCb = std::rand() % 2;
+        t.isChipKick = std::rand() % 2;
+        t.kickPrecision = (std::rand() % 300) / 1000.0;
+        t.kickPower = (std::rand() % 250) * KICK_POWER_STEP;
+        t.chipKickPower = (std::rand() % 250) * KICK_POWER_STEP;
+    }
+}
+
+// 解码结果与原任务量化后逐字段一致
+static bool sameQuantized(const PlayerTask& a, const PlayerTask& b) {
+    QuantizedTask qa, qb;
+    qa.quantize(a);
+    qb.quantize(b);
+    return qa.diff(qb) == 0;
+}
+
+struct Link {
+    TaskPacketEncoder encoder;
+    TaskPacketDecoder decoder;
+    PlayerTask sent[MAX_ROBOTS];
+    PlayerTask received[MAX_ROBOTS];
+    bool active[MAX_ROBOTS];
+    bool updated[MAX_ROBOTS];
+    unsigned char packet[TASK_PACKET_MAX_SIZE];
+
+    explicit Link(int interval) : encoder(interval) {
+        for (int i = 0; i < MAX_ROBOTS; i++) {
+            active[i] = i < MAX_TEAM_ROBOTS;
+            randomize(sent[i], true);
+        }
+    }
+
+    int encodeFrame() {
+        for (int i = 0; i < MAX_ROBOTS; i++) randomize(sent[i], false);
+        return encoder.encode(sent, active, MAX_ROBOTS, packet, sizeof(packet));
+    }
+
+    bool allMatch() const {
+        for (int i = 0; i < MAX_ROBOTS; i++) {
+            if (active[i] && !sameQuantized(sent[i], received[i])) return false;
+        }
+        return true;
+    }
+};
+
+// 连续多帧编解码，每帧解码结果都与发送端一致
+static void testRoundTrip() {
+    Link link(60);
+    for (int frame = 0; frame < 600; frame++) {
+        int n = link.encodeFrame();
+        CHECK(n > 0);
+        CHECK(link.decoder.decode(link.packet, n, link.received, link.updated));
+        CHECK(link.allMatch());
+    }
+    CHECK(link.decoder.isSynced());
+    CHECK(link.decoder.lostPackets() == 0);
+}
+
+// 丢一个包后失去同步，下一个关键帧恢复
+static void testLossAndKeyframe() {
+    Link link(10);
+    int n = link.encodeFrame();
+    CHECK(link.decoder.decode(link.packet, n, link.received, link.updated));
+    link.encodeFrame();     // 丢弃
+    n = link.encodeFrame();
+    CHECK(link.decoder.decode(link.packet, n, link.received, link.updated));
+    CHECK(!link.decoder.isSynced());
+    CHECK(link.decoder.lostPackets() == 1);
+    for (int frame = 0; frame < 10; frame++) {
+        n = link.encodeFrame();
+        CHECK(link.decoder.decode(link.packet, n, link.received, link.updated));
+    }
+    CHECK(link.decoder.isSynced());
+    CHECK(link.allMatch());
+}
+
+// 重复或乱序到达的旧包被丢弃，不计为丢包，也不改变解码状态
+static void testDuplicateAndReorder() {
+    Link link(60);
+    std::vector<unsigned char> old_packet;
+    for (int frame = 0; frame < 5; frame++) {
+        int n = link.encodeFrame();
+        CHECK(link.decoder.decode(link.packet, n, link.received, link.updated));
+        if (frame == 2) old_packet.assign(link.packet, link.packet + n);
+    }
+    std::vector<PlayerTask> before(link.received, link.received + MAX_ROBOTS);
+
+    // 最后一个包重复到达
+    int n = link.encoder.encode(link.sent, link.active, MAX_ROBOTS, link.packet, sizeof(link.packet));
+    CHECK(link.decoder.decode(link.packet, n, link.received, link.updated));
+    CHECK(!link.decoder.decode(link.packet, n, link.received, link.updated));
+    // 更早的包乱序到达
+    CHECK(!link.decoder.decode(old_packet.data(), (int)old_packet.size(), link.received, link.updated));
+    CHECK(link.decoder.lostPackets() == 0);
+    CHECK(link.decoder.stalePackets() == 2);
+    CHECK(link.decoder.isSynced());
+    for (int i = 0; i < MAX_ROBOTS; i++) CHECK(sameQuantized(before[i], link.received[i]));
+
+    n = link.encodeFrame();
+    CHECK(link.decoder.decode(link.packet, n, link.received, link.updated));
+    CHECK(link.allMatch());
+}
+
+// 截断的包整包作废，差分基准保持不变，之后的包照常解码
+static void testTruncated() {
+    Link link(60);
+    int n = link.encodeFrame();
+    CHECK(link.decoder.decode(link.packet, n, link.received, link.updated));
+
+    // 让所有机器人都变化，截掉最后一个字节
+    for (int i = 0; i < MAX_ROBOTS; i++) randomize(link.sent[i], true);
+    n = link.encoder.encode(link.sent, link.active, MAX_ROBOTS, link.packet, sizeof(link.packet));
+    CHECK(!link.decoder.decode(link.packet, n - 1, link.received, link.updated));
+    // 完整的包重新到达时仍能正确解码（基准没有被截断的包部分改写）
+    CHECK(link.decoder.decode(link.packet, n, link.received, link.updated));
+    CHECK(link.allMatch());
+    CHECK(link.decoder.lostPackets() == 0);
+}
+
+// 序号回绕
+static void testSequenceWrap() {
+    Link link(1000000);
+    for (int frame = 0; frame < 70000; frame++) {
+        int n = link.encodeFrame();
+        if (!link.decoder.decode(link.packet, n, link.received, link.updated)) {
+            CHECK(false);
+            break;
+        }
+    }
+    CHECK(link.decoder.lostPackets() == 0);
+    CHECK(link.decoder.stalePackets() == 0);
+    CHECK(link.allMatch());
+}
+
+int main() {
+    std::srand(1);
+    testRoundTrip();
+    testLossAndKeyframe();
+    testDuplicateAndReorder();
+    testTruncated();
+    testSequenceWrap();
+    if (failures) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("task_packet_test: all passed\n");
+    return 0;
+}
@@ -0,0 +1,305 @@
+// A组11对11（22个机器人）时每帧规划开销的基准
+// 构建（在foot目录下）：
+//   g++ -std=c++17 -O2 -c -include iostream "-DEPSILON=(1.0E-10)" utils/maths.cpp -o maths.o
+//   g++ -std=c++17 -O2 -DROBOT_TEAM_SIZE=11 tests/team_size_bench.cpp maths.o -o team_size_bench
+// 车号取0~15中不连续的11个，检查按车号开的数组和RobotSet在整个车号范围内都正确。
+// 按robot2的帧级作业和逐车规划的顺序驱动真实的规划模块：双方队伍状态、世界事件、定位球预计算、
+// 传球网络、人墙，再为场上每个机器人选传球链、人墙站位或接应点，最后批量规则投影、写任务公告板和无线数据包。
+// 战术类依赖的Players等旧工具类不能脱离宿主单独编译，逐车规划用它们调用的同一组模块代替。
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+// utils/vector.h先包含util.h再定义EPSILON，单独编译时需要提前定义（与vector.h中的定义相同）
+#define EPSILON (1.0E-10)
+// 测试用的宿主按完整车号范围0~15开存在标识和球员数组
+#define ROBOT_HOST_EXIST_LEN 16
+#include "../utils/task_packet.h"
+#include "../utils/task_board.h"
+#include "../utils/world_snapshot.h"
+#include "../my_utils/team_state.h"
+#include "../my_utils/world_events.h"
+#include "../my_utils/set_piece_planner.h"
+#include "../my_utils/pass_network.h"
+#include "../my_utils/defense_wall.h"
+#include "../my_utils/rule_projection.h"
+#include "../my_utils/support_map.h"
+
+// ---------------- 测试用的宿主世界模型 ----------------
+
+static point2f our_pos[MAX_TEAM_ROBOTS], our_vel[MAX_TEAM_ROBOTS];
+static float our_dir[MAX_TEAM_ROBOTS];
+static point2f opp_pos[MAX_TEAM_ROBOTS];
+static PlayerVision opp_vision[MAX_TEAM_ROBOTS];
+static point2f ball_vel;
+
+FilteredObject::FilteredObject() {}
+FilteredObject::~FilteredObject() {}
+Ball::Ball() : lost_frame(0), proc_frame(0), cur_cycle(0) {}
+Ball::~Ball() {}
+void Ball::set_ball_vision(const point2f pos, bool is_lost) {
+    log.getLogger(cur_cycle).pos = pos;
+    vel = ball_vel;
+    lost_frame = is_lost ? 1 : 0;
+}
+
+WorldModel::WorldModel() : our(NULL), opp(NULL), kick(NULL), sim_kick(NULL), match_ball(NULL),
+    our_goalie(0), opp_goalie(0), current_cycle(0), game_state(NULL), is_simulation(true) {}
+WorldModel::~WorldModel() {}
+void WorldModel::set_game_state(GameState* state) { game_state = state; }
+const GameState* WorldModel::game_states() const { return game_state; }
+const point2f& WorldModel::get_our_player_pos(int id) const { return our_pos[id]; }
+const point2f& WorldModel::get_our_player_v(int id) const { return our_vel[id]; }
+float WorldModel::get_our_player_dir(int id) const { return our_dir[id]; }
+const point2f& WorldModel::get_opp_player_pos(int id) const { return opp_pos[id]; }
+const PlayerVision& WorldModel::get_opp_player(int id) const { return opp_vision[id]; }
+float WorldModel::get_opp_player_dir(int) const { return 0.0f; }
+
+// ---------------- 基准 ----------------
+
+static const int FRAMES = 20000;
+static const int OUR_IDS[] = {0, 1, 2, 3, 5, 7, 8, 9, 11, 13, 15};
+static const int OPP_IDS[] = {0, 2, 4, 5, 6, 8, 10, 11, 12, 14, 15};
+static const int IDS_PER_TEAM = sizeof(OUR_IDS) / sizeof(OUR_IDS[0]);
+// 每PHASE_FRAMES帧中前一部分为比赛进行，后一部分为停止（定位球预计算）
+static const int PHASE_FRAMES = 1000;
+static const int STOP_FRAMES = 300;
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+static float randomCoord(double half) {
+    return static_cast<float>((std::rand() / (double)RAND_MAX * 2 - 1) * half);
+}
+
+static float clampTo(float v, double half) {
+    return std::min(std::max(v, -float(half)), float(half));
+}
+
+// 随机游走：每帧移动几厘米，传球图和队伍状态按真实比赛的增量更新
+static void moveRobots(const int* ids, point2f* pos, point2f* vel, float step) {
+    for (int k = 0; k < IDS_PER_TEAM; k++) {
+        int id = ids[k];
+        point2f d(randomCoord(step), randomCoord(step));
+        pos[id] = point2f(clampTo(pos[id].x + d.x, FIELD_LENGTH_H), clampTo(pos[id].y + d.y, FIELD_WIDTH_H));
+        if (vel) vel[id] = d * 60.0f;
+    }
+}
+
+struct Stage {
+    const char* name;
+    std::vector<double> ns;
+};
+
+static void report(const Stage& stage) {
+    std::vector<double> v = stage.ns;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v) sum += x;
+    std::printf("%-22s: mean %8.0f ns  p99 %8.0f ns  max %8.0f ns\n", stage.name,
+                sum / v.size(), v[v.size() * 99 / 100], v.back());
+}
+
+int main() {
+    std::srand(1);
+    bool our_flags[MAX_TEAM_ROBOTS] = {false};
+    bool opp_flags[MAX_TEAM_ROBOTS] = {false};
+    for (int k = 0; k < IDS_PER_TEAM; k++) {
+        our_flags[OUR_IDS[k]] = opp_flags[OPP_IDS[k]] = true;
+        our_pos[OUR_IDS[k]] = point2f(randomCoord(FIELD_LENGTH_H), randomCoord(FIELD_WIDTH_H));
+        opp_pos[OPP_IDS[k]] = point2f(randomCoord(FIELD_LENGTH_H), randomCoord(FIELD_WIDTH_H));
+    }
+    point2f ball_pos(-100, 50);
+
+    Ball ball;
+    GameState game_state;
+    game_state.init(TEAM_BLUE);
+    WorldModel model;
+    model.set_our_exist_id(our_flags);
+    model.set_opp_exist_id(opp_flags);
+    model.set_our_goalie(OUR_IDS[0]);
+    model.set_opp_goalie(OPP_IDS[0]);
+    model.set_ball(&ball);
+    model.set_game_state(&game_state);
+
+    // 规划器每个实例持有的模块
+    OurTeamState our_state;
+    OppTeamState opp_state;
+    WorldChangeDetector change_detector;
+    SetPiecePlanner set_piece_planner;
+    PassNetwork pass_network(&model);
+    PassEvaluator pass_evaluator(&model);
+    RuleProjection rule_projection;
+    TeamTaskBoard board;
+    TaskPacketEncoder encoder(60);
+    TaskPacketDecoder decoder;
+    WallSolution wall;
+    static WorldSnapshot snapshot;
+    SupportMapTask support;
+    SupportMap support_map;
+    bool have_support = false;
+
+    PlayerTask tasks[MAX_ROBOTS];
+    PlayerTask decoded[MAX_ROBOTS];
+    bool active[MAX_ROBOTS];
+    bool updated[MAX_ROBOTS];
+    unsigned char packet[TASK_PACKET_MAX_SIZE];
+
+    Stage team_state = {"team states", {}};
+    Stage events = {"world events", {}};
+    Stage set_piece = {"set piece precompute", {}};
+    Stage network = {"pass network update", {}};
+    Stage wall_solve = {"defense wall", {}};
+    Stage robots = {"per-robot planning", {}};
+    Stage projection = {"rule projection", {}};
+    Stage output = {"task board + packet", {}};
+    Stage frame = {"frame total", {}};
+    Stage support_pass = {"support map (bg pass)", {}};
+
+    long long checksum = 0;
+    int chains = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        // 宿主：更新视觉、裁判和周期
+        bool stopped = f % PHASE_FRAMES >= PHASE_FRAMES - STOP_FRAMES;
+        if (f % PHASE_FRAMES == 0) {
+            game_state.transition(COMM_START, false, f / 60.0);
+        } else if (f % PHASE_FRAMES == PHASE_FRAMES - STOP_FRAMES) {
+            game_state.transition(COMM_STOP, false, f / 60.0);
+            ball_vel = point2f(0, 0);
+        }
+        if (!stopped) {
+            if (f % 120 == 0) ball_vel = point2f(randomCoord(200), randomCoord(200));
+            ball_pos = point2f(clampTo(ball_pos.x + ball_vel.x / 60, FIELD_LENGTH_H - 20),
+                               clampTo(ball_pos.y + ball_vel.y / 60, FIELD_WIDTH_H - 20));
+        }
+        moveRobots(OUR_IDS, our_pos, our_vel, stopped ? 1.0f : 5.0f);
+        moveRobots(OPP_IDS, opp_pos, NULL, stopped ? 1.0f : 5.0f);
+        for (int k = 0; k < IDS_PER_TEAM; k++) {
+            opp_vision[OPP_IDS[k]].set_vel(point2f(randomCoord(100), randomCoord(100)));
+        }
+        ball.set_cycle(f);
+        ball.set_ball_vision(ball_pos, false);
+        model.set_cycle(f);
+
+        Clock::time_point frame_start = Clock::now();
+
+        // 1. 帧级作业
+        Clock::time_point t = Clock::now();
+        our_state.update(&model);
+        opp_state.update(&model);
+        team_state.ns.push_back(elapsedNs(t));
+
+        t = Clock::now();
+        change_detector.update(&model);
+        checksum += change_detector.events() & 0xff;
+        events.ns.push_back(elapsedNs(t));
+
+        t = Clock::now();
+        set_piece_planner.update(&model);
+        set_piece.ns.push_back(elapsedNs(t));
+
+        t = Clock::now();
+        pass_network.update();
+        network.ns.push_back(elapsedNs(t));
+
+        t = Clock::now();
+        RobotSet field = model.get_our_field_set();
+        int goalie = model.get_our_goalie();
+        int field_ids[MAX_TEAM_ROBOTS];
+        int n = 0;
+        for (int id : field) field_ids[n++] = id;
+        DefenseWall::solve(ball_pos, our_pos[goalie], true, WallSolution::MAX_DEFENDERS, wall);
+        DefenseWall::assign(&model, field_ids, n, wall);
+        checksum += wall.count;
+        wall_solve.ns.push_back(elapsedNs(t));
+
+        // 2. 逐车规划：持球者找传球链和传球点，人墙成员去站位，其余球员去接应点；停止时按定位球方案站位
+        t = Clock::now();
+        int holder = our_state.closestToBall(field);
+        const SetPiecePlan* plan = set_piece_planner.getReadyPlan(SetPieceKind::FREE_KICK);
+        PlayerTask batch[MAX_TEAM_ROBOTS];
+        for (int i = 0; i < n; i++) {
+            int id = field_ids[i];
+            PlayerTask& task = batch[i];
+            task = PlayerTask();
+            int slot = wall.slotOf(id);
+            if (stopped && plan) {
+                SetPiecePlanner::fillTask(&model, *plan, id, task);
+            } else if (id == holder) {
+                PassChain chain;
+                chains += pass_network.search(id, ball_pos, 1, chain) ? 1 : 0;
+                PassCandidate candidate;
+                pass_evaluator.evaluate(id, ball_pos);
+                if (pass_evaluator.bestFor(chain.ids[1], candidate) || pass_evaluator.best(candidate)) {
+                    task = PassEvaluator::makePassTask(ball_pos, candidate);
+                } else {
+                    task.target_pos = ball_pos;
+                }
+            } else if (slot >= 0) {
+                task.target_pos = wall.pos[slot];
+                task.orientate = atan2(ball_pos.y - wall.pos[slot].y, ball_pos.x - wall.pos[slot].x);
+            } else if (have_support && support_map.spot_count > 0) {
+                const SupportSpot& s = support_map.spots[i % support_map.spot_count];
+                point2f spot(s.x, s.y);
+                task.target_pos = spot;
+                task.orientate = atan2(ball_pos.y - spot.y, ball_pos.x - spot.x);
+            } else {
+                task.target_pos = our_pos[id];
+            }
+        }
+        robots.ns.push_back(elapsedNs(t));
+
+        // 3. 全队一次批量规则投影
+        t = Clock::now();
+        rule_projection.projectTasks(&model, field_ids, batch, n, -1);
+        projection.ns.push_back(elapsedNs(t));
+
+        // 4. 输出：任务公告板和无线数据包
+        t = Clock::now();
+        for (int i = 0; i < MAX_ROBOTS; i++) {
+            active[i] = false;
+        }
+        for (int i = 0; i < n; i++) {
+            tasks[field_ids[i]] = batch[i];
+            board.set_task(field_ids[i], batch[i], f);
+            active[field_ids[i]] = true;
+        }
+        int bytes = encoder.encode(tasks, active, MAX_ROBOTS, packet, sizeof(packet));
+        checksum += decoder.decode(packet, bytes, decoded, updated) ? 1 : 0;
+        output.ns.push_back(elapsedNs(t));
+
+        frame.ns.push_back(elapsedNs(frame_start));
+
+        // 后台线程上的一整遍接应点热图（不在实时路径上），每100帧测一次
+        if (f % 100 == 0) {
+            fill_world_snapshot(&model, snapshot);
+            t = Clock::now();
+            support.begin(snapshot);
+            while (!support.refine(support_map)) {}
+            have_support = true;
+            checksum += support_map.spot_count;
+            support_pass.ns.push_back(elapsedNs(t));
+        }
+    }
+
+    std::printf("robots per team       : %d on field, ids 0..%d\n", TEAM_SIZE, MAX_TEAM_ROBOTS - 1);
+    report(team_state);
+    report(events);
+    report(set_piece);
+    report(network);
+    report(wall_solve);
+    report(robots);
+    report(projection);
+    report(output);
+    report(frame);
+    report(support_pass);
+    std::printf("chains found          : %d\n", chains);
+    std::printf("checksum              : %lld\n", checksum);
+    return 0;
+}
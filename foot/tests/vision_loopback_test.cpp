@@ -0,0 +1,162 @@
+// 视觉组播接收器与回放器的本机回环测试（Linux）
+// 构建：g++ -std=c++17 -O2 tests/vision_loopback_test.cpp -o vision_loopback_test（在foot目录下）
+#include <cstdio>
+#include <cmath>
+#include <iostream>
+#include <chrono>
+#include <thread>
+// utils/vector.h先包含util.h再定义EPSILON，单独编译时需要提前定义（与vector.h中的定义相同）
+#define EPSILON (1.0E-10)
+#include "../my_utils/vision_receiver.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static const char* GROUP = "224.5.23.2";
+static const int PORT = 41006;          // 避开真实SSL-Vision的10006，测试可以和比赛软件同时运行
+
+static FieldVisionMsg makeFrame(int camera, int frame) {
+    FieldVisionMsg msg;
+    msg.cameraId = camera;
+    msg.frame = frame;
+    msg.ball.push_back(point2f(12.5f + frame, -40.0f));
+    Robot r;
+    r.id = 3;
+    r.pos = point2f(-100.0f, 50.0f + frame);
+    r.orientation = 1.5f;
+    msg.buleRobot.push_back(r);
+    r.id = 15;
+    r.pos = point2f(200.0f, -75.0f);
+    r.orientation = -0.5f;
+    msg.yellowRobot.push_back(r);
+    return msg;
+}
+
+// 等待最多timeout_ms，直到解析出expected个检测帧
+static int receive(VisionReceiver& receiver, int expected, int timeout_ms = 500) {
+    int parsed = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (parsed < expected && std::chrono::steady_clock::now() < deadline) {
+        parsed += receiver.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return parsed;
+}
+
+static bool near(float a, float b) {
+    return std::fabs(a - b) < 0.01f;
+}
+
+// iface为空时两端都用默认网卡参数，检查默认值能互相收发
+static void testLoopback(const char* iface) {
+    VisionReceiver receiver;
+    VisionReplayer replayer;
+    if (iface) {
+        CHECK(receiver.open(GROUP, PORT, iface));
+        CHECK(replayer.open(GROUP, PORT, iface));
+    } else {
+        CHECK(receiver.open(GROUP, PORT));
+        CHECK(replayer.open(GROUP, PORT));
+    }
+
+    unsigned char packet[VisionReplayer::PACKET_SIZE];
+    for (int camera = 0; camera < 2; camera++) {
+        int n = VisionReplayer::encode(makeFrame(camera, 7), 100.25, packet, sizeof(packet));
+        CHECK(n > 0);
+        CHECK(replayer.send(packet, n));
+    }
+    CHECK(receive(receiver, 2) == 2);
+    CHECK(receiver.errorCount() == 0);
+
+    for (int camera = 0; camera < 2; camera++) {
+        const VisionCameraFrame& f = receiver.camera(camera);
+        CHECK(f.valid);
+        CHECK(f.msg.frame == 7);
+        CHECK(f.t_capture == 100.25);
+        CHECK(f.msg.ball.size() == 1 && near(f.msg.ball[0].x, 19.5f) && near(f.msg.ball[0].y, -40.0f));
+        CHECK(f.msg.buleRobot.size() == 1 && f.msg.buleRobot[0].id == 3 && near(f.msg.buleRobot[0].pos.y, 57.0f));
+        CHECK(f.msg.yellowRobot.size() == 1 && f.msg.yellowRobot[0].id == 15 &&
+              near(f.msg.yellowRobot[0].orientation, -0.5f));
+    }
+}
+
+static void testReplayFile() {
+    VisionReceiver receiver;
+    VisionReplayer replayer;
+    CHECK(receiver.open(GROUP, PORT, "127.0.0.1"));
+    CHECK(replayer.open(GROUP, PORT, "127.0.0.1"));
+
+    FILE* file = std::tmpfile();
+    CHECK(file != NULL);
+    if (!file) return;
+    unsigned char packet[VisionReplayer::PACKET_SIZE];
+    for (int frame = 1; frame <= 5; frame++) {
+        int n = VisionReplayer::encode(makeFrame(0, frame), frame * 0.016, packet, sizeof(packet));
+        CHECK(VisionReplayer::appendRecord(file, frame * 16000000LL, packet, n));
+    }
+    std::fflush(file);
+
+    // replayFile按路径打开文件，通过/proc/self/fd取tmpfile的路径
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/self/fd/%d", fileno(file));
+    CHECK(replayer.replayFile(path, 0) == 5);
+    CHECK(receive(receiver, 5) == 5);
+    CHECK(receiver.camera(0).msg.frame == 5);
+    std::fclose(file);
+}
+
+// 格式错误的检测帧：camera_id能扫出来，但整帧解析中途失败，上一帧的数据必须保持不变
+static void testMalformedDetection() {
+    VisionReceiver receiver;
+    unsigned char packet[VisionReplayer::PACKET_SIZE];
+    int n = VisionReplayer::encode(makeFrame(0, 9), 3.5, packet, sizeof(packet));
+    CHECK(n > 0);
+    CHECK(receiver.parseWrapper(packet, n, 1000));
+    CHECK(receiver.errorCount() == 0);
+
+    // camera_id=0，一个空球，t_capture(字段2)用varint编码：扫描时能正常跳过，按fixed64读取时越界
+    const unsigned char bad[] = {
+        0x0a, 0x06,         // wrapper.detection，长度6
+        0x20, 0x00,         // camera_id = 0
+        0x2a, 0x00,         // balls：空消息
+        0x10, 0x01          // t_capture，线型错误
+    };
+    CHECK(!receiver.parseWrapper(bad, sizeof(bad), 2000));
+    CHECK(receiver.errorCount() == 1);
+
+    const VisionCameraFrame& f = receiver.camera(0);
+    CHECK(f.valid);
+    CHECK(f.arrival_ns == 1000);
+    CHECK(f.msg.frame == 9);
+    CHECK(f.t_capture == 3.5);
+    CHECK(f.msg.ball.size() == 1 && near(f.msg.ball[0].x, 21.5f));
+    CHECK(f.msg.buleRobot.size() == 1 && f.msg.buleRobot[0].id == 3);
+    CHECK(f.msg.yellowRobot.size() == 1 && f.msg.yellowRobot[0].id == 15);
+
+    // 之后的正常帧照常覆盖
+    n = VisionReplayer::encode(makeFrame(0, 10), 3.6, packet, sizeof(packet));
+    CHECK(receiver.parseWrapper(packet, n, 3000));
+    CHECK(receiver.camera(0).msg.frame == 10);
+    CHECK(receiver.camera(0).msg.ball.size() == 1 && near(receiver.camera(0).msg.ball[0].x, 22.5f));
+}
+
+int main() {
+    testMalformedDetection();
+    testLoopback(nullptr);
+    // 回环网卡：接收器和回放器用同一个网卡地址
+    testLoopback("127.0.0.1");
+    testReplayFile();
+
+    if (failures) {
+        std::printf("vision_loopback_test: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("vision_loopback_test: all passed\n");
+    return 0;
+}
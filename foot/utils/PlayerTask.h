@@ -55,46 +55,5 @@ public:
 	double chipKickPower;											// 挑球力度	
 };
 
-class CTaskMeditator
-{
-public:
-	CTaskMeditator(){
-		task_list = new PlayerTask[MaxRobotsTask]();
-		is_at_point = new bool[MaxRobotsTask]();
-	}
-	~CTaskMeditator(){
-		if (task_list) {
-			delete task_list;
-			task_list = NULL;
-		}
-		if (is_at_point){
-			delete is_at_point;
-			is_at_point = NULL;
-		}
-	};
-	void set_task(int id, const PlayerTask& task){
-		if (id < 0 || id>11) return;
-		task_list[id] = task;
-	}
-
-	const PlayerTask& get_task(int id){
-		if (id < 0 || id>11) return task_list[0];
-		return task_list[id];
-	}
-	const bool arrive_point(int id, const point2f& current_pos, const float& dir){
-		if (id < 0 || id>11) return false;
-		if ((current_pos - task_list[id].target_pos).length() < arrive_point_range/*&&(fabs(anglemod(dir - task_list[id].orientate)))<5*PI/180*/)
-			is_at_point[id] = true;
-		else
-			is_at_point[id] = false;
-		return is_at_point[id];
-	}
-private:
-	static const int MaxRobotsTask = 6;
-	static const int arrive_point_range = 10;
-	PlayerTask *task_list;
-	bool* is_at_point;
-};
-
-typedef Singleton<CTaskMeditator> TaskMeditator;
+//全队任务公告板见task_board.h
 #endif
\ No newline at end of file
@@ -1,11 +1,12 @@
 ﻿#ifndef BASEVISION_H
 #define BASEVISION_H
 #include "vector.h"
+#include "constants.h"
 #include <map>
 #include <vector>
 #define ERRORNUM 9999
 #define CAMERAS 2
-#define MaxPlayer 6
+#define MaxPlayer MAX_TEAM_ROBOTS
 /*场地信息选择如下数据结构原因如下：
 1：使用vector可以动态的储存场上的视觉数据；提高程序效率；操作视觉数据方便
 2： 如果使用数组，只能先静态定义好场上的视觉储存空间例如：蓝队机器人：buleRobot[6]；同时操作数据很不方便（融合处理删去相同车号数据）
@@ -24,46 +24,66 @@
 #ifndef __CONSTANTS_H__
 #define __CONSTANTS_H__
 #include "vector.h"
+#include "field_profile.h"
 
-const int MAX_ROBOTS = 12;
-const int MAX_TEAM_ROBOTS = 6;
+//每队车号范围（SSL车号0~15），与场上人数无关
+//世界模型、任务公告板、战术和通信中按车号开的数组以及RobotSet的位宽都由它决定
+const int MAX_TEAM_ROBOTS = 16;
+const int MAX_ROBOTS = 2 * MAX_TEAM_ROBOTS;
+//每队场上机器人数量，只用于按人数安排阵型、接应点等逻辑，A组11对11比赛编译时加-DROBOT_TEAM_SIZE=11
+#ifndef ROBOT_TEAM_SIZE
+#define ROBOT_TEAM_SIZE 6
+#endif
+static_assert(ROBOT_TEAM_SIZE > 0 && ROBOT_TEAM_SIZE <= MAX_TEAM_ROBOTS, "ROBOT_TEAM_SIZE must be in 1..16");
+const int TEAM_SIZE = ROBOT_TEAM_SIZE;
+//宿主接口的车号范围：宿主传入的存在标识数组的长度，也是按车号读取宿主球员数据（get_our_player_pos等）时车号的上限
+//现有宿主按ROBOT_TEAM_SIZE开这些数组；读宿主数据只能用这个长度，MAX_TEAM_ROBOTS只用于DLL内部按车号开的数组
+//宿主按完整车号范围开数组时编译加-DROBOT_HOST_EXIST_LEN=16
+#ifndef ROBOT_HOST_EXIST_LEN
+#define ROBOT_HOST_EXIST_LEN ROBOT_TEAM_SIZE
+#endif
+static_assert(ROBOT_HOST_EXIST_LEN >= ROBOT_TEAM_SIZE && ROBOT_HOST_EXIST_LEN <= MAX_TEAM_ROBOTS, "ROBOT_HOST_EXIST_LEN must be in ROBOT_TEAM_SIZE..16");
+const int HOST_EXIST_LEN = ROBOT_HOST_EXIST_LEN;
 const int MAX_ROBOT_SIZE = 9;
-const double BALL_SIZE = 5;
+constexpr double BALL_SIZE = 5;
 const int SEGMENT_NUM = 4;
 //==== Field Dimensions (cm) =========================================//
 
-// diagonal is of 2800 x 2300 is 3623.53
-const double FIELD_LENGTH = 605;
-const double FIELD_WIDTH = 405;
-const double FIELD_LENGTH_H = (FIELD_LENGTH/2);
-const double FIELD_WIDTH_H = (FIELD_WIDTH/2);
+//场地尺寸取自field_profile.h中选定的场地，-DFIELD_PROFILE=DivisionA/DivisionB切换
+constexpr double FIELD_LENGTH = FIELD_PROFILE::LENGTH;
+constexpr double FIELD_WIDTH = FIELD_PROFILE::WIDTH;
+constexpr double FIELD_LENGTH_H = (FIELD_LENGTH/2);
+constexpr double FIELD_WIDTH_H = (FIELD_WIDTH/2);
 
-const double GOAL_WIDTH = 70;
-const double GOAL_DEPTH = 18;
-const double DEFENSE_WIDTH = 205;
-const double DEFENSE_DEPTH = 85;
-const double WALL_WIDTH = 1;
+constexpr double GOAL_WIDTH = FIELD_PROFILE::GOAL_WIDTH;
+constexpr double GOAL_DEPTH = FIELD_PROFILE::GOAL_DEPTH;
+//禁区的外接矩形，在禁区外留5cm
+constexpr double DEFENSE_WIDTH = FIELD_PROFILE::DEFENSE_WIDTH + 2 * (FIELD_PROFILE::DEFENSE_RADIUS + 5);
+constexpr double DEFENSE_DEPTH = FIELD_PROFILE::DEFENSE_DEPTH + FIELD_PROFILE::DEFENSE_RADIUS + 5;
+constexpr double WALL_WIDTH = 1;
 
-const double PENALTY_BUFF = 4;
-const double PENALTY_AREA_R = 80;
-const double PENALTY_AREA_L = 35;
-const double PENALTY_KICKER_L = 75;
+//D形禁区：到球门线上长PENALTY_AREA_L的线段距离小于PENALTY_AREA_R的区域；A/B组的矩形禁区按外接的D形近似，
+//需要精确禁区的代码用field_geometry.h的Field
+constexpr double PENALTY_BUFF = 4;
+constexpr double PENALTY_AREA_R = FIELD_PROFILE::DEFENSE_RADIUS + FIELD_PROFILE::DEFENSE_DEPTH;
+constexpr double PENALTY_AREA_L = FIELD_PROFILE::DEFENSE_WIDTH;
+constexpr double PENALTY_KICKER_L = FIELD_PROFILE::PENALTY_MARK;
 
-const double GOAL_WIDTH_H = (GOAL_WIDTH   /2);
-const double GOAL_DEPTH_H = (GOAL_DEPTH   /2);
-const double DEFENSE_WIDTH_H = (DEFENSE_WIDTH/2);
-const double DEFENSE_DEPTH_H = (DEFENSE_DEPTH/2);
-const double CENTER_CIRCLE_RADIUS = 50;
-const double PENALTY_BISECTOR = (GOAL_WIDTH/SEGMENT_NUM);
-const double ROBOT_HEAD = 7.5;
+constexpr double GOAL_WIDTH_H = (GOAL_WIDTH   /2);
+constexpr double GOAL_DEPTH_H = (GOAL_DEPTH   /2);
+constexpr double DEFENSE_WIDTH_H = (DEFENSE_WIDTH/2);
+constexpr double DEFENSE_DEPTH_H = (DEFENSE_DEPTH/2);
+constexpr double CENTER_CIRCLE_RADIUS = FIELD_PROFILE::CENTER_RADIUS;
+constexpr double PENALTY_BISECTOR = (GOAL_WIDTH/SEGMENT_NUM);
+constexpr double ROBOT_HEAD = 7.5;
 
 
 namespace RuleParam{
-	const double Stop_Dist = 50;
-	const double Free_Kick_Away_Dist = 50;
-	const double Goalie_Away_Goal_Dist = 15;
+	constexpr double Stop_Dist = 50;
+	constexpr double Free_Kick_Away_Dist = 50;
+	constexpr double Goalie_Away_Goal_Dist = 15;
 }
 
 
-const double OUTER_PENALTY_AREA_R = PENALTY_AREA_R + MAX_ROBOT_SIZE * 4 + RuleParam::Free_Kick_Away_Dist + PENALTY_BUFF;
+constexpr double OUTER_PENALTY_AREA_R = PENALTY_AREA_R + MAX_ROBOT_SIZE * 4 + RuleParam::Free_Kick_Away_Dist + PENALTY_BUFF;
 #endif
@@ -0,0 +1,87 @@
+﻿#ifndef FIELD_GEOMETRY_H
+#define FIELD_GEOMETRY_H
+#include "constants.h"
+#include "vector.h"
+
+/*场地几何
+1：FieldGeometry<Profile>在field_profile.h的场地类型上给出球门、禁区、中圈等区域
+2：所有点和区域判断都是constexpr，编译期折叠为立即数，没有全局对象，DLL加载时没有构造开销
+3：区域判断只用比较、取绝对值和最值，不含短路分支，可以直接用在批量（SIMD）循环里
+4：禁区是到矩形距离不超过DEFENSE_RADIUS的圆角矩形，见field_profile.h*/
+
+template <class Profile>
+struct FieldGeometry{
+	typedef Profile profile_type;
+
+	static constexpr double LENGTH = Profile::LENGTH;
+	static constexpr double WIDTH = Profile::WIDTH;
+	static constexpr double LENGTH_H = Profile::LENGTH / 2;
+	static constexpr double WIDTH_H = Profile::WIDTH / 2;
+	static constexpr double GOAL_WIDTH_H = Profile::GOAL_WIDTH / 2;
+	static constexpr double GOAL_DEPTH = Profile::GOAL_DEPTH;
+	static constexpr double DEFENSE_DEPTH = Profile::DEFENSE_DEPTH;
+	static constexpr double DEFENSE_WIDTH_H = Profile::DEFENSE_WIDTH / 2;
+	static constexpr double DEFENSE_RADIUS = Profile::DEFENSE_RADIUS;
+	static constexpr double CENTER_RADIUS = Profile::CENTER_RADIUS;
+
+	//我方在x负方向，对方在x正方向
+	static constexpr point2f our_goal_center(){ return point2f(float(-LENGTH_H), 0.0f); }
+	static constexpr point2f our_goal_left(){ return point2f(float(-LENGTH_H), float(-GOAL_WIDTH_H)); }
+	static constexpr point2f our_goal_right(){ return point2f(float(-LENGTH_H), float(GOAL_WIDTH_H)); }
+	static constexpr point2f opp_goal_center(){ return point2f(float(LENGTH_H), 0.0f); }
+	static constexpr point2f opp_goal_left(){ return point2f(float(LENGTH_H), float(-GOAL_WIDTH_H)); }
+	static constexpr point2f opp_goal_right(){ return point2f(float(LENGTH_H), float(GOAL_WIDTH_H)); }
+	static constexpr point2f our_penalty_mark(){ return point2f(float(-LENGTH_H + Profile::PENALTY_MARK), 0.0f); }
+	static constexpr point2f opp_penalty_mark(){ return point2f(float(LENGTH_H - Profile::PENALTY_MARK), 0.0f); }
+	static constexpr point2f center(){ return point2f(0.0f, 0.0f); }
+
+	//在场地内，margin为离边线的距离
+	static constexpr bool in_field(float x, float y, float margin = 0){
+		return (abs_f(x) <= float(LENGTH_H) - margin) & (abs_f(y) <= float(WIDTH_H) - margin);
+	}
+
+	//在我方/对方禁区内，margin为禁区向外扩的距离
+	static constexpr bool in_our_defense(float x, float y, float margin = 0){
+		return defense_dist2(-x, y) <= square(float(DEFENSE_RADIUS) + margin);
+	}
+	static constexpr bool in_opp_defense(float x, float y, float margin = 0){
+		return defense_dist2(x, y) <= square(float(DEFENSE_RADIUS) + margin);
+	}
+
+	//在中圈内
+	static constexpr bool in_center_circle(float x, float y, float margin = 0){
+		return x * x + y * y < square(float(CENTER_RADIUS) + margin);
+	}
+
+	//在我方/对方球门内（球门线之后）
+	static constexpr bool in_our_goal(float x, float y){
+		return (x < float(-LENGTH_H)) & (x > float(-LENGTH_H - GOAL_DEPTH)) & (abs_f(y) < float(GOAL_WIDTH_H));
+	}
+	static constexpr bool in_opp_goal(float x, float y){
+		return (x > float(LENGTH_H)) & (x < float(LENGTH_H + GOAL_DEPTH)) & (abs_f(y) < float(GOAL_WIDTH_H));
+	}
+
+	//以0/1浮点数返回的区域判断，便于在批量循环里做掩码运算
+	static constexpr float our_defense_mask(float x, float y, float margin = 0){
+		return in_our_defense(x, y, margin) ? 1.0f : 0.0f;
+	}
+	static constexpr float opp_defense_mask(float x, float y, float margin = 0){
+		return in_opp_defense(x, y, margin) ? 1.0f : 0.0f;
+	}
+
+private:
+	static constexpr float abs_f(float v){ return v < 0 ? -v : v; }
+	static constexpr float max_f(float a, float b){ return a > b ? a : b; }
+	static constexpr float square(float v){ return v * v; }
+
+	//点(u, y)到对方禁区矩形[LENGTH_H - DEFENSE_DEPTH, LENGTH_H] x [-DEFENSE_WIDTH_H, DEFENSE_WIDTH_H]的距离平方，
+	//球门线之后的点按在矩形内处理
+	static constexpr float defense_dist2(float u, float y){
+		return square(max_f(float(LENGTH_H - DEFENSE_DEPTH) - u, 0.0f)) + square(max_f(abs_f(y) - float(DEFENSE_WIDTH_H), 0.0f));
+	}
+};
+
+//当前编译选定的场地，与constants.h的场地常量来自同一个profile
+typedef FieldGeometry<FIELD_PROFILE> Field;
+
+#endif
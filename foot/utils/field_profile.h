@@ -0,0 +1,53 @@
+﻿#ifndef FIELD_PROFILE_H
+#define FIELD_PROFILE_H
+
+/*场地尺寸(cm)
+1：每种场地是一个只含constexpr常量的profile类型，constants.h的FIELD_*等常量和utils/field_geometry.h的Field都由选定的profile导出
+2：编译时用-DFIELD_PROFILE=DivisionA或-DFIELD_PROFILE=DivisionB切换场地，默认老场地
+3：禁区统一描述为“到一个矩形的距离不超过R”的圆角矩形：老场地的D形禁区是矩形深度为0、R为弧半径，
+   A/B组的矩形禁区R为0*/
+
+//老场地（605x405，D形禁区）
+struct LegacyField{
+	static constexpr double LENGTH = 605;
+	static constexpr double WIDTH = 405;
+	static constexpr double GOAL_WIDTH = 70;
+	static constexpr double GOAL_DEPTH = 18;
+	static constexpr double DEFENSE_DEPTH = 0;		//禁区矩形部分的深度
+	static constexpr double DEFENSE_WIDTH = 35;		//禁区矩形部分的宽度
+	static constexpr double DEFENSE_RADIUS = 80;	//禁区圆角半径
+	static constexpr double CENTER_RADIUS = 50;
+	static constexpr double PENALTY_MARK = 75;		//罚球点到球门线的距离
+};
+
+//A组场地（12m x 9m，矩形禁区3.6m x 1.8m）
+struct DivisionA{
+	static constexpr double LENGTH = 1200;
+	static constexpr double WIDTH = 900;
+	static constexpr double GOAL_WIDTH = 180;
+	static constexpr double GOAL_DEPTH = 18;
+	static constexpr double DEFENSE_DEPTH = 180;
+	static constexpr double DEFENSE_WIDTH = 360;
+	static constexpr double DEFENSE_RADIUS = 0;
+	static constexpr double CENTER_RADIUS = 50;
+	static constexpr double PENALTY_MARK = 800;
+};
+
+//B组场地（9m x 6m，矩形禁区2m x 1m）
+struct DivisionB{
+	static constexpr double LENGTH = 900;
+	static constexpr double WIDTH = 600;
+	static constexpr double GOAL_WIDTH = 100;
+	static constexpr double GOAL_DEPTH = 18;
+	static constexpr double DEFENSE_DEPTH = 100;
+	static constexpr double DEFENSE_WIDTH = 200;
+	static constexpr double DEFENSE_RADIUS = 0;
+	static constexpr double CENTER_RADIUS = 50;
+	static constexpr double PENALTY_MARK = 600;
+};
+
+#ifndef FIELD_PROFILE
+#define FIELD_PROFILE LegacyField
+#endif
+
+#endif
@@ -27,7 +27,9 @@
 const int TEAM_BLUE = (1 << 8);
 const int TEAM_YELLOW = (1 << 9);
 
+#include <chrono>
 #include "referee_commands.h"
+#include "play_mode.h"
 
 class GameState {
 	static const int GAME_ON =  (1 << 0);
@@ -53,17 +55,42 @@ class GameState {
 
 	int color;
 
+	// Play mode decoded once per transition, plus edge events and timestamps
+	PlayMode mode;
+	unsigned int mode_events;
+	double mode_start_time;
+	double restart_start_time;
+
 public:
-	GameState() : color(BLUE), state(GAME_ON), isGameOver(false){ }
+	GameState() : color(BLUE), state(GAME_ON), isGameOver(false), mode(PlayMode::Normal),
+		mode_events(MODE_EVENT_NONE), mode_start_time(0), restart_start_time(0){ }
 
-	void init(int _color) { color = _color; }
+	void init(int _color) { color = _color; mode = decodeMode(); }
 
 	int get() const{ return state; }
-	void set(int _state) { state = _state; }
+	void set(int _state) { state = _state; mode = decodeMode(); }
+
+	// Advance the state machine with a referee command and decode the play mode.
+	// timestamp is in seconds; a negative value uses the local steady clock.
+	void transition(char ref_command, bool ball_kicked, double timestamp = -1) {
+		int old_state = state;
+		applyCommand(ref_command, ball_kicked);
+		decode(old_state, timestamp < 0 ? now() : timestamp);
+	}
+
+	PlayMode playMode() const { return mode; }
+	// Edge events (PlayModeEvent bits) produced by the last transition
+	unsigned int modeEvents() const { return mode_events; }
+	// Time the current play mode was entered
+	double modeStartTime() const { return mode_start_time; }
+	// Time the last restart command (kickoff/free kick/penalty) was issued
+	double restartStartTime() const { return restart_start_time; }
+
+private:
 
 // ball_kickedãִг͵кָʱҪִпкָܿʼڼԱλгߵ
 //ʱײ򣬵зΪѾʼʼ򣬶ڵȴкеĿָŽǣзѾԭز
-	void transition(char ref_command, bool ball_kicked) {
+	void applyCommand(char ref_command, bool ball_kicked) {
 		if( ref_command == COMM_HALF_TIME || ref_command == COMM_OVER_TIME1 || ref_command == COMM_OVER_TIME2 ){
 			isGameOver = true;
 		}else{
@@ -119,6 +146,43 @@ public:
 		}
 	}
 
+	static double now() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	PlayMode decodeMode() const {
+		if (state == HALTED) return PlayMode::Halt;
+		if (state == GAME_OFF) return PlayMode::Stop;
+		if (state == GAME_ON) return PlayMode::Normal;
+		if (state & TIME_OUT) return PlayMode::Timeout;
+
+		bool ours = (state & color) != 0;
+		if (state & KICKOFF) return ours ? PlayMode::OurKickOff : PlayMode::OppKickOff;
+		if (state & PENALTY) return ours ? PlayMode::OurPenaltyKick : PlayMode::OppPenaltyKick;
+		if (state & (DIRECT | INDIRECT)) return ours ? PlayMode::OurFreeKick : PlayMode::OppFreeKick;
+		return PlayMode::Normal;
+	}
+
+	void decode(int old_state, double timestamp) {
+		mode_events = MODE_EVENT_NONE;
+		PlayMode new_mode = decodeMode();
+		if (new_mode != mode) {
+			mode = new_mode;
+			mode_start_time = timestamp;
+			mode_events |= MODE_EVENT_CHANGED;
+			if (mode == PlayMode::Stop) mode_events |= MODE_EVENT_STOPPED;
+			else if (mode == PlayMode::Halt) mode_events |= MODE_EVENT_HALTED;
+			else if (mode == PlayMode::Normal) mode_events |= MODE_EVENT_GAME_ON;
+			else if (state & RESTART) {
+				mode_events |= MODE_EVENT_RESTART_ISSUED;
+				restart_start_time = timestamp;
+			}
+		}
+		if ((state & READY) && !(old_state & READY)) mode_events |= MODE_EVENT_READY;
+	}
+
+public:
+
 	bool gameOn() const{ return (state == GAME_ON); }
 	bool gameOff() const { return (state == GAME_OFF); }
 	bool gameOver() const { return isGameOver; }
@@ -1,37 +1,6 @@
 ﻿#include "maths.h"
 
 
-//命名空间，场地上的不同点
-namespace FieldPoint{
-	//我方球门中心点
-	point2f Goal_Center_Point(-FIELD_LENGTH / 2, 0.0);      
-	//罚球点
-	point2f Penalty_Kick_Point(-FIELD_LENGTH / 2 + PENALTY_KICKER_L, 0.0);   
-	//球门的左角点
-	point2f Goal_Left_Point(-FIELD_LENGTH_H, -GOAL_WIDTH_H);
-	//球门的右角点
-	point2f Goal_Right_Point(-FIELD_LENGTH_H, GOAL_WIDTH_H);
-	//球门中心线左侧的两个点，可能是用于定义罚球区的边界。
-	point2f Goal_Center_Left_One_Point(-FIELD_LENGTH / 2, -PENALTY_BISECTOR);
-	point2f Goal_Center_Left_Two_Point(-FIELD_LENGTH / 2, -PENALTY_BISECTOR * 2);
-	//球门中心线右侧的两个点，同样可能是用于定义罚球区的边界。
-	point2f Goal_Center_Right_One_Point(-FIELD_LENGTH / 2, PENALTY_BISECTOR);
-	point2f Goal_Center_Right_Two_Point(-FIELD_LENGTH / 2, PENALTY_BISECTOR * 2);
-	//罚球区（禁区）的左右两个边界点，位于球门线前方
-	point2f Goal_Penalty_Area_L_Right(-FIELD_LENGTH, PENALTY_AREA_L / 2);
-	point2f Goal_Penalty_Area_L_Left(-FIELD_LENGTH, -PENALTY_AREA_L / 2);
-
-	point2f Penalty_Area_L_A(PENALTY_AREA_R - FIELD_LENGTH_H, PENALTY_AREA_L / 2);
-	point2f Penalty_Area_L_B(PENALTY_AREA_R - FIELD_LENGTH_H, -PENALTY_AREA_L / 2);
-	//罚球弧的中心点，通常用于定义罚球时球员必须站在其后的弧线。
-	point2f Penalty_Arc_Center_Right(-FIELD_LENGTH_H, PENALTY_AREA_L/2);
-	point2f Penalty_Arc_Center_Left(-FIELD_LENGTH_H,-PENALTY_AREA_L/2);
-	//可能是罚球区内某个矩形的边界点，这个矩形可能与罚球时的站位规则有关。
-	point2f Penalty_Rectangle_Left(-FIELD_LENGTH_H + PENALTY_AREA_R, -PENALTY_AREA_L / 2);
-	point2f Penalty_Rectangle_Right(-FIELD_LENGTH_H + PENALTY_AREA_R, PENALTY_AREA_L / 2);
-}
-
-
 // 定义了一个名为 Maths 的命名空间，用于封装与数学计算相关的函数。  
 namespace Maths
 {
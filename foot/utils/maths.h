@@ -14,27 +14,34 @@ enum RoleStyle{
 	Nothing
 };
 namespace FieldPoint{
-	//我方球门中点坐标
-	extern	point2f Goal_Center_Point;
-	extern	point2f Penalty_Kick_Point;
-	extern	point2f Goal_Left_Point;
-	extern  point2f Goal_Right_Point;
-	extern  point2f Goal_Center_Left_One_Point;
-	extern  point2f Goal_Center_Left_Two_Point;
-	extern  point2f Goal_Center_Right_One_Point;
-	extern  point2f Goal_Center_Right_Two_Point;
-	extern  point2f Goal_Penalty_Area_L_Right;
-	extern  point2f Goal_Penalty_Area_L_Left;
-	extern  point2f Penalty_Area_L_A;
-	extern  point2f Penalty_Area_L_B;
+	//场地上的常用点，constexpr常量编译期折叠，没有全局构造
+	//我方球门中心点
+	constexpr point2f Goal_Center_Point(-FIELD_LENGTH / 2, 0.0);
+	//罚球点
+	constexpr point2f Penalty_Kick_Point(-FIELD_LENGTH / 2 + PENALTY_KICKER_L, 0.0);
+	//球门的左角点
+	constexpr point2f Goal_Left_Point(-FIELD_LENGTH_H, -GOAL_WIDTH_H);
+	//球门的右角点
+	constexpr point2f Goal_Right_Point(-FIELD_LENGTH_H, GOAL_WIDTH_H);
+	//球门中心线左侧的两个点
+	constexpr point2f Goal_Center_Left_One_Point(-FIELD_LENGTH / 2, -PENALTY_BISECTOR);
+	constexpr point2f Goal_Center_Left_Two_Point(-FIELD_LENGTH / 2, -PENALTY_BISECTOR * 2);
+	//球门中心线右侧的两个点
+	constexpr point2f Goal_Center_Right_One_Point(-FIELD_LENGTH / 2, PENALTY_BISECTOR);
+	constexpr point2f Goal_Center_Right_Two_Point(-FIELD_LENGTH / 2, PENALTY_BISECTOR * 2);
+	//罚球区（禁区）的左右两个边界点
+	constexpr point2f Goal_Penalty_Area_L_Right(-FIELD_LENGTH, PENALTY_AREA_L / 2);
+	constexpr point2f Goal_Penalty_Area_L_Left(-FIELD_LENGTH, -PENALTY_AREA_L / 2);
+	constexpr point2f Penalty_Area_L_A(PENALTY_AREA_R - FIELD_LENGTH_H, PENALTY_AREA_L / 2);
+	constexpr point2f Penalty_Area_L_B(PENALTY_AREA_R - FIELD_LENGTH_H, -PENALTY_AREA_L / 2);
 	//我方球门罚球区矩形右边坐标点
-	extern  point2f Penalty_Arc_Center_Right;
+	constexpr point2f Penalty_Arc_Center_Right(-FIELD_LENGTH_H, PENALTY_AREA_L / 2);
 	//我方球门罚球区矩形左边坐标点
-	extern  point2f Penalty_Arc_Center_Left;
+	constexpr point2f Penalty_Arc_Center_Left(-FIELD_LENGTH_H, -PENALTY_AREA_L / 2);
 	//我方罚球区矩形左边坐标点
-	extern  point2f Penalty_Rectangle_Left;
+	constexpr point2f Penalty_Rectangle_Left(-FIELD_LENGTH_H + PENALTY_AREA_R, -PENALTY_AREA_L / 2);
 	//我方罚球区矩形右边坐标点
-	extern  point2f Penalty_Rectangle_Right;
+	constexpr point2f Penalty_Rectangle_Right(-FIELD_LENGTH_H + PENALTY_AREA_R, PENALTY_AREA_L / 2);
 }
 
 namespace Maths{
@@ -0,0 +1,39 @@
+﻿#ifndef PLAY_MODE_H
+#define PLAY_MODE_H
+
+// 比赛模式：由GameState::transition每次状态迁移时解码一次，供所有机器人共用
+enum class PlayMode : unsigned char {
+	Normal,				// 正常比赛
+	Stop,				// 停止（GAME_OFF）
+	Halt,				// 暂停，机器人不能移动
+	Timeout,			// 暂停时间
+	OurKickOff,			// 我方开球
+	OppKickOff,			// 对方开球
+	OurFreeKick,		// 我方任意球（直接/间接，角球由球位置区分）
+	OppFreeKick,		// 对方任意球
+	OurPenaltyKick,		// 我方点球
+	OppPenaltyKick		// 对方点球
+};
+
+// 比赛模式的边沿事件（位掩码），只在发生迁移的那次transition中有效
+enum PlayModeEvent : unsigned int {
+	MODE_EVENT_NONE				= 0,
+	MODE_EVENT_CHANGED			= 1u << 0,	// 比赛模式变化
+	MODE_EVENT_STOPPED			= 1u << 1,	// 进入停止状态
+	MODE_EVENT_HALTED			= 1u << 2,	// 进入暂停状态
+	MODE_EVENT_RESTART_ISSUED	= 1u << 3,	// 定位球指令下达
+	MODE_EVENT_READY			= 1u << 4,	// 定位球可以开始踢（开球/点球收到开始指令）
+	MODE_EVENT_GAME_ON			= 1u << 5	// 进入正常比赛
+};
+
+// 是否为我方定位球
+inline bool isOurRestart(PlayMode mode) {
+	return mode == PlayMode::OurKickOff || mode == PlayMode::OurFreeKick || mode == PlayMode::OurPenaltyKick;
+}
+
+// 是否为对方定位球
+inline bool isOppRestart(PlayMode mode) {
+	return mode == PlayMode::OppKickOff || mode == PlayMode::OppFreeKick || mode == PlayMode::OppPenaltyKick;
+}
+
+#endif
@@ -25,7 +25,8 @@
 #ifndef __REFEREE_COMMANDS_H__
 #define __REFEREE_COMMANDS_H__
 
-/* Baud rate */
+/* Baud rate of the legacy serial referee box; the network referee is
+ * decoded to the same commands by my_utils/referee_receiver.h */
 #define COMM_BAUD_RATE			9600
 
 // play commands
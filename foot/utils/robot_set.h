@@ -0,0 +1,120 @@
+﻿#ifndef ROBOT_SET_H
+#define ROBOT_SET_H
+#include "constants.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*机器人集合
+1：一个机器人ID对应一个二进制位，存在判断、计数和集合运算都是整数位运算
+2：遍历时每次取最低位的1（ctz），再清掉该位，不分配内存、没有逐个ID的判断
+3：size用popcount，rank(id)给出id在集合中从小到大的序号，可以替代“在ID列表里找自己下标”的循环*/
+
+class RobotSet
+{
+public:
+	typedef unsigned int mask_type;
+
+	constexpr RobotSet() :bits(0){}
+	explicit constexpr RobotSet(mask_type mask) :bits(mask){}
+
+	//由存在标记数组构造
+	static RobotSet from_flags(const bool* flags, int count){
+		mask_type mask = 0;
+		if (!flags) return RobotSet();
+		for (int i = 0; i < count; i++)
+			mask |= mask_type(flags[i] ? 1u : 0u) << i;
+		return RobotSet(mask);
+	}
+	//只含一个ID的集合，id越界时为空集
+	static constexpr RobotSet single(int id){
+		return RobotSet((id >= 0 && id < MAX_BITS) ? (1u << id) : 0u);
+	}
+	//ID为0~count-1的全集
+	static constexpr RobotSet all(int count){
+		return RobotSet(count >= MAX_BITS ? ~0u : ((1u << count) - 1u));
+	}
+
+	constexpr mask_type mask()const{ return bits; }
+	constexpr bool empty()const{ return bits == 0; }
+	constexpr bool contains(int id)const{ return id >= 0 && id < MAX_BITS && ((bits >> id) & 1u); }
+	int size()const{ return popcount(bits); }
+	//最小的ID，空集时返回-1
+	int first()const{ return bits ? ctz(bits) : -1; }
+	//id在集合中从小到大的序号，不在集合中时返回-1
+	int rank(int id)const{ return contains(id) ? popcount(bits & ((1u << id) - 1u)) : -1; }
+
+	void insert(int id){ bits |= single(id).bits; }
+	void erase(int id){ bits &= ~single(id).bits; }
+	void clear(){ bits = 0; }
+
+	//按条件筛选，pred(id)返回true的保留
+	template <class Pred>
+	RobotSet filter(Pred pred)const{
+		mask_type out = 0;
+		for (mask_type m = bits; m; m &= m - 1){
+			int id = ctz(m);
+			out |= mask_type(pred(id) ? 1u : 0u) << id;
+		}
+		return RobotSet(out);
+	}
+
+	//集合运算
+	constexpr RobotSet operator|(RobotSet o)const{ return RobotSet(bits | o.bits); }
+	constexpr RobotSet operator&(RobotSet o)const{ return RobotSet(bits & o.bits); }
+	constexpr RobotSet operator^(RobotSet o)const{ return RobotSet(bits ^ o.bits); }
+	constexpr RobotSet operator-(RobotSet o)const{ return RobotSet(bits & ~o.bits); }
+	RobotSet& operator|=(RobotSet o){ bits |= o.bits; return *this; }
+	RobotSet& operator&=(RobotSet o){ bits &= o.bits; return *this; }
+	RobotSet& operator-=(RobotSet o){ bits &= ~o.bits; return *this; }
+	constexpr bool operator==(RobotSet o)const{ return bits == o.bits; }
+	constexpr bool operator!=(RobotSet o)const{ return bits != o.bits; }
+
+	//按ID从小到大遍历：for (int id : set)
+	class iterator
+	{
+	public:
+		explicit iterator(mask_type m) :rest(m){}
+		int operator*()const{ return ctz(rest); }
+		iterator& operator++(){ rest &= rest - 1; return *this; }
+		bool operator!=(const iterator& o)const{ return rest != o.rest; }
+		bool operator==(const iterator& o)const{ return rest == o.rest; }
+	private:
+		mask_type rest;
+	};
+	iterator begin()const{ return iterator(bits); }
+	iterator end()const{ return iterator(0); }
+
+	static int popcount(mask_type m){
+#if defined(_MSC_VER)
+		return int(__popcnt(m));
+#elif defined(__GNUC__)
+		return __builtin_popcount(m);
+#else
+		m = m - ((m >> 1) & 0x55555555u);
+		m = (m & 0x33333333u) + ((m >> 2) & 0x33333333u);
+		return int((((m + (m >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+	}
+	//最低位1的位置，m不能为0
+	static int ctz(mask_type m){
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, m);
+		return int(index);
+#elif defined(__GNUC__)
+		return __builtin_ctz(m);
+#else
+		int n = 0;
+		while (!(m & 1u)){ m >>= 1; n++; }
+		return n;
+#endif
+	}
+
+private:
+	static const int MAX_BITS = 32;
+	static_assert(MAX_ROBOTS <= MAX_BITS, "RobotSet holds at most 32 robots");
+
+	mask_type bits;
+};
+#endif
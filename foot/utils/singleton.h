@@ -4,10 +4,8 @@ template <class T>
 class Singleton{
 public:
 	static	T* getInstance(){
-		static T* instance = nullptr;
-		if (!instance){
-			instance = new T();
-		}
+		//局部静态变量的初始化是线程安全的，多个规划线程同时首次调用也只会创建一个实例
+		static T* instance = new T();
 		return instance;
 	}
 private:
@@ -0,0 +1,123 @@
+﻿#ifndef TASK_BOARD_H
+#define TASK_BOARD_H
+#include <atomic>
+#include <cstring>
+#include "PlayerTask.h"
+#include "constants.h"
+#include "worldmodel.h"
+#include "singleton.h"
+
+/*全队任务公告板，替代CTaskMeditator
+1：MAX_ROBOTS个槽位，每个槽位一个顺序锁：写者把序号改为奇数后写入，写完改回偶数；
+   读者读前后序号一致且为偶数才算读到完整数据，否则重读。不同线程上的规划器可以无锁地发布任务、读取队友目标
+2：每个槽位按缓存行对齐，避免不同机器人写各自槽位时互相干扰
+3：到点判断每帧一次批量完成，结果保存在位掩码中*/
+
+class TeamTaskBoard
+{
+public:
+	TeamTaskBoard() :arrived_mask(0), arrival_cycle(-1){
+		for (int i = 0; i < MAX_ROBOTS; i++){
+			slots[i].seq.store(0, std::memory_order_relaxed);
+			slots[i].cycle = -1;
+		}
+	}
+
+	//发布任务；cycle为发布时的周期，便于读者判断任务是否过期
+	void set_task(int id, const PlayerTask& task, int cycle = -1){
+		if (id < 0 || id >= MAX_ROBOTS) return;
+		Slot& slot = slots[id];
+		//把序号从偶数改为奇数，同一槽位的多个写者互斥
+		unsigned int s = slot.seq.load(std::memory_order_relaxed);
+		while (true){
+			if (s & 1){
+				s = slot.seq.load(std::memory_order_relaxed);
+				continue;
+			}
+			if (slot.seq.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed)) break;
+		}
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(&slot.task, &task, sizeof(PlayerTask));
+		slot.cycle = cycle;
+		slot.seq.store(s + 2, std::memory_order_release);
+	}
+
+	//读取任务的一致副本；id越界时返回空任务
+	PlayerTask get_task(int id) const{
+		PlayerTask task;
+		read(id, task, NULL);
+		return task;
+	}
+
+	//读取任务及其发布周期；槽位从未写入时返回false
+	bool read(int id, PlayerTask& task, int* cycle) const{
+		if (id < 0 || id >= MAX_ROBOTS) return false;
+		const Slot& slot = slots[id];
+		unsigned int s1, s2;
+		int c = -1;
+		do{
+			s1 = slot.seq.load(std::memory_order_acquire);
+			if (s1 & 1) continue;
+			memcpy(&task, &slot.task, sizeof(PlayerTask));
+			c = slot.cycle;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			s2 = slot.seq.load(std::memory_order_relaxed);
+		} while ((s1 & 1) || s1 != s2);
+		if (cycle) *cycle = c;
+		return s1 != 0;
+	}
+
+	//读取队友当前目标点
+	bool get_target(int id, point2f& target) const{
+		PlayerTask task;
+		if (!read(id, task, NULL)) return false;
+		target = task.target_pos;
+		return true;
+	}
+
+	//每帧一次批量计算所有机器人是否到达目标点，同一周期重复调用直接返回
+	void update_arrivals(const WorldModel* model){
+		int cycle = model->get_cycle();
+		if (cycle == arrival_cycle.load(std::memory_order_relaxed)) return;
+
+		unsigned int mask = 0;
+		PlayerTask task;
+		for (int id : model->get_our_set()){
+			if (!read(id, task, NULL)) continue;
+			if ((model->get_our_player_pos(id) - task.target_pos).length() < arrive_point_range)
+				mask |= 1u << id;
+		}
+		arrived_mask.store(mask, std::memory_order_release);
+		arrival_cycle.store(cycle, std::memory_order_relaxed);
+	}
+
+	//本帧批量计算的到点结果
+	bool arrived(int id) const{
+		if (id < 0 || id >= MAX_ROBOTS) return false;
+		return (arrived_mask.load(std::memory_order_acquire) >> id) & 1u;
+	}
+
+	//兼容CTaskMeditator的单个到点判断
+	const bool arrive_point(int id, const point2f& current_pos, const float& dir){
+		point2f target;
+		if (!get_target(id, target)) return false;
+		return (current_pos - target).length() < arrive_point_range;
+	}
+
+private:
+	static const int arrive_point_range = 10;
+
+	struct alignas(64) Slot{
+		std::atomic<unsigned int> seq;
+		int cycle;
+		PlayerTask task;
+	};
+
+	Slot slots[MAX_ROBOTS];
+	std::atomic<unsigned int> arrived_mask;
+	std::atomic<int> arrival_cycle;
+};
+
+typedef TeamTaskBoard CTaskMeditator;
+typedef Singleton<TeamTaskBoard> TaskMeditator;
+#endif
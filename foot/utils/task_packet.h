@@ -0,0 +1,336 @@
+﻿#ifndef TASK_PACKET_H
+#define TASK_PACKET_H
+#include <cmath>
+#include <cstring>
+#include "PlayerTask.h"
+#include "constants.h"
+
+/*无线发送用的PlayerTask紧凑编码
+1：所有字段转为定点数：位置cm、角度mrad、速度cm/s、加速度cm/s^2、力度按KICK_POWER_STEP量化
+2：每个机器人只发送与上一帧相比发生变化的字段，用16位掩码标明
+3：每帧一个队伍数据包，带序号；每隔keyframe_interval帧发送一次全量关键帧，便于丢包后恢复
+数据包格式（小端）：
+	包头：magic(1) | 标志(1) | 序号(2) | 机器人数(1)
+	每个机器人：车号(1) | 字段掩码(2) | 按掩码顺序排列的字段*/
+
+#define TASK_PACKET_MAGIC 0xA5
+#define TASK_PACKET_KEYFRAME 0x01
+#define TASK_PACKET_HEADER_SIZE 5
+#define TASK_RECORD_HEADER_SIZE 3
+
+//字段掩码，顺序即编码顺序
+enum TaskField{
+	TF_FLAG = 1 << 0,				//int16
+	TF_ROLE = 1 << 1,				//uint8
+	TF_TARGET_POS = 1 << 2,			//int16 x2, cm
+	TF_ORIENTATE = 1 << 3,			//int16, mrad
+	TF_GLOBAL_VEL = 1 << 4,			//int16 x2, cm/s
+	TF_ROT_VEL = 1 << 5,			//int16, mrad/s
+	TF_ROT_DIR = 1 << 6,			//int8
+	TF_MAX_ACC = 1 << 7,			//uint16, cm/s^2
+	TF_MAX_DEC = 1 << 8,			//uint16, cm/s^2
+	TF_KICK_BITS = 1 << 9,			//uint8: needKick | isPass | needCb | isChipKick
+	TF_KICK_PRECISION = 1 << 10,	//uint16, mrad
+	TF_KICK_POWER = 1 << 11,		//uint8
+	TF_CHIP_POWER = 1 << 12,		//uint8
+	TF_ALL = (1 << 13) - 1
+};
+
+const double KICK_POWER_STEP = 0.05;		//力度量化步长，uint8最大可表示12.75
+const int TASK_RECORD_MAX_SIZE = TASK_RECORD_HEADER_SIZE + 25;
+const int TASK_PACKET_MAX_SIZE = TASK_PACKET_HEADER_SIZE + MAX_ROBOTS * TASK_RECORD_MAX_SIZE;
+
+//PlayerTask的定点表示，编码端和解码端各自保存上一帧的状态用于求差
+struct QuantizedTask{
+	short flag;
+	unsigned char role;
+	short pos_x, pos_y;
+	short orientate;
+	short vel_x, vel_y;
+	short rot_vel;
+	signed char rot_dir;
+	unsigned short max_acc;
+	unsigned short max_dec;
+	unsigned char kick_bits;
+	unsigned short kick_precision;
+	unsigned char kick_power;
+	unsigned char chip_power;
+
+	QuantizedTask(){ memset(this, 0, sizeof(QuantizedTask)); }
+
+	static short toShort(double v){
+		if (v > 32767) return 32767;
+		if (v < -32768) return -32768;
+		return (short)floor(v + 0.5);
+	}
+	static unsigned short toUShort(double v){
+		if (v > 65535) return 65535;
+		if (v < 0) return 0;
+		return (unsigned short)floor(v + 0.5);
+	}
+	static unsigned char toPower(double v){
+		double q = v / KICK_POWER_STEP;
+		if (q > 255) return 255;
+		if (q < 0) return 0;
+		return (unsigned char)floor(q + 0.5);
+	}
+
+	void quantize(const PlayerTask& task){
+		flag = toShort(task.flag);
+		role = (unsigned char)task.role;
+		pos_x = toShort(task.target_pos.x);
+		pos_y = toShort(task.target_pos.y);
+		orientate = toShort(task.orientate * 1000);
+		vel_x = toShort(task.global_vel.x);
+		vel_y = toShort(task.global_vel.y);
+		rot_vel = toShort(task.rot_vel * 1000);
+		rot_dir = (signed char)(task.rot_dir > 0 ? 1 : (task.rot_dir < 0 ? -1 : 0));
+		max_acc = toUShort(task.maxAcceleration);
+		max_dec = toUShort(task.maxDeceleration);
+		kick_bits = (task.needKick ? 1 : 0) | (task.isPass ? 2 : 0) | (task.needCb ? 4 : 0) | (task.isChipKick ? 8 : 0);
+		kick_precision = toUShort(task.kickPrecision * 1000);
+		kick_power = toPower(task.kickPower);
+		chip_power = toPower(task.chipKickPower);
+	}
+
+	void dequantize(PlayerTask& task) const{
+		task.flag = flag;
+		task.role = (RobotRole)role;
+		task.target_pos = point2f(pos_x, pos_y);
+		task.orientate = orientate / 1000.0;
+		task.global_vel = point2f(vel_x, vel_y);
+		task.rot_vel = rot_vel / 1000.0;
+		task.rot_dir = rot_dir;
+		task.maxAcceleration = max_acc;
+		task.maxDeceleration = max_dec;
+		task.needKick = (kick_bits & 1) != 0;
+		task.isPass = (kick_bits & 2) != 0;
+		task.needCb = (kick_bits & 4) != 0;
+		task.isChipKick = (kick_bits & 8) != 0;
+		task.kickPrecision = kick_precision / 1000.0;
+		task.kickPower = kick_power * KICK_POWER_STEP;
+		task.chipKickPower = chip_power * KICK_POWER_STEP;
+	}
+
+	//与另一帧比较，返回变化字段的掩码
+	unsigned int diff(const QuantizedTask& o) const{
+		unsigned int mask = 0;
+		if (flag != o.flag) mask |= TF_FLAG;
+		if (role != o.role) mask |= TF_ROLE;
+		if (pos_x != o.pos_x || pos_y != o.pos_y) mask |= TF_TARGET_POS;
+		if (orientate != o.orientate) mask |= TF_ORIENTATE;
+		if (vel_x != o.vel_x || vel_y != o.vel_y) mask |= TF_GLOBAL_VEL;
+		if (rot_vel != o.rot_vel) mask |= TF_ROT_VEL;
+		if (rot_dir != o.rot_dir) mask |= TF_ROT_DIR;
+		if (max_acc != o.max_acc) mask |= TF_MAX_ACC;
+		if (max_dec != o.max_dec) mask |= TF_MAX_DEC;
+		if (kick_bits != o.kick_bits) mask |= TF_KICK_BITS;
+		if (kick_precision != o.kick_precision) mask |= TF_KICK_PRECISION;
+		if (kick_power != o.kick_power) mask |= TF_KICK_POWER;
+		if (chip_power != o.chip_power) mask |= TF_CHIP_POWER;
+		return mask;
+	}
+};
+
+//小端字节写入，越界时置错误标志而不写出
+class PacketWriter{
+public:
+	PacketWriter(unsigned char* buf, int cap) :data(buf), capacity(cap), size(0), overflow(false){}
+	void u8(unsigned int v){
+		if (size + 1 > capacity){ overflow = true; return; }
+		data[size++] = (unsigned char)v;
+	}
+	void u16(unsigned int v){
+		if (size + 2 > capacity){ overflow = true; return; }
+		data[size++] = (unsigned char)(v & 0xFF);
+		data[size++] = (unsigned char)((v >> 8) & 0xFF);
+	}
+	void s16(int v){ u16((unsigned int)(v & 0xFFFF)); }
+	unsigned char* data;
+	int capacity;
+	int size;
+	bool overflow;
+};
+
+//小端字节读取，越界时置错误标志并返回0
+class PacketReader{
+public:
+	PacketReader(const unsigned char* buf, int len) :data(buf), length(len), pos(0), overflow(false){}
+	unsigned int u8(){
+		if (pos + 1 > length){ overflow = true; return 0; }
+		return data[pos++];
+	}
+	unsigned int u16(){
+		if (pos + 2 > length){ overflow = true; return 0; }
+		unsigned int v = data[pos] | (data[pos + 1] << 8);
+		pos += 2;
+		return v;
+	}
+	short s16(){ return (short)u16(); }
+	const unsigned char* data;
+	int length;
+	int pos;
+	bool overflow;
+};
+
+//编码端：每帧把整队任务编码成一个数据包
+class TaskPacketEncoder{
+public:
+	TaskPacketEncoder(int keyframe_interval = 60) :interval(keyframe_interval), sequence(0), frames_since_key(0), force_key(true){}
+
+	//下一帧强制发送全量关键帧（例如接收端重启）
+	void forceKeyframe(){ force_key = true; }
+
+	//tasks与active按车号索引，长度为count；返回数据包长度，缓冲区不足返回-1
+	int encode(const PlayerTask* tasks, const bool* active, int count, unsigned char* out, int capacity){
+		if (count > MAX_ROBOTS) count = MAX_ROBOTS;
+		bool keyframe = force_key || frames_since_key >= interval;
+
+		PacketWriter w(out, capacity);
+		w.u8(TASK_PACKET_MAGIC);
+		w.u8(keyframe ? TASK_PACKET_KEYFRAME : 0);
+		w.u16(sequence);
+		int count_pos = w.size;
+		w.u8(0);
+
+		int robots = 0;
+		for (int id = 0; id < count; id++){
+			if (!active[id]) continue;
+			QuantizedTask q;
+			q.quantize(tasks[id]);
+			unsigned int mask = keyframe ? static_cast<unsigned int>(TF_ALL) : q.diff(last[id]);
+			if (mask == 0) continue;
+			writeRecord(w, id, q, mask);
+			last[id] = q;
+			robots++;
+		}
+		if (w.overflow){
+			//差分基准已被部分更新，下一帧改发关键帧
+			force_key = true;
+			return -1;
+		}
+		out[count_pos] = (unsigned char)robots;
+
+		sequence = (sequence + 1) & 0xFFFF;
+		if (keyframe){
+			frames_since_key = 0;
+			force_key = false;
+		}
+		else{
+			frames_since_key++;
+		}
+		return w.size;
+	}
+
+private:
+	static void writeRecord(PacketWriter& w, int id, const QuantizedTask& q, unsigned int mask){
+		w.u8(id);
+		w.u16(mask);
+		if (mask & TF_FLAG) w.s16(q.flag);
+		if (mask & TF_ROLE) w.u8(q.role);
+		if (mask & TF_TARGET_POS){ w.s16(q.pos_x); w.s16(q.pos_y); }
+		if (mask & TF_ORIENTATE) w.s16(q.orientate);
+		if (mask & TF_GLOBAL_VEL){ w.s16(q.vel_x); w.s16(q.vel_y); }
+		if (mask & TF_ROT_VEL) w.s16(q.rot_vel);
+		if (mask & TF_ROT_DIR) w.u8((unsigned char)q.rot_dir);
+		if (mask & TF_MAX_ACC) w.u16(q.max_acc);
+		if (mask & TF_MAX_DEC) w.u16(q.max_dec);
+		if (mask & TF_KICK_BITS) w.u8(q.kick_bits);
+		if (mask & TF_KICK_PRECISION) w.u16(q.kick_precision);
+		if (mask & TF_KICK_POWER) w.u8(q.kick_power);
+		if (mask & TF_CHIP_POWER) w.u8(q.chip_power);
+	}
+
+	int interval;
+	unsigned int sequence;
+	int frames_since_key;
+	bool force_key;
+	QuantizedTask last[MAX_ROBOTS];
+};
+
+//解码端：按上一帧状态叠加差分，检测丢包
+class TaskPacketDecoder{
+public:
+	TaskPacketDecoder() :expected(0), has_sequence(false), synced(false), lost(0), stale(0){}
+
+	//解码一个数据包，tasks按车号索引（长度MAX_ROBOTS），updated标记本包涉及的车号；
+	//格式错误、截断或重复/乱序到达的旧包返回false，此时解码状态和输出都不变
+	bool decode(const unsigned char* data, int length, PlayerTask* tasks, bool* updated){
+		PacketReader r(data, length);
+		if (r.u8() != TASK_PACKET_MAGIC) return false;
+		unsigned int flags = r.u8();
+		unsigned int seq = r.u16();
+		unsigned int robots = r.u8();
+		if (r.overflow) return false;
+
+		//与期望序号的有符号差：小于0为重复或乱序的旧包，大于0为中间丢了包
+		short delta = (short)((seq - expected) & 0xFFFF);
+		if (has_sequence && delta < 0){
+			stale++;
+			return false;
+		}
+
+		//先解码到临时状态，整包完整才提交，截断的包不会留下一半更新的差分基准
+		QuantizedTask next[MAX_ROBOTS];
+		bool touched[MAX_ROBOTS];
+		memcpy(next, state, sizeof(state));
+		for (int i = 0; i < MAX_ROBOTS; i++) touched[i] = false;
+		for (unsigned int i = 0; i < robots; i++){
+			unsigned int id = r.u8();
+			unsigned int mask = r.u16();
+			if (r.overflow || id >= (unsigned int)MAX_ROBOTS) return false;
+			readRecord(r, next[id], mask);
+			if (r.overflow) return false;
+			touched[id] = true;
+		}
+
+		bool keyframe = (flags & TASK_PACKET_KEYFRAME) != 0;
+		if (has_sequence && delta > 0){
+			//丢包：差分基准已不可靠，直到下一个关键帧
+			lost += delta;
+			synced = false;
+		}
+		if (keyframe) synced = true;
+		expected = (seq + 1) & 0xFFFF;
+		has_sequence = true;
+
+		memcpy(state, next, sizeof(state));
+		for (int i = 0; i < MAX_ROBOTS; i++){
+			updated[i] = touched[i];
+			if (touched[i]) state[i].dequantize(tasks[i]);
+		}
+		return true;
+	}
+
+	//自上一个关键帧以来没有丢包
+	bool isSynced() const{ return synced; }
+	//累计丢失的数据包数
+	unsigned int lostPackets() const{ return lost; }
+	//丢弃的重复或乱序数据包数
+	unsigned int stalePackets() const{ return stale; }
+
+private:
+	static void readRecord(PacketReader& r, QuantizedTask& q, unsigned int mask){
+		if (mask & TF_FLAG) q.flag = r.s16();
+		if (mask & TF_ROLE) q.role = (unsigned char)r.u8();
+		if (mask & TF_TARGET_POS){ q.pos_x = r.s16(); q.pos_y = r.s16(); }
+		if (mask & TF_ORIENTATE) q.orientate = r.s16();
+		if (mask & TF_GLOBAL_VEL){ q.vel_x = r.s16(); q.vel_y = r.s16(); }
+		if (mask & TF_ROT_VEL) q.rot_vel = r.s16();
+		if (mask & TF_ROT_DIR) q.rot_dir = (signed char)r.u8();
+		if (mask & TF_MAX_ACC) q.max_acc = (unsigned short)r.u16();
+		if (mask & TF_MAX_DEC) q.max_dec = (unsigned short)r.u16();
+		if (mask & TF_KICK_BITS) q.kick_bits = (unsigned char)r.u8();
+		if (mask & TF_KICK_PRECISION) q.kick_precision = (unsigned short)r.u16();
+		if (mask & TF_KICK_POWER) q.kick_power = (unsigned char)r.u8();
+		if (mask & TF_CHIP_POWER) q.chip_power = (unsigned char)r.u8();
+	}
+
+	unsigned int expected;
+	bool has_sequence;
+	bool synced;
+	unsigned int lost;
+	unsigned int stale;
+	QuantizedTask state[MAX_ROBOTS];
+};
+#endif
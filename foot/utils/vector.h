@@ -49,11 +49,11 @@ class vector2d{
 public:
   num x,y;
 
-  vector2d()
-  { x = 0; y = 0;}
+  constexpr vector2d()
+    : x(0), y(0) {}
 
-  vector2d(num nx,num ny)
-   {x=nx; y=ny;}
+  constexpr vector2d(num nx,num ny)
+    : x(nx), y(ny) {}
 
   vector2d<num> get_vector2d()
   { return vector2d<num>(x,y); }
@@ -694,5 +694,197 @@ inline void vftofarray(vector2f &a, float *array)
 	array[0] = a.x;
 	array[1] = a.y;
 }
+
+//==== Packed vector types ====//
+
+/*打包的二维向量：一条指令同时处理4个点
+1：vfloat4是4路float，vmask4是4路比较结果；有SSE2时用__m128实现，否则退化为逐通道循环，接口不变
+2：vector2f4把4个点的x、y分别放在两个vfloat4里（结构数组），运算与vector2d一致：
+   + - * / length sqlength dot cross norm perp，maths.h中的dot(u,v)、perp(u,v)宏也能直接使用
+3：select(mask,a,b)按通道选择，用来代替逐点的if
+4：load/store在point2f数组和vector2f4之间转换，load_n/store_n处理不足4个点的尾部*/
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VECTOR_PACKED_SSE2
+#include <emmintrin.h>
+#endif
+
+static_assert(sizeof(point2f) == 2 * sizeof(float), "point2f must be two packed floats");
+
+struct vmask4{
+#ifdef VECTOR_PACKED_SSE2
+  __m128 v;
+  vmask4() : v(_mm_setzero_ps()) {}
+  explicit vmask4(__m128 m) : v(m) {}
+  //每个通道一位，通道0为最低位
+  int bits() const { return _mm_movemask_ps(v); }
+  vmask4 operator&(vmask4 o) const { return vmask4(_mm_and_ps(v, o.v)); }
+  vmask4 operator|(vmask4 o) const { return vmask4(_mm_or_ps(v, o.v)); }
+  vmask4 operator^(vmask4 o) const { return vmask4(_mm_xor_ps(v, o.v)); }
+  vmask4 operator~() const { return vmask4(_mm_xor_ps(v, _mm_castsi128_ps(_mm_set1_epi32(-1)))); }
+#else
+  bool v[4];
+  vmask4() { v[0] = v[1] = v[2] = v[3] = false; }
+  int bits() const { return int(v[0]) | (int(v[1]) << 1) | (int(v[2]) << 2) | (int(v[3]) << 3); }
+  vmask4 operator&(vmask4 o) const { vmask4 r; for(int i=0; i<4; i++) r.v[i] = v[i] && o.v[i]; return r; }
+  vmask4 operator|(vmask4 o) const { vmask4 r; for(int i=0; i<4; i++) r.v[i] = v[i] || o.v[i]; return r; }
+  vmask4 operator^(vmask4 o) const { vmask4 r; for(int i=0; i<4; i++) r.v[i] = v[i] != o.v[i]; return r; }
+  vmask4 operator~() const { vmask4 r; for(int i=0; i<4; i++) r.v[i] = !v[i]; return r; }
+#endif
+  bool any() const { return bits() != 0; }
+  bool all() const { return bits() == 0xF; }
+  bool lane(int i) const { return ((bits() >> i) & 1) != 0; }
+};
+
+struct vfloat4{
+#ifdef VECTOR_PACKED_SSE2
+  __m128 v;
+  vfloat4() : v(_mm_setzero_ps()) {}
+  explicit vfloat4(__m128 m) : v(m) {}
+  vfloat4(float f) : v(_mm_set1_ps(f)) {}
+  vfloat4(float a,float b,float c,float d) : v(_mm_setr_ps(a, b, c, d)) {}
+
+  static vfloat4 load(const float *p) { return vfloat4(_mm_loadu_ps(p)); }
+  void store(float *p) const { _mm_storeu_ps(p, v); }
+
+  vfloat4 operator+(vfloat4 o) const { return vfloat4(_mm_add_ps(v, o.v)); }
+  vfloat4 operator-(vfloat4 o) const { return vfloat4(_mm_sub_ps(v, o.v)); }
+  vfloat4 operator*(vfloat4 o) const { return vfloat4(_mm_mul_ps(v, o.v)); }
+  vfloat4 operator/(vfloat4 o) const { return vfloat4(_mm_div_ps(v, o.v)); }
+  vfloat4 operator-() const { return vfloat4(_mm_sub_ps(_mm_setzero_ps(), v)); }
+
+  vmask4 operator< (vfloat4 o) const { return vmask4(_mm_cmplt_ps(v, o.v)); }
+  vmask4 operator> (vfloat4 o) const { return vmask4(_mm_cmpgt_ps(v, o.v)); }
+  vmask4 operator<=(vfloat4 o) const { return vmask4(_mm_cmple_ps(v, o.v)); }
+  vmask4 operator>=(vfloat4 o) const { return vmask4(_mm_cmpge_ps(v, o.v)); }
+#else
+  float v[4];
+  vfloat4() { v[0] = v[1] = v[2] = v[3] = 0; }
+  vfloat4(float f) { v[0] = v[1] = v[2] = v[3] = f; }
+  vfloat4(float a,float b,float c,float d) { v[0] = a; v[1] = b; v[2] = c; v[3] = d; }
+
+  static vfloat4 load(const float *p) { return vfloat4(p[0], p[1], p[2], p[3]); }
+  void store(float *p) const { for(int i=0; i<4; i++) p[i] = v[i]; }
+
+  vfloat4 operator+(vfloat4 o) const { vfloat4 r; for(int i=0; i<4; i++) r.v[i] = v[i] + o.v[i]; return r; }
+  vfloat4 operator-(vfloat4 o) const { vfloat4 r; for(int i=0; i<4; i++) r.v[i] = v[i] - o.v[i]; return r; }
+  vfloat4 operator*(vfloat4 o) const { vfloat4 r; for(int i=0; i<4; i++) r.v[i] = v[i] * o.v[i]; return r; }
+  vfloat4 operator/(vfloat4 o) const { vfloat4 r; for(int i=0; i<4; i++) r.v[i] = v[i] / o.v[i]; return r; }
+  vfloat4 operator-() const { vfloat4 r; for(int i=0; i<4; i++) r.v[i] = -v[i]; return r; }
+
+  vmask4 operator< (vfloat4 o) const { vmask4 r; for(int i=0; i<4; i++) r.v[i] = v[i] <  o.v[i]; return r; }
+  vmask4 operator> (vfloat4 o) const { vmask4 r; for(int i=0; i<4; i++) r.v[i] = v[i] >  o.v[i]; return r; }
+  vmask4 operator<=(vfloat4 o) const { vmask4 r; for(int i=0; i<4; i++) r.v[i] = v[i] <= o.v[i]; return r; }
+  vmask4 operator>=(vfloat4 o) const { vmask4 r; for(int i=0; i<4; i++) r.v[i] = v[i] >= o.v[i]; return r; }
+#endif
+  vfloat4 &operator+=(vfloat4 o) { return(*this = *this + o); }
+  vfloat4 &operator-=(vfloat4 o) { return(*this = *this - o); }
+  vfloat4 &operator*=(vfloat4 o) { return(*this = *this * o); }
+  vfloat4 &operator/=(vfloat4 o) { return(*this = *this / o); }
+
+  float lane(int i) const { float t[4]; store(t); return t[i]; }
+};
+
+inline vfloat4 operator+(float f, vfloat4 a) { return vfloat4(f) + a; }
+inline vfloat4 operator-(float f, vfloat4 a) { return vfloat4(f) - a; }
+inline vfloat4 operator*(float f, vfloat4 a) { return vfloat4(f) * a; }
+
+#ifdef VECTOR_PACKED_SSE2
+inline vfloat4 vsqrt(vfloat4 a) { return vfloat4(_mm_sqrt_ps(a.v)); }
+inline vfloat4 vmin(vfloat4 a,vfloat4 b) { return vfloat4(_mm_min_ps(a.v, b.v)); }
+inline vfloat4 vmax(vfloat4 a,vfloat4 b) { return vfloat4(_mm_max_ps(a.v, b.v)); }
+inline vfloat4 vabs(vfloat4 a) { return vfloat4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)); }
+//mask为真的通道取a，否则取b
+inline vfloat4 select(vmask4 m,vfloat4 a,vfloat4 b) { return vfloat4(_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))); }
+#else
+inline vfloat4 vsqrt(vfloat4 a) { for(int i=0; i<4; i++) a.v[i] = std::sqrt(a.v[i]); return a; }
+inline vfloat4 vmin(vfloat4 a,vfloat4 b) { for(int i=0; i<4; i++) a.v[i] = (b.v[i] < a.v[i])? b.v[i] : a.v[i]; return a; }
+inline vfloat4 vmax(vfloat4 a,vfloat4 b) { for(int i=0; i<4; i++) a.v[i] = (b.v[i] > a.v[i])? b.v[i] : a.v[i]; return a; }
+inline vfloat4 vabs(vfloat4 a) { for(int i=0; i<4; i++) a.v[i] = std::fabs(a.v[i]); return a; }
+inline vfloat4 select(vmask4 m,vfloat4 a,vfloat4 b) { for(int i=0; i<4; i++) a.v[i] = m.v[i]? a.v[i] : b.v[i]; return a; }
+#endif
+
+struct vector2f4{
+  vfloat4 x,y;
+
+  vector2f4() {}
+  vector2f4(vfloat4 nx,vfloat4 ny) : x(nx), y(ny) {}
+  //4个通道都为同一个点
+  explicit vector2f4(const point2f &p) : x(p.x), y(p.y) {}
+
+  //从point2f数组读取4个点
+  static vector2f4 load(const point2f *p)
+  {
+#ifdef VECTOR_PACKED_SSE2
+    __m128 a = _mm_loadu_ps(&p[0].x);   // x0 y0 x1 y1
+    __m128 b = _mm_loadu_ps(&p[2].x);   // x2 y2 x3 y3
+    return vector2f4(vfloat4(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0))),
+                     vfloat4(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1))));
+#else
+    return vector2f4(vfloat4(p[0].x, p[1].x, p[2].x, p[3].x),
+                     vfloat4(p[0].y, p[1].y, p[2].y, p[3].y));
+#endif
+  }
+  //读取n(<=4)个点，其余通道填fill
+  static vector2f4 load_n(const point2f *p,int n,point2f fill = point2f(0,0))
+  {
+    point2f t[4] = {fill, fill, fill, fill};
+    for(int i=0; i<n && i<4; i++) t[i] = p[i];
+    return load(t);
+  }
+  //写回4个点到point2f数组
+  void store(point2f *p) const
+  {
+#ifdef VECTOR_PACKED_SSE2
+    _mm_storeu_ps(&p[0].x, _mm_unpacklo_ps(x.v, y.v));
+    _mm_storeu_ps(&p[2].x, _mm_unpackhi_ps(x.v, y.v));
+#else
+    for(int i=0; i<4; i++) p[i].set(x.v[i], y.v[i]);
+#endif
+  }
+  //只写回前n(<=4)个点
+  void store_n(point2f *p,int n) const
+  {
+    point2f t[4];
+    store(t);
+    for(int i=0; i<n && i<4; i++) p[i] = t[i];
+  }
+
+  point2f lane(int i) const { return point2f(x.lane(i), y.lane(i)); }
+
+  vfloat4 sqlength() const { return x*x + y*y; }
+  vfloat4 length() const { return vsqrt(sqlength()); }
+  vfloat4 dot(const vector2f4 &p) const { return x*p.x + y*p.y; }
+  vfloat4 cross(const vector2f4 &p) const { return x*p.y - y*p.x; }
+  //单位向量，长度为0的通道返回0向量
+  vector2f4 norm() const
+  {
+    vfloat4 l = length();
+    vmask4 ok = l > vfloat4(0.0f);
+    vfloat4 inv = select(ok, vfloat4(1.0f) / select(ok, l, vfloat4(1.0f)), vfloat4(0.0f));
+    return vector2f4(x*inv, y*inv);
+  }
+  void normalize() { *this = norm(); }
+  vector2f4 perp() const { return vector2f4(-y, x); }
+
+  vector2f4 operator+(const vector2f4 &p) const { return vector2f4(x + p.x, y + p.y); }
+  vector2f4 operator-(const vector2f4 &p) const { return vector2f4(x - p.x, y - p.y); }
+  vector2f4 operator*(vfloat4 f) const { return vector2f4(x * f, y * f); }
+  vector2f4 operator/(vfloat4 f) const { return vector2f4(x / f, y / f); }
+  vector2f4 operator-() const { return vector2f4(-x, -y); }
+  vector2f4 &operator+=(const vector2f4 &p) { x += p.x; y += p.y; return(*this); }
+  vector2f4 &operator-=(const vector2f4 &p) { x -= p.x; y -= p.y; return(*this); }
+  vector2f4 &operator*=(vfloat4 f) { x *= f; y *= f; return(*this); }
+};
+
+inline vector2f4 select(vmask4 m,const vector2f4 &a,const vector2f4 &b)
+{
+  return vector2f4(select(m, a.x, b.x), select(m, a.y, b.y));
+}
+
+inline vfloat4 distance(const vector2f4 &a,const vector2f4 &b)
+{
+  return (a - b).length();
+}
 #endif
 // __VECTOR_H__
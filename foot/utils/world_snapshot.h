@@ -0,0 +1,90 @@
+﻿#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+#include <cstring>
+#include "constants.h"
+#include "PlayerTask.h"
+#include "worldmodel.h"
+
+/*后台规划使用的世界快照
+1：只有定长数组和数值，没有指针，可以按值交给后台线程，不再引用宿主的WorldModel
+2：机器人数组按车号索引，exist为0的项无意义；单位与WorldModel一致（cm、cm/s、rad）
+3：由帧级作业用fill_world_snapshot填写，不属于DLL的导出接口*/
+
+struct RobotSnapshot{
+	int exist;					//是否在场
+	float x, y;					//位置
+	float vx, vy;				//速度
+	float dir;					//朝向
+};
+
+struct WorldSnapshot{
+	int cycle;					//视觉周期，与WorldModel::get_cycle相同
+	int play_mode;				//PlayMode
+	unsigned int mode_events;	//PlayModeEvent位掩码
+	float ball_x, ball_y;
+	float ball_vx, ball_vy;
+	int our_goalie;
+	int opp_goalie;
+	RobotSnapshot our[MAX_TEAM_ROBOTS];
+	RobotSnapshot opp[MAX_TEAM_ROBOTS];
+};
+
+//由世界模型填写快照
+inline void fill_world_snapshot(const WorldModel* model, WorldSnapshot& s){
+	memset(&s, 0, sizeof(WorldSnapshot));
+	s.cycle = model->get_cycle();
+	s.play_mode = (int)model->get_play_mode();
+	s.mode_events = model->get_play_mode_events();
+	const point2f& ball = model->get_ball_pos();
+	const point2f& ball_v = model->get_ball_vel();
+	s.ball_x = ball.x; s.ball_y = ball.y;
+	s.ball_vx = ball_v.x; s.ball_vy = ball_v.y;
+	s.our_goalie = model->get_our_goalie();
+	s.opp_goalie = model->get_opp_goalie();
+	for (int i : model->get_our_set()){
+		const point2f& p = model->get_our_player_pos(i);
+		const point2f& v = model->get_our_player_v(i);
+		RobotSnapshot& r = s.our[i];
+		r.exist = 1;
+		r.x = p.x; r.y = p.y;
+		r.vx = v.x; r.vy = v.y;
+		r.dir = model->get_our_player_dir(i);
+	}
+	for (int i : model->get_opp_set()){
+		const point2f& p = model->get_opp_player_pos(i);
+		point2f v = model->get_opp_player(i).vel();
+		RobotSnapshot& r = s.opp[i];
+		r.exist = 1;
+		r.x = p.x; r.y = p.y;
+		r.vx = v.x; r.vy = v.y;
+		r.dir = model->get_opp_player_dir(i);
+	}
+}
+
+/*批量规划C接口（robot2.cpp导出）
+planner_create创建一个独立的规划器实例并绑定宿主的世界模型，之后所有规划都读取这个世界模型；
+team_plan每帧调用一次，为世界模型中除守门员外的全部我方机器人规划，tasks按车号索引写入（长度capacity），
+返回规划的机器人数；守门员仍由goalie_plan规划；宿主应在更新完世界模型之后调用；
+planner_set_workers设置帧级作业的工作线程数，默认0即串行执行，不能与team_plan并发调用；
+帧级作业的耗时几乎都在传球网络更新上，线程池最多省去其余作业的几微秒（见tests/frame_graph_bench.cpp），一般保持串行；
+句柄带一个后台接应点线程，宿主卸载DLL（FreeLibrary）之前必须用planner_destroy释放全部句柄，
+DLL卸载时持有加载器锁，不能在那时等待线程退出；
+player_plan使用的默认规划器不启动任何线程，只调用player_plan的旧宿主不需要调用新接口；
+planner_shutdown释放默认规划器的工具类和通信，之后再调用player_plan会重新初始化*/
+typedef struct PlannerHandleImpl* PlannerHandle;
+
+extern "C" {
+	PlannerHandle planner_create(const WorldModel* model);
+	void planner_destroy(PlannerHandle planner);
+	int planner_set_workers(PlannerHandle planner, int workers);
+	int team_plan(PlannerHandle planner, PlayerTask* tasks, int capacity);
+	void planner_shutdown();
+}
+
+//宿主用GetProcAddress取函数地址时的类型
+typedef PlannerHandle (*planner_create_fn)(const WorldModel* model);
+typedef void (*planner_destroy_fn)(PlannerHandle planner);
+typedef int (*planner_set_workers_fn)(PlannerHandle planner, int workers);
+typedef int (*team_plan_fn)(PlannerHandle planner, PlayerTask* tasks, int capacity);
+typedef void (*planner_shutdown_fn)();
+#endif
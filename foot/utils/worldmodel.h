@@ -8,6 +8,7 @@
 #include "matchstate.h"
 #include "ball.h"
 #include "game_state.h"
+#include "robot_set.h"
 class WorldModel
 {
 public:
@@ -15,17 +16,26 @@ public:
 	~WorldModel();   //string是一个类
 	const std::string& get_referee_msg() const;  //获取裁判发送的消息.表示这个函数返回一个string对象的引用
 	void set_referee_msg(const std::string& ref_msg);  //用于设置裁判发送的消息，函数接受一个对 std::string 类型的常量引用作为参数
-	void set_cycle(int cycle){ current_cycle = cycle; }   //设置当前的周期。current_cycle类的私有成员变量
+	void set_cycle(int cycle){ current_cycle = cycle; update_sets(); }   //设置当前的周期。current_cycle类的私有成员变量，同时由存在标识数组重新生成机器人集合
+	int get_cycle()const{ return current_cycle; }   //获取当前的周期，用于判断是否进入新的一帧
 	void setMatchState(FieldState state);//设置比赛状态为枚举变量FieldState state
 	FieldState getMatchState();    //返回当前的比赛状态，即返回FieldState里的变量
 	void set_our_team(Vehicle* team){ our = team; }  //设置我们队伍的车辆指针为 team 。接受一个指向Vehicle类型的指针team作为参数，并将our（类的私有成员变量）设置为这个传入的指针
 	const Vehicle* get_our_team()const{ return our; }  //返回our指针的一个常量引用。即返回指向我们队伍车辆的常量指针
 	void set_opp_team(Vehicle* team){ opp = team; }    //设置对手队伍的车辆指针为 team
 	const Vehicle* get_opp_team()const{ return opp; }  //返回指向对手队伍车辆的常量指针
-	void set_our_exist_id(bool * id){ our_robots_id = id; }   //设置一个布尔指针，用于表示我们队伍中每个机器人是否存在的状态。
+	void set_our_exist_id(bool * id){ our_robots_id = id; update_sets(); }   //设置一个布尔指针，用于表示我们队伍中每个机器人是否存在的状态。
 	const bool* get_our_exist_id()const{ return our_robots_id; }  //返回一个常量布尔指针，表示我们队伍中每个机器人是否存在的状态
-	void set_opp_exist_id(bool * id){ opp_robots_id = id; }   //设置对手机器人是否存在的标识数组。opp_robots_id 是一个指向布尔值的指针，表示每个对手机器人是否存在于当前比赛中。
+	void set_opp_exist_id(bool * id){ opp_robots_id = id; update_sets(); }   //设置对手机器人是否存在的标识数组。opp_robots_id 是一个指向布尔值的指针，表示每个对手机器人是否存在于当前比赛中。
 	const bool* get_opp_exist_id()const{ return opp_robots_id; } //获取对手机器人是否存在的标识数组。返回指向布尔值的常量指针
+	void update_sets(){   //由存在标识数组生成机器人集合。原地改写存在标识数组后、本周期任何规划开始前须调用一次（set_cycle已调用）。宿主数组只有HOST_EXIST_LEN长，集合中的车号因此都可以用来读宿主数据
+		our_set = RobotSet::from_flags(our_robots_id, HOST_EXIST_LEN);
+		opp_set = RobotSet::from_flags(opp_robots_id, HOST_EXIST_LEN);
+	}
+	RobotSet get_our_set()const{ return our_set; }   //场上我方机器人集合，只读，可在多个线程中同时调用
+	RobotSet get_opp_set()const{ return opp_set; }   //场上对手机器人集合
+	RobotSet get_our_field_set()const{ return get_our_set() - RobotSet::single(our_goalie); }   //场上我方除守门员外的机器人集合
+	RobotSet get_opp_field_set()const{ return get_opp_set() - RobotSet::single(opp_goalie); }   //场上对手除守门员外的机器人集合
 	void set_our_v(int id, point2f v);   //设置我们队伍中指定ID的机器人的速度。point2f 一个表示二维坐标或向量的类型。
 	void set_our_rot(int id, float rot);   //设置我们队伍中指定ID的机器人的旋转角度或方向
 	void set_our_cmd(int id, const point2f& v, const float& rot);   //设置我们队伍中指定ID的机器人的速度和旋转命令
@@ -57,17 +67,19 @@ public:
 	bool is_sim_kick(int id)const;     //判断指定ID的机器人是否处于模拟踢球状态。
 	void set_game_state(GameState* state);  // 设置游戏状态。参数是GameState类对象的指针，包含了当前游戏的各种状态信息。
 	const GameState* game_states()const;   // 获取游戏状态。返回指向GameState类型的常量指针，因此不能修改返回的游戏状态对象。
+	PlayMode get_play_mode()const{ return game_state ? game_state->playMode() : PlayMode::Normal; }   //获取本帧解码好的比赛模式，所有机器人共用同一份解码结果
+	unsigned int get_play_mode_events()const{ return game_state ? game_state->modeEvents() : MODE_EVENT_NONE; }   //获取比赛模式的边沿事件（PlayModeEvent位掩码）
 	void set_simulation(bool sim){ is_simulation = sim; } //设置是否为模拟状态。sim是一个布尔值，表示当前是否处于模拟环境中。
 	bool get_simulation()const{ return is_simulation; }//获取当前是否为模拟状态。返回一个布尔值，表示是否处于模拟环境中。
 private:
-	static const int max_robots = 12;
+	static const int max_robots = MAX_ROBOTS;
 	Vehicle* our;  //一个指向 Vehicle 的指针，代表我们的队伍
 	Vehicle* opp; //一个指向 Vehicle 的指针，代表对手的队伍
 	bool* kick;   //一个布尔指针，是否踢球
 	bool* sim_kick;
 	Ball* match_ball;  //一个指向Ball对象的指针
-	bool* our_robots_id;  //一个布尔指针，可能用于表示我们队伍中每个机器人是否存在的状态
-	bool* opp_robots_id;
+	bool* our_robots_id = nullptr;  //一个布尔指针，可能用于表示我们队伍中每个机器人是否存在的状态
+	bool* opp_robots_id = nullptr;
 	int our_goalie;  //守门员ID
 	int opp_goalie;
 	int current_cycle;    //表示当前的周期
@@ -75,5 +87,7 @@ private:
 	FieldState match_state;   //定义一个枚举变量
 	GameState* game_state;   //一个指向GameState对象的指针
 	bool is_simulation;  //是否处于模拟模式
+	RobotSet our_set;   //本周期的我方机器人集合
+	RobotSet opp_set;   //本周期的对手机器人集合
 };
 #endif